@@ -0,0 +1,196 @@
+// Spectrum codec benchmark
+// Encodes sequences of synthetic uint8 waterfall rows (noise floor plus fixed, drifting and
+// bursty carriers, on the same dB scale as compute_magnitude_db) with every spectrum codec
+// and with gzip_compress of the plain row, the previous way of compressing rows. Reports
+// the compression ratio and encode/decode time per row set, checks that every codec decodes
+// its own output exactly and that delta-rans beats gzip_compress on ratio for averaged
+// spectra. Encode speedups over gzip_compress are reported but not checked, since wall-clock
+// timings vary with the host.
+// Exits non-zero if a check fails.
+//
+// Usage: codec_benchmark [rows]
+
+#include "spectrum_codec.h"
+#include "compression.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t FFT_SIZE = 4096;
+constexpr size_t CHANNELS = 2;
+constexpr uint32_t KEYFRAME_INTERVAL = 64;  // As StreamConfig::KEYFRAME_INTERVAL
+constexpr float NOISE_FLOOR_DB = -80.0f;
+
+int g_failures = 0;
+
+void check(bool ok, const char* what, double value, double bound) {
+    std::printf("  %-44s %10.4f  (bound %.4f)  %s\n", what, value, bound, ok ? "ok" : "FAIL");
+    if (!ok) g_failures++;
+}
+
+// dB to the 0-255 display scale of compute_magnitude_db
+uint8_t to_display(float db) {
+    const float normalized = (db + 100.0f) * (255.0f / 120.0f);
+    return static_cast<uint8_t>(std::clamp(normalized, 0.0f, 255.0f));
+}
+
+// Row sets (CHANNELS rows of `width` bins) of a slowly changing scene
+// Args:
+//   looks: Power spectra averaged per row (1 = single FFT, noisiest)
+//   pool: Max-pool factor (4 = a 1024-bin display view)
+std::vector<std::vector<uint8_t>> make_rows(std::mt19937& rng, size_t rows, int looks, size_t pool) {
+    std::exponential_distribution<float> periodogram(1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    const size_t width = FFT_SIZE / pool;
+
+    std::vector<std::vector<uint8_t>> out(rows, std::vector<uint8_t>(CHANNELS * width));
+    std::vector<float> mean_power(FFT_SIZE);
+    std::vector<uint8_t> full(FFT_SIZE);
+    bool burst = false;
+    for (size_t r = 0; r < rows; r++) {
+        // Scene: floor, three fixed carriers, one drifting by a bin every 20 rows, one bursting
+        for (size_t k = 0; k < FFT_SIZE; k++) {
+            float db = NOISE_FLOOR_DB;
+            if (k >= 500 && k < 540) db = -40.0f;
+            if (k >= 1800 && k < 1804) db = -30.0f;
+            if (k >= 3000 && k < 3200) db = -55.0f;
+            const size_t drift = 2500 + r / 20;
+            if (k >= drift && k < drift + 8) db = -45.0f;
+            if (burst && k >= 1200 && k < 1300) db = -50.0f;
+            mean_power[k] = std::pow(10.0f, db / 10.0f);
+        }
+        if (uniform(rng) < 0.1f) burst = !burst;
+
+        for (size_t ch = 0; ch < CHANNELS; ch++) {
+            for (size_t k = 0; k < FFT_SIZE; k++) {
+                float power = 0.0f;
+                for (int l = 0; l < looks; l++) power += periodogram(rng);
+                full[k] = to_display(10.0f * std::log10(mean_power[k] * power / looks));
+            }
+            uint8_t* dst = out[r].data() + ch * width;
+            for (size_t i = 0; i < width; i++) {
+                dst[i] = *std::max_element(full.begin() + i * pool, full.begin() + (i + 1) * pool);
+            }
+        }
+    }
+    return out;
+}
+
+double elapsed_ns(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+struct CodecResult {
+    double ratio;
+    double encode_ns;
+    double decode_ns;
+};
+
+// Encode the sequence as a view would (keyframe every KEYFRAME_INTERVAL rows), then decode it
+CodecResult run_codec(const SpectrumCodec& codec, const std::vector<std::vector<uint8_t>>& rows) {
+    const size_t size = rows[0].size();
+    std::vector<std::vector<uint8_t>> encoded(rows.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t total = 0;
+    for (size_t r = 0; r < rows.size(); r++) {
+        const uint8_t* reference = (r % KEYFRAME_INTERVAL == 0) ? nullptr : rows[r - 1].data();
+        encoded[r].reserve(size + size / 8 + 64);
+        if (!codec.encode(rows[r].data(), reference, size, encoded[r])) g_failures++;
+        total += encoded[r].size();
+    }
+    const double encode_ns = elapsed_ns(start) / rows.size();
+
+    std::vector<uint8_t> previous(size), decoded(size);
+    size_t mismatches = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < rows.size(); r++) {
+        const uint8_t* reference = (r % KEYFRAME_INTERVAL == 0) ? nullptr : previous.data();
+        if (!codec.decode(encoded[r].data(), encoded[r].size(), reference, decoded.data(), size)) mismatches++;
+        std::swap(previous, decoded);
+    }
+    const double decode_ns = elapsed_ns(start) / rows.size();
+
+    // Verify outside the timed loop (row 0 is a keyframe, so the stale reference is unused)
+    for (size_t r = 0; r < rows.size(); r++) {
+        const uint8_t* reference = (r % KEYFRAME_INTERVAL == 0) ? nullptr : previous.data();
+        codec.decode(encoded[r].data(), encoded[r].size(), reference, decoded.data(), size);
+        if (decoded != rows[r]) mismatches++;
+        std::swap(previous, decoded);
+    }
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s round trip mismatches", codec.name);
+    check(mismatches == 0, label, static_cast<double>(mismatches), 0.0);
+
+    return {static_cast<double>(size) * rows.size() / total, encode_ns, decode_ns};
+}
+
+// The previous path: every row gzip-compressed on its own
+CodecResult run_gzip(const std::vector<std::vector<uint8_t>>& rows) {
+    const size_t size = rows[0].size();
+    std::vector<uint8_t> out;
+    size_t total = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& row : rows) {
+        total += gzip_compress(row.data(), size, out);
+    }
+    return {static_cast<double>(size) * rows.size() / total, elapsed_ns(start) / rows.size(), 0.0};
+}
+
+void run_scene(std::mt19937& rng, const char* name, size_t rows, int looks, size_t pool, bool gate) {
+    const auto sequence = make_rows(rng, rows, looks, pool);
+    std::printf("[Codec bench] %s: %zu rows x %zu bins x %zu channels\n",
+                name, rows, FFT_SIZE / pool, CHANNELS);
+
+    const CodecResult gzip = run_gzip(sequence);
+    const StreamEncoding encodings[] = {StreamEncoding::RAW, StreamEncoding::DELTA_DEFLATE,
+                                        StreamEncoding::DELTA_BITPACK, StreamEncoding::DELTA_RANS};
+    constexpr size_t CODECS = sizeof(encodings) / sizeof(encodings[0]);
+    CodecResult results[CODECS];
+    for (size_t i = 0; i < CODECS; i++) {
+        results[i] = run_codec(*find_spectrum_codec(encodings[i]), sequence);
+    }
+
+    std::printf("  %-16s %8s %14s %14s\n", "codec", "ratio", "encode ns/row", "decode ns/row");
+    std::printf("  %-16s %8.2f %14.0f %14s\n", "gzip_compress", gzip.ratio, gzip.encode_ns, "-");
+    for (size_t i = 0; i < CODECS; i++) {
+        std::printf("  %-16s %8.2f %14.0f %14.0f\n", find_spectrum_codec(encodings[i])->name,
+                    results[i].ratio, results[i].encode_ns, results[i].decode_ns);
+    }
+
+    if (gate) {
+        const CodecResult& bitpack = results[2];
+        const CodecResult& rans = results[3];
+        check(rans.ratio > gzip.ratio, "delta-rans ratio above gzip_compress", rans.ratio, gzip.ratio);
+        // Timings depend on the host and its load: reported, never checked
+        std::printf("  %-44s %10.2fx\n", "delta-rans encode speedup vs gzip_compress",
+                    gzip.encode_ns / rans.encode_ns);
+        std::printf("  %-44s %10.2fx\n", "delta-bitpack encode speedup vs gzip",
+                    gzip.encode_ns / bitpack.encode_ns);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int requested = (argc > 1) ? std::atoi(argv[1]) : 512;
+    const size_t rows = static_cast<size_t>(std::max(requested, static_cast<int>(KEYFRAME_INTERVAL)));
+    std::mt19937 rng(12345);  // Fixed seed: results are reproducible run to run
+
+    run_scene(rng, "Averaged (16 looks), full resolution", rows, 16, 1, true);
+    run_scene(rng, "Averaged (16 looks), 1024-bin max-pooled view", rows, 16, 4, true);
+    run_scene(rng, "Single look, full resolution", rows, 1, 1, false);
+
+    if (g_failures > 0) {
+        std::printf("[Codec bench] %d check(s) FAILED\n", g_failures);
+        return 1;
+    }
+    std::printf("[Codec bench] All checks passed\n");
+    return 0;
+}
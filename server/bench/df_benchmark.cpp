@@ -0,0 +1,359 @@
+// DF accuracy and latency regression benchmark
+// Drives synthetic two-channel spectra with known phase offsets and SNRs through the DF path
+// (CFAR, cross-spectrum, bearing estimate, Kalman track, calibration) and checks the bearing
+// errors against fixed bounds, then reports the time per call of each stage.
+// Exits non-zero if any bound is violated, so it can gate optimizations of the DF path.
+//
+// Usage: df_benchmark [iterations]
+
+#include "df_processing.h"
+#include "config.h"
+#include "array_calibration.h"
+#include "signal_processing.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t FFT_SIZE = 4096;
+constexpr uint64_t CENTER_FREQ = 915000000;
+constexpr uint32_t SAMPLE_RATE = 20000000;
+constexpr float NOISE_POWER = 1e-5f;       // Per-bin noise power (about 106 on the 0-255 scale)
+constexpr size_t SIGNAL_BINS = 40;         // Occupied bandwidth of the synthetic emitter
+constexpr size_t SIGNAL_CENTER = 1500;     // Away from DC and the band edges
+constexpr int TRIALS = 50;                 // Noise realizations per accuracy case
+
+// Accuracy bounds per SNR (degrees, RMS and worst case over azimuths up to 60 degrees)
+struct AccuracyBound {
+    float snr_db;
+    float max_rms_deg;
+    float max_error_deg;
+    float max_missed;          // Fraction of trials below DFConfig::MIN_CONFIDENCE_THRESHOLD
+};
+
+constexpr AccuracyBound ACCURACY_BOUNDS[] = {
+    {30.0f, 0.5f, 2.0f, 0.0f},
+    {20.0f, 1.0f, 4.0f, 0.02f},
+    {10.0f, 3.0f, 10.0f, 0.3f},
+};
+
+constexpr float TEST_AZIMUTHS_DEG[] = {-60.0f, -30.0f, -10.0f, 0.0f, 15.0f, 45.0f, 60.0f};
+
+int g_failures = 0;
+
+void check(bool ok, const char* what, double value, double bound) {
+    std::printf("  %-44s %10.4f  (bound %.4f)  %s\n", what, value, bound, ok ? "ok" : "FAIL");
+    if (!ok) g_failures++;
+}
+
+// Wrapped difference a - b in (-180, 180]
+float angle_error(float a, float b) {
+    float d = std::fmod(a - b, 360.0f);
+    if (d > 180.0f) d -= 360.0f;
+    if (d <= -180.0f) d += 360.0f;
+    return d;
+}
+
+// Azimuth as reported by the DF path: relative to boresight, [0, 360)
+float to_reported(float azimuth_deg) {
+    return azimuth_deg < 0.0f ? azimuth_deg + 360.0f : azimuth_deg;
+}
+
+// One synthetic frame: complex noise on both channels plus an emitter whose RX2 copy
+// leads RX1 by pi * sin(theta) (half-wavelength spacing) plus a hardware phase error
+struct SyntheticFrame {
+    std::vector<fftwf_complex> ch1;
+    std::vector<fftwf_complex> ch2;
+    std::vector<uint8_t> mag1;
+    std::vector<uint8_t> mag2;
+
+    SyntheticFrame() : ch1(FFT_SIZE), ch2(FFT_SIZE), mag1(FFT_SIZE), mag2(FFT_SIZE) {}
+
+    void generate(std::mt19937& rng, float azimuth_deg, float snr_db, float hw_error_deg) {
+        std::normal_distribution<float> noise(0.0f, std::sqrt(NOISE_POWER / 2.0f));
+        std::uniform_real_distribution<float> phase(0.0f, 2.0f * static_cast<float>(M_PI));
+
+        for (size_t k = 0; k < FFT_SIZE; k++) {
+            ch1[k][0] = noise(rng);
+            ch1[k][1] = noise(rng);
+            ch2[k][0] = noise(rng);
+            ch2[k][1] = noise(rng);
+        }
+
+        const float amplitude = std::sqrt(NOISE_POWER * std::pow(10.0f, snr_db / 10.0f));
+        const float delta = static_cast<float>(M_PI) * std::sin(azimuth_deg * static_cast<float>(M_PI) / 180.0f) +
+                            hw_error_deg * static_cast<float>(M_PI) / 180.0f;
+        for (size_t k = SIGNAL_CENTER - SIGNAL_BINS / 2; k < SIGNAL_CENTER + SIGNAL_BINS / 2; k++) {
+            const float p = phase(rng);
+            ch1[k][0] += amplitude * std::cos(p);
+            ch1[k][1] += amplitude * std::sin(p);
+            ch2[k][0] += amplitude * std::cos(p + delta);
+            ch2[k][1] += amplitude * std::sin(p + delta);
+        }
+
+        compute_magnitude_db(ch1.data(), mag1.data(), FFT_SIZE);
+        compute_magnitude_db(ch2.data(), mag2.data(), FFT_SIZE);
+    }
+
+    std::vector<SignalRegion> detect() const {
+        return detect_signals_cfar(mag1.data(), mag2.data(), FFT_SIZE, DEFAULT_CFAR, 0, FFT_SIZE - 1);
+    }
+
+    // Per-frame DF path as the pipeline runs it: one full-band CFAR, then DF over the regions
+    DFResult direction_finding(LastValidDoA& last_valid, const float* cal_phasor = nullptr) const {
+        return compute_direction_finding(ch1.data(), ch2.data(), mag1.data(), mag2.data(),
+                                         0, FFT_SIZE - 1, detect(), cal_phasor, last_valid);
+    }
+};
+
+// Bearing error statistics of compute_direction_finding over azimuths and noise realizations
+void test_accuracy(std::mt19937& rng) {
+    std::printf("[DF bench] Bearing accuracy (%zu bins, %d trials per azimuth)\n", SIGNAL_BINS, TRIALS);
+    SyntheticFrame frame;
+
+    for (const auto& bound : ACCURACY_BOUNDS) {
+        double sum_sq = 0.0;
+        float worst = 0.0f;
+        int measured = 0;
+        int trials = 0;
+        for (float azimuth : TEST_AZIMUTHS_DEG) {
+            for (int t = 0; t < TRIALS; t++) {
+                frame.generate(rng, azimuth, bound.snr_db, 0.0f);
+                LastValidDoA last_valid = {};
+                const DFResult result = frame.direction_finding(last_valid);
+                trials++;
+                if (result.confidence < DFConfig::MIN_CONFIDENCE_THRESHOLD || result.is_holding) continue;
+                measured++;
+                const float err = std::fabs(angle_error(result.azimuth, to_reported(azimuth)));
+                sum_sq += err * err;
+                worst = std::max(worst, err);
+            }
+        }
+
+        char label[64];
+        const double rms = measured > 0 ? std::sqrt(sum_sq / measured) : 180.0;
+        std::snprintf(label, sizeof(label), "SNR %4.0f dB: RMS error (deg)", bound.snr_db);
+        check(rms <= bound.max_rms_deg, label, rms, bound.max_rms_deg);
+        std::snprintf(label, sizeof(label), "SNR %4.0f dB: max error (deg)", bound.snr_db);
+        check(worst <= bound.max_error_deg, label, worst, bound.max_error_deg);
+        std::snprintf(label, sizeof(label), "SNR %4.0f dB: missed bearings (fraction)", bound.snr_db);
+        const double missed = 1.0 - static_cast<double>(measured) / trials;
+        check(missed <= bound.max_missed, label, missed, bound.max_missed);
+    }
+}
+
+// The interferometer equation, the mirror bearing and the quality metrics of a noiseless
+// cross-spectrum
+void test_estimate_bearing() {
+    std::printf("[DF bench] estimate_bearing on exact phases\n");
+    float worst = 0.0f;
+    float worst_back = 0.0f;
+    float worst_std = 0.0f;
+    for (float azimuth = -85.0f; azimuth <= 85.0f; azimuth += 5.0f) {
+        const double delta = M_PI * std::sin(azimuth * M_PI / 180.0);
+        CrossSpectrum cross = {};
+        cross.bins = 10;
+        cross.re = 10.0 * std::cos(delta);
+        cross.im = 10.0 * std::sin(delta);
+        cross.power_ch1 = 10.0;
+        cross.power_ch2 = 10.0;
+
+        const BearingMeasurement m = estimate_bearing(cross, 0.0f);
+        worst = std::max(worst, std::fabs(angle_error(m.azimuth, to_reported(azimuth))));
+        worst_back = std::max(worst_back, std::fabs(angle_error(m.back_azimuth, 180.0f - azimuth)));
+        worst_std = std::max(worst_std, m.phase_std_deg);
+    }
+    check(worst <= 0.01f, "azimuth error (deg)", worst, 0.01);
+    check(worst_back <= 0.01f, "back azimuth error (deg)", worst_back, 0.01);
+    check(worst_std <= 0.1f, "phase std of a coherent signal (deg)", worst_std, 0.1);
+
+    // Too few bins is no measurement
+    CrossSpectrum sparse = {1.0, 0.0, 1.0, 1.0, DFConfig::MIN_BINS_FOR_DF - 1};
+    const BearingMeasurement m = estimate_bearing(sparse, 0.0f);
+    check(m.confidence < DFConfig::MIN_CONFIDENCE_THRESHOLD, "confidence, < MIN_BINS_FOR_DF bins (0-100)",
+          m.confidence, DFConfig::MIN_CONFIDENCE_THRESHOLD);
+}
+
+// Kalman track: convergence on a noisy fixed bearing, wrap-around at north, coasting
+void test_kalman(std::mt19937& rng) {
+    std::printf("[DF bench] Kalman bearing track\n");
+    constexpr float TRUE_AZIMUTH = 30.0f;
+    constexpr float JITTER_DEG = 3.0f;
+    constexpr uint64_t STEP_MS = 100;
+    std::normal_distribution<float> jitter(0.0f, JITTER_DEG);
+
+    KalmanState track = {};
+    uint64_t now_ms = 1000;
+    double raw_sq = 0.0;
+    double filtered_sq = 0.0;
+    int settled = 0;
+    for (int i = 0; i < 200; i++) {
+        const float measurement = TRUE_AZIMUTH + jitter(rng);
+        const float filtered = update_bearing_track(track, measurement, JITTER_DEG, now_ms);
+        now_ms += STEP_MS;
+        if (i >= 50) {
+            raw_sq += (measurement - TRUE_AZIMUTH) * (measurement - TRUE_AZIMUTH);
+            const float err = angle_error(filtered, TRUE_AZIMUTH);
+            filtered_sq += err * err;
+            settled++;
+        }
+    }
+    const double raw_rms = std::sqrt(raw_sq / settled);
+    const double filtered_rms = std::sqrt(filtered_sq / settled);
+    check(filtered_rms <= 0.6 * raw_rms, "settled RMS error (deg)", filtered_rms, 0.6 * raw_rms);
+
+    // Coasting one second on a stationary track stays put
+    float coasted = track.azimuth;
+    for (int i = 0; i < 10; i++) {
+        now_ms += STEP_MS;
+        coasted = coast_bearing_track(track, now_ms);
+    }
+    const float coast_err = std::fabs(angle_error(coasted, TRUE_AZIMUTH));
+    check(coast_err <= 3.0f, "error after 1 s coast (deg)", coast_err, 3.0);
+
+    // Measurements alternating across north must not drag the track through 180
+    KalmanState north = {};
+    float worst_north = 0.0f;
+    for (int i = 0; i < 100; i++) {
+        const float measurement = (i % 2 == 0) ? 358.0f : 2.0f;
+        const float filtered = update_bearing_track(north, measurement, JITTER_DEG, now_ms);
+        now_ms += STEP_MS;
+        worst_north = std::max(worst_north, std::fabs(angle_error(filtered, 0.0f)));
+    }
+    check(worst_north <= 2.5f, "wrap-around at north, max error (deg)", worst_north, 2.5);
+}
+
+// Calibration interpolation and the calibrated DF path
+void test_calibration(std::mt19937& rng) {
+    std::printf("[DF bench] Array calibration\n");
+
+    // Interpolation between points and hold beyond them
+    add_calibration_point(900000000, 10.0f, 0.0f);   // correction -10
+    add_calibration_point(930000000, -20.0f, 0.0f);  // correction +20
+    set_calibration_enabled(true);
+    const float mid = get_phase_correction(915000000);
+    const float below = get_phase_correction(800000000);
+    const float above = get_phase_correction(1000000000);
+    check(std::fabs(mid - 5.0f) <= 1e-3f, "interpolated at 915 MHz, error (deg)", std::fabs(mid - 5.0f), 1e-3);
+    check(std::fabs(below + 10.0f) <= 1e-3f, "held below first point, error (deg)", std::fabs(below + 10.0f), 1e-3);
+    check(std::fabs(above - 20.0f) <= 1e-3f, "held above last point, error (deg)", std::fabs(above - 20.0f), 1e-3);
+
+    auto table = get_calibration_table(915000000, SAMPLE_RATE, FFT_SIZE);
+    const float table_mid = table->correction_deg[FFT_SIZE / 2];
+    check(std::fabs(table_mid - mid) <= 1e-3f, "per-bin table at DC, error (deg)", std::fabs(table_mid - mid), 1e-3);
+
+    // Calibrate a 40 degree hardware error at boresight, then measure off boresight
+    constexpr float HW_ERROR_DEG = 40.0f;
+    constexpr float TEST_AZIMUTH = 35.0f;
+    SyntheticFrame frame;
+    frame.generate(rng, 0.0f, 30.0f, HW_ERROR_DEG);
+    LastValidDoA reference = {};
+    const DFResult uncal = frame.direction_finding(reference);
+
+    clear_calibration();
+    add_calibration_point(CENTER_FREQ, uncal.phase_diff_deg, 0.0f);
+    table = get_calibration_table(CENTER_FREQ, SAMPLE_RATE, FFT_SIZE);
+
+    double sum_sq = 0.0;
+    for (int t = 0; t < TRIALS; t++) {
+        frame.generate(rng, TEST_AZIMUTH, 30.0f, HW_ERROR_DEG);
+        LastValidDoA last_valid = {};
+        const DFResult result = frame.direction_finding(last_valid, table->phasor.data());
+        const float err = angle_error(result.azimuth, TEST_AZIMUTH);
+        sum_sq += err * err;
+    }
+    const double rms = std::sqrt(sum_sq / TRIALS);
+    check(rms <= 1.0, "calibrated RMS error at 35 deg (deg)", rms, 1.0);
+
+    set_calibration_enabled(false);
+}
+
+// Microseconds per call of each DF stage on a 20 dB frame
+template <typename F>
+double time_us(int iterations, F&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+void benchmark(std::mt19937& rng, int iterations) {
+    std::printf("[DF bench] Latency (%d iterations, FFT size %zu)\n", iterations, FFT_SIZE);
+    SyntheticFrame frame;
+    frame.generate(rng, 20.0f, 20.0f, 0.0f);
+
+    std::vector<float> phasor(FFT_SIZE * 2);
+    for (size_t k = 0; k < FFT_SIZE; k++) {
+        phasor[k * 2] = std::cos(0.01f * k);
+        phasor[k * 2 + 1] = std::sin(0.01f * k);
+    }
+
+    volatile float sink = 0.0f;
+    LastValidDoA last_valid = {};
+    const double full = time_us(iterations, [&] {
+        sink = frame.direction_finding(last_valid).azimuth;
+    });
+    const double full_cal = time_us(iterations, [&] {
+        sink = frame.direction_finding(last_valid, phasor.data()).azimuth;
+    });
+    const double detect = time_us(iterations, [&] {
+        sink = static_cast<float>(frame.detect().size());
+    });
+    const std::vector<SignalRegion> regions = frame.detect();
+    const size_t lo = SIGNAL_CENTER - 256;
+    const size_t hi = SIGNAL_CENTER + 255;
+    const double narrow = time_us(iterations, [&] {
+        sink = compute_direction_finding(frame.ch1.data(), frame.ch2.data(), frame.mag1.data(), frame.mag2.data(),
+                                         lo, hi, regions, nullptr, last_valid).azimuth;
+    });
+    const double cross = time_us(iterations, [&] {
+        CrossSpectrum acc = {};
+        accumulate_cross_spectrum(frame.ch1.data(), frame.ch2.data(), 0, FFT_SIZE - 1, acc, phasor.data());
+        sink = static_cast<float>(acc.re);
+    });
+    CrossSpectrum acc = {};
+    accumulate_cross_spectrum(frame.ch1.data(), frame.ch2.data(), 0, FFT_SIZE - 1, acc);
+    const double estimate = time_us(iterations, [&] {
+        sink = estimate_bearing(acc, NOISE_POWER).azimuth;
+    });
+    KalmanState track = {};
+    uint64_t now_ms = 0;
+    const double kalman = time_us(iterations, [&] {
+        now_ms += 10;
+        sink = update_bearing_track(track, 20.0f, 2.0f, now_ms);
+    });
+    (void)sink;
+
+    std::printf("  %-44s %10.2f us\n", "CFAR + DF (full span)", full);
+    std::printf("  %-44s %10.2f us\n", "CFAR + DF (full span, calibrated)", full_cal);
+    std::printf("  %-44s %10.2f us\n", "detect_signals_cfar (full span)", detect);
+    std::printf("  %-44s %10.2f us\n", "compute_direction_finding (512 bins)", narrow);
+    std::printf("  %-44s %10.2f us\n", "accumulate_cross_spectrum (4096 bins, cal)", cross);
+    std::printf("  %-44s %10.3f us\n", "estimate_bearing", estimate);
+    std::printf("  %-44s %10.3f us\n", "update_bearing_track", kalman);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 2000;
+    std::mt19937 rng(12345);  // Fixed seed: results are reproducible run to run
+
+    test_estimate_bearing();
+    test_accuracy(rng);
+    test_kalman(rng);
+    test_calibration(rng);
+    benchmark(rng, iterations);
+
+    if (g_failures > 0) {
+        std::printf("[DF bench] %d check(s) FAILED\n", g_failures);
+        return 1;
+    }
+    std::printf("[DF bench] All checks passed\n");
+    return 0;
+}
@@ -1,7 +1,9 @@
 #ifndef ARRAY_CALIBRATION_H
 #define ARRAY_CALIBRATION_H
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -21,16 +23,40 @@ struct ArrayCalibration {
     float antenna_spacing_actual;      // Actual measured spacing (wavelengths at ref freq)
 };
 
-// Global calibration state (thread-safe access via mutex)
+// Per-bin calibration for one tuning, immutable once published
+// Readers hold a shared_ptr to a snapshot; changes publish a new one (no reader locking)
+struct CalibrationTable {
+    uint64_t center_freq;              // Tuning the table was built for
+    uint32_t sample_rate;
+    size_t fft_size;
+    uint64_t version;                  // Calibration version it was built from
+    bool enabled;                      // False: no correction (vectors empty)
+    std::vector<float> correction_deg; // Per-bin phase correction (degrees)
+    std::vector<float> phasor;         // Per-bin exp(j * correction), interleaved re/im
+};
+
+// Global calibration state (thread-safe access via mutex; modify only through the
+// functions below so published tables are rebuilt)
 extern ArrayCalibration g_array_cal;
 extern std::mutex g_calibration_mutex;
 
 // Add or update a calibration point
 void add_calibration_point(uint64_t frequency, float measured_phase_diff_deg, float known_azimuth_deg);
 
+// Remove all calibration points
+void clear_calibration();
+
 // Get phase correction for a given frequency (interpolated if needed)
 float get_phase_correction(uint64_t frequency);
 
+// Enable or disable calibration correction
+void set_calibration_enabled(bool enabled);
+
+// Get the per-bin correction table for the current tuning
+// Lock-free when the published table matches; otherwise rebuilds it (calibration or tuning changed)
+std::shared_ptr<const CalibrationTable> get_calibration_table(uint64_t center_freq, uint32_t sample_rate,
+                                                              size_t fft_size);
+
 // Save calibration data to file
 void save_calibration(const std::string& filename);
 
@@ -0,0 +1,86 @@
+#ifndef BEAMFORMER_H
+#define BEAMFORMER_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "array_calibration.h"
+#include "signal_processing.h"
+
+// Two-element steered beamformer
+// Per bin, RX2 is calibrated and phase-steered toward a bearing, then added to (sum beam)
+// and subtracted from (difference beam) RX1. The steering phase follows the interferometer
+// model, sin(theta) = dphi / (2 pi d), with d = DFConfig::ANTENNA_SPACING_WAVELENGTHS at the
+// center frequency and scaled with each bin's frequency (true time delay). The sum beam
+// gains up to 3 dB of SNR on the steered bearing; the difference beam places a null there.
+// Either can replace RX1/RX2 as the CFAR and display input. Off by default.
+
+// Beamformer configuration
+namespace BeamformerConfig {
+    constexpr float MAX_STEER_AZIMUTH_DEG = 90.0f;   // Steering range is +/- this from boresight
+    constexpr uint32_t PUBLISH_INTERVAL_FRAMES = 10;
+}
+
+// Beamformer settings (set from the web server)
+struct BeamformerSettings {
+    bool enabled;
+    float steer_azimuth_deg;       // Interferometer convention: 0 = boresight, + toward RX2
+    bool cfar_input;               // CFAR and DF detection run on the sum beam
+    bool display_input;            // Waterfall shows the sum (CH1) and difference (CH2) beams
+};
+
+// Beamformer state (owned by the processing thread)
+struct BeamformerState {
+    size_t fft_size;
+    BeamformerSettings settings;
+    uint64_t settings_version;
+    uint64_t frame_counter;
+
+    // Tuning and calibration the weights were built for
+    uint64_t center_freq;
+    uint32_t sample_rate;
+    std::shared_ptr<const CalibrationTable> cal_table;
+
+    // Per-bin RX2 weight: calibration phasor x conj(steering phasor)
+    std::vector<float> weight_re;
+    std::vector<float> weight_im;
+
+    // Complex beams, interleaved re/im (fftwf_complex layout)
+    std::vector<float> sum_beam;
+    std::vector<float> diff_beam;
+
+    NoiseFloorState noise_floor;   // Sum beam (channel 0) and difference beam (channel 1)
+};
+
+// Initialize state for a given FFT size
+void init_beamformer(BeamformerState& state, size_t fft_size);
+
+// True while the beamformer is enabled (skip update_beamformer otherwise)
+bool beamformer_enabled();
+
+// Form the beams of one frame and convert them to display magnitudes
+// Magnitudes get the same DC-bin cleanup as the channels, and feed the beam noise floor.
+// Args:
+//   fft_ch1, fft_ch2: RX1 / RX2 FFT output (fft_size bins, DC at fft_size/2)
+//   center_freq: Current center frequency in Hz (weights are rebuilt on retune)
+//   sample_rate: Current sample rate in Hz
+//   cal_table: Per-bin calibration for this tuning (get_calibration_table)
+//   beam_mag: Output magnitude planes, sum beam then difference beam (2 x fft_size, 0-255 scale)
+void update_beamformer(BeamformerState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                       uint64_t center_freq, uint32_t sample_rate,
+                       const std::shared_ptr<const CalibrationTable>& cal_table, uint8_t* beam_mag);
+
+// Replace the beamformer settings (thread-safe, picked up on the next frame)
+// Returns false if the steering azimuth is out of range
+bool set_beamformer_settings(const BeamformerSettings& settings);
+
+// Current beamformer settings
+BeamformerSettings get_beamformer_settings();
+
+// Get the settings and latest beam noise floors as JSON
+std::string get_beamformer_json();
+
+#endif // BEAMFORMER_H
@@ -0,0 +1,115 @@
+#ifndef BEARING_TABLE_H
+#define BEARING_TABLE_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cfar_detector.h"
+#include "df_processing.h"
+
+// Concurrent multi-emitter direction finding
+// Every frame, each CFAR-detected region and each user-defined DF band gets its own
+// bearing from the same FFT frame. Regions are associated with tracks by center bin so
+// every emitter keeps a stable ID and its own Kalman filter; bands are keyed by band ID.
+// Bearings come from a per-bin 2x2 cross-spectral matrix integrated over K frames
+// (full-band for emitters, band-local with its own K for each user band), so weak
+// signals are averaged coherently before the phase is taken.
+// Per-track work runs on a small persistent worker pool when many tracks are measured.
+
+// Bearing table configuration
+namespace BearingTableConfig {
+    constexpr size_t MAX_TRACKS = 32;               // Emitter track pool (least recently seen is evicted)
+    constexpr size_t MAX_BANDS = 8;                 // User-defined DF bands
+    constexpr float MATCH_TOLERANCE_BINS = 8.0f;    // Region-to-track association gate (center bin)
+    constexpr float CENTER_ALPHA = 0.3f;            // EWMA smoothing of a track's center bin
+    constexpr uint64_t TRACK_TIMEOUT_MS = 3000;     // Tracks without a measurement this long are dropped
+    constexpr size_t PARALLEL_MIN_ITEMS = 8;        // Use workers at or above this many measurements
+    constexpr unsigned MAX_WORKERS = 4;
+    constexpr uint32_t PUBLISH_INTERVAL_FRAMES = 5; // Publish table snapshot every N frames
+    constexpr uint32_t DEFAULT_INTEGRATION_FRAMES = 8;  // K for emitters and bands without one
+    constexpr uint32_t MAX_INTEGRATION_FRAMES = 256;
+}
+
+// User-defined DF band
+struct DFBand {
+    uint32_t id;                // Stable band ID (0 = unused slot)
+    uint32_t start_bin;
+    uint32_t end_bin;
+    uint32_t integration_frames; // K for this band's cross-spectral matrix
+};
+
+// One bearing track (detected emitter or user band)
+struct BearingTrack {
+    uint32_t id;                // Stable track ID (0 = unused slot)
+    uint32_t band_id;           // Owning user band (0 = detected emitter)
+    float center_bin;           // EWMA center bin (association key for emitters)
+    size_t start_bin;           // Extent of the last measurement
+    size_t end_bin;
+    KalmanState kalman;
+    CrossSpectralMatrix csm;    // Band-local integration (band tracks only)
+    BearingMeasurement last;    // Last raw measurement
+    float azimuth;              // Filtered azimuth
+    float back_azimuth;
+    uint64_t first_seen_ms;
+    uint64_t last_seen_ms;      // Last accepted measurement
+    uint32_t updates;           // Accepted measurements
+    bool holding;               // True if coasting on the Kalman prediction
+};
+
+// Measurement queued for one track this frame (bins are ranges in the shared range list)
+struct BearingWorkItem {
+    BearingTrack* track;
+    size_t first_range;
+    size_t range_count;
+};
+
+// Complete bearing table state (owned by the analysis thread)
+struct BearingTableState {
+    CrossSpectralMatrix csm;                        // Full-band integration shared by emitter tracks
+    std::vector<BearingTrack> emitters;             // Fixed-size emitter track pool
+    std::vector<BearingTrack> bands;                // One track per user band slot
+    std::vector<std::pair<size_t, size_t>> ranges;  // Bin ranges of this frame's work items
+    std::vector<BearingWorkItem> work;
+    std::vector<uint8_t> matched;                   // Per-emitter-slot association flags
+    uint32_t next_id;
+    uint64_t frame_counter;
+};
+
+// Initialize state for a given FFT size and start the worker pool
+void init_bearing_table(BearingTableState& state, size_t fft_size);
+
+// Stop the worker pool
+void destroy_bearing_table(BearingTableState& state);
+
+// Measure and track every detected region and user band in one frame
+// Args:
+//   fft_ch1, fft_ch2: Complex FFT output of the frame
+//   regions: Full-band CFAR detections of the frame
+//   noise_power: Noise power in FFT units (see noise_power_from_floor)
+//   center_freq: Current center frequency in Hz (integration restarts on retune)
+//   cal_phasor: Per-bin calibration phasors for the current tuning (nullptr = uncorrected)
+void update_bearing_table(BearingTableState& state, const fftwf_complex* fft_ch1,
+                          const fftwf_complex* fft_ch2, const std::vector<SignalRegion>& regions,
+                          float noise_power, uint64_t center_freq, const float* cal_phasor);
+
+// Publish the bearing table for the web server (thread-safe)
+void publish_bearing_table(const BearingTableState& state, uint64_t center_freq, uint32_t sample_rate,
+                           size_t fft_size);
+
+// Get the latest published bearing table as JSON
+std::string get_bearing_table_json();
+
+// Add a user DF band (thread-safe, picked up on the next frame)
+// Args:
+//   start_bin, end_bin: Band extent in FFT bins
+//   integration_frames: K for the band's cross-spectral matrix (clamped to 1..MAX_INTEGRATION_FRAMES)
+// Returns the band ID, or 0 if the band table is full or the range is invalid
+uint32_t add_df_band(uint32_t start_bin, uint32_t end_bin,
+                     uint32_t integration_frames = BearingTableConfig::DEFAULT_INTEGRATION_FRAMES);
+
+// Remove a user DF band; returns false if the ID is unknown
+bool remove_df_band(uint32_t id);
+
+#endif // BEARING_TABLE_H
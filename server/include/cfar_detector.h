@@ -53,4 +53,9 @@ std::vector<SignalRegion> detect_signals_cfar_with_floor(const uint8_t* ch1_mag,
                                                           size_t bin_start, size_t bin_end,
                                                           float noise_floor_ch1, float noise_floor_ch2);
 
+// Merge detections from another detector (e.g. spectral kurtosis) into a region list
+// Overlapping or adjacent regions are joined; the result is sorted by start bin.
+// A joined region keeps the power fields of the region that starts first.
+void merge_signal_regions(std::vector<SignalRegion>& regions, const std::vector<SignalRegion>& extra);
+
 #endif // CFAR_DETECTOR_H
@@ -0,0 +1,46 @@
+#ifndef COMPLEX_MATRIX_H
+#define COMPLEX_MATRIX_H
+
+#include <cstddef>
+
+// Small dense complex matrix kernels for array processing (covariance inversion and
+// Hermitian eigendecomposition of element-count sized matrices, n <= MAX_DIM).
+// Fixed-capacity storage with split real/imaginary planes: no heap traffic and no
+// general linear-algebra dependency, and the inner loops are plain float arithmetic.
+
+namespace ComplexMatrixConfig {
+    constexpr size_t MAX_DIM = 8;               // Largest supported matrix (array elements)
+    constexpr int MAX_JACOBI_SWEEPS = 16;       // Eigen solver sweep limit
+    constexpr float JACOBI_TOLERANCE = 1e-7f;   // Off-diagonal norm / trace at convergence
+}
+
+// Dense complex matrix (row-major, only the top-left n x n block is used)
+struct CMatrix {
+    size_t n;
+    float re[ComplexMatrixConfig::MAX_DIM][ComplexMatrixConfig::MAX_DIM];
+    float im[ComplexMatrixConfig::MAX_DIM][ComplexMatrixConfig::MAX_DIM];
+};
+
+// Set to the n x n zero matrix
+void cmat_zero(CMatrix& m, size_t n);
+
+// Add value to every diagonal element (diagonal loading)
+void cmat_add_diagonal(CMatrix& m, float value);
+
+// Real part of the trace
+float cmat_trace(const CMatrix& m);
+
+// Inverse of a Hermitian positive-definite matrix (closed form for 2x2, Cholesky otherwise)
+// Returns false if the matrix is not positive definite
+bool cmat_hermitian_inverse(const CMatrix& a, CMatrix& inverse);
+
+// Eigendecomposition of a Hermitian matrix by cyclic complex Jacobi rotations
+// Args:
+//   eigenvalues: Output - n eigenvalues in ascending order
+//   eigenvectors: Output - matching unit eigenvectors as columns
+void cmat_hermitian_eigen(const CMatrix& a, float* eigenvalues, CMatrix& eigenvectors);
+
+// Projector onto the span of columns [first, first + count) of v: P = V_s V_s^H
+void cmat_column_projector(const CMatrix& v, size_t first, size_t count, CMatrix& projector);
+
+#endif // COMPLEX_MATRIX_H
@@ -19,6 +19,21 @@ struct DeltaState {
     }
 };
 
+// Reusable deflate stream (zlib format, Z_BEST_SPEED)
+// deflateInit allocates and initializes ~256 KB of state; one stream reset per frame with
+// deflateReset avoids that setup and teardown on every frame
+struct DeflateState {
+    z_stream stream;
+    bool initialized;
+
+    DeflateState() : stream{}, initialized(false) {}
+    ~DeflateState() {
+        if (initialized) deflateEnd(&stream);
+    }
+    DeflateState(const DeflateState&) = delete;
+    DeflateState& operator=(const DeflateState&) = delete;
+};
+
 // Compression statistics
 struct CompressionStats {
     size_t raw_bytes;
@@ -33,11 +48,26 @@ struct CompressionStats {
 bool delta_encode(const uint8_t* current, size_t size, DeltaState& state,
                   std::vector<int8_t>& delta_out);
 
+// Delta of two rows: out[i] = current[i] - previous[i] (mod 256, vectorized)
+// Decode with current[i] = previous[i] + out[i] (mod 256)
+void delta_rows(const uint8_t* current, const uint8_t* previous, uint8_t* out, size_t size);
+
 // Compress data using gzip (best speed)
 // Returns compressed size, or 0 on error
 size_t gzip_compress(const void* input, size_t input_size,
                      std::vector<uint8_t>& output);
 
+// Compress data to the gzip file format (RFC 1952), as sent with "Content-Encoding: gzip"
+// gzip_compress above writes a zlib stream, which HTTP clients do not accept as gzip
+// Returns compressed size, or 0 on error
+size_t gzip_encode(const void* input, size_t input_size,
+                   std::vector<uint8_t>& output, int level = Z_BEST_COMPRESSION);
+
+// Deflate input and append the zlib stream to output, reusing the stream state
+// Returns compressed size, or 0 on error
+size_t deflate_append(DeflateState& state, const void* input, size_t input_size,
+                      std::vector<uint8_t>& output);
+
 // Compress with delta encoding + gzip
 // Returns compressed size, or 0 on error
 // Sets is_delta_frame to indicate if this is delta (true) or full (false)
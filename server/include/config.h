@@ -1,6 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <cstddef>
 #include <cstdint>
 
 // ============================================================================
@@ -35,6 +36,17 @@ namespace NoiseFloorConfig {
     constexpr int UPDATE_INTERVAL_FRAMES = 10;   // Update every 10 frames to reduce CPU load
 }
 
+// Coherent receive channels
+// Samples arrive as frames of NUM_CHANNELS interleaved I/Q pairs (the BLADERF_RX_X2
+// layout for two channels) and are split into one plane per channel; everything from
+// the FFT onward is per channel. Displays, CFAR and the interferometer use channels 0/1.
+namespace ChannelConfig {
+    constexpr size_t MAX_CHANNELS = 8;
+    constexpr size_t NUM_CHANNELS = 2;          // One bladeRF in BLADERF_RX_X2
+    constexpr size_t PARALLEL_MIN_CHANNELS = 4; // Per-channel FFTs run on workers at or above this
+    constexpr unsigned MAX_WORKERS = 4;
+}
+
 // ============================================================================
 // DIRECTION FINDING CONFIGURATION
 // Phase-based interferometry parameters for 2-channel DF
@@ -60,6 +72,20 @@ namespace DFConfig {
     constexpr float COHERENCE_DECAY = 10.0f;     // Decay rate for coherence metric
 }
 
+// Antenna array geometry for the subspace / beamformer DF engine
+// Element positions in meters in the horizontal plane: +y is boresight, +x is to the
+// right of boresight, azimuth is measured clockwise from boresight. Element i is
+// receive channel i (element 0 = RX1). Any planar layout works; collinear layouts
+// keep the usual front/back ambiguity.
+namespace ArrayConfig {
+    constexpr size_t MAX_ELEMENTS = ChannelConfig::MAX_CHANNELS;
+    constexpr size_t NUM_ELEMENTS = ChannelConfig::NUM_CHANNELS;
+    // Default: two elements λ/2 apart at 915 MHz (0.164m baseline across boresight)
+    constexpr float ELEMENT_X_M[MAX_ELEMENTS] = {-0.082f, 0.082f};
+    constexpr float ELEMENT_Y_M[MAX_ELEMENTS] = {0.0f, 0.0f};
+    constexpr double SPEED_OF_LIGHT = 299792458.0;  // m/s
+}
+
 // Kalman filter configuration for bearing tracking
 namespace KalmanConfig {
     constexpr float PROCESS_NOISE_AZIMUTH = 0.5f;    // Process noise for azimuth (deg^2)
@@ -7,11 +7,13 @@
 #include <fftw3.h>
 #include "cfar_detector.h"
 
-// Bin information for direction finding
-struct BinInfo {
-    size_t index;
-    float magnitude;
-    float phase_diff;
+// Cross-spectrum sums over a set of bins (X2 * conj(X1), CH2 relative to CH1)
+struct CrossSpectrum {
+    double re;                  // Sum of cross-spectrum real parts
+    double im;                  // Sum of cross-spectrum imaginary parts
+    double power_ch1;           // Sum of |X1|^2
+    double power_ch2;           // Sum of |X2|^2
+    size_t bins;                // Number of bins accumulated
 };
 
 // Direction finding result structure
@@ -28,6 +30,19 @@ struct DFResult {
     size_t num_signals;         // Number of CFAR detected signals
 };
 
+// Single bearing estimate from one cross-spectrum (before tracking)
+struct BearingMeasurement {
+    float azimuth;              // Primary azimuth angle (0-360 degrees)
+    float back_azimuth;         // Mirror solution of the 2-element array
+    float phase_diff_deg;       // Calibrated phase difference in degrees
+    float phase_std_deg;        // Phase standard deviation (quality metric)
+    float confidence;           // Confidence percentage (0-100)
+    float snr_db;               // Signal-to-noise ratio estimate (dB)
+    float coherence;            // Coherence metric (0-1)
+    float msc;                  // Magnitude-squared coherence of the cross-spectrum (0-1)
+    size_t num_bins;            // Number of bins in the measurement
+};
+
 // Kalman filter state for bearing smoothing
 struct KalmanState {
     float azimuth;           // Estimated azimuth (degrees)
@@ -52,13 +67,70 @@ struct LastValidDoA {
     KalmanState kalman;       // Kalman filter state for smoothing
 };
 
+// Per-bin 2x2 cross-spectral matrix integrated over frames
+// Each bin holds an EWMA (time constant K frames) of |X1|^2, |X2|^2 and X2 * conj(X1),
+// so weak signals are integrated coherently before the phase is taken.
+struct CrossSpectralMatrix {
+    size_t start_bin;           // First FFT bin covered
+    size_t bins;                // Number of bins covered
+    uint32_t integration_frames; // K (1 = single frame)
+    uint32_t frames;            // Frames integrated since the last reset
+    uint64_t center_freq;       // Integration restarts on retune
+    std::vector<float> s11;     // E[|X1|^2]
+    std::vector<float> s22;     // E[|X2|^2]
+    std::vector<float> s12_re;  // E[X2 * conj(X1)]
+    std::vector<float> s12_im;
+};
+
+// Size a cross-spectral matrix for bins [start_bin, start_bin + bins) and reset it
+void init_cross_spectral_matrix(CrossSpectralMatrix& csm, size_t start_bin, size_t bins,
+                                uint32_t integration_frames);
+
+// Integrate one frame (O(bins), vectorized)
+// Args:
+//   fft_ch1, fft_ch2: Complex FFT output of the frame (full spectrum)
+//   center_freq: Current center frequency (integration restarts when it changes)
+void update_cross_spectral_matrix(CrossSpectralMatrix& csm, const fftwf_complex* fft_ch1,
+                                  const fftwf_complex* fft_ch2, uint64_t center_freq);
+
+// Add the integrated matrix over bins [bin_start, bin_end] to a cross-spectrum accumulator
+// (bins outside the matrix are ignored)
+//   cal_phasor: Per-bin calibration phasors indexed by FFT bin (nullptr = uncorrected)
+void accumulate_cross_spectral_matrix(const CrossSpectralMatrix& csm, size_t bin_start, size_t bin_end,
+                                      CrossSpectrum& acc, const float* cal_phasor = nullptr);
+
+// Add bins [bin_start, bin_end] to a cross-spectrum accumulator
+// The phase of (re, im) is the magnitude-weighted mean phase difference of those bins
+//   cal_phasor: Per-bin calibration phasors (CalibrationTable::phasor, nullptr = uncorrected)
+void accumulate_cross_spectrum(const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                               size_t bin_start, size_t bin_end, CrossSpectrum& acc,
+                               const float* cal_phasor = nullptr);
+
+// Convert CFAR noise floor estimates (0-255 scale) to FFT power units
+// Returns 0 if either estimate is unavailable (< 0)
+float noise_power_from_floor(float noise_floor_ch1, float noise_floor_ch2);
+
+// Turn a (calibrated) cross-spectrum into phase difference, azimuth and quality metrics
+// Args:
+//   cross: Accumulated cross-spectrum of the bins to measure
+//   noise_power: Noise power in FFT units for the SNR estimate (0 = unknown)
+BearingMeasurement estimate_bearing(const CrossSpectrum& cross, float noise_power);
+
+// Feed a bearing measurement into a Kalman track (initializes on first use)
+// Returns the filtered azimuth
+float update_bearing_track(KalmanState& state, float azimuth, float phase_std_deg, uint64_t now_ms);
+
+// Advance a Kalman track without a measurement
+// Returns the predicted azimuth
+float coast_bearing_track(KalmanState& state, uint64_t now_ms);
+
 // Perform complete direction finding analysis on FFT data
 // Args:
 //   fft_out_ch1, fft_out_ch2: FFT output from both channels
 //   ch1_mag, ch2_mag: Magnitude arrays (0-255 scale)
-//   fft_size: Size of FFT (typically 4096)
 //   bin_start, bin_end: Frequency range to process (0 = full spectrum)
-//   center_freq: Current center frequency in Hz (for calibration)
+//   regions: Detected signal regions of this frame (any span; clipped to the DF range)
+//   cal_phasor: Per-bin calibration phasors for the current tuning (nullptr = uncorrected)
 //   last_valid: Last valid DoA state (for bearing hold logic)
 //   noise_floor_ch1, noise_floor_ch2: Optional noise floor estimates (< 0 to disable)
 // Returns: DFResult with azimuth, confidence, and quality metrics
@@ -67,10 +139,10 @@ DFResult compute_direction_finding(
     const fftwf_complex* fft_out_ch2,
     const uint8_t* ch1_mag,
     const uint8_t* ch2_mag,
-    size_t fft_size,
     size_t bin_start,
     size_t bin_end,
-    uint64_t center_freq,
+    const std::vector<SignalRegion>& regions,
+    const float* cal_phasor,
     LastValidDoA& last_valid,
     float noise_floor_ch1 = -1.0f,
     float noise_floor_ch2 = -1.0f
@@ -0,0 +1,71 @@
+#ifndef DF_WATERFALL_H
+#define DF_WATERFALL_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bearing-versus-frequency DF waterfall
+// Every frame, the calibrated cross-spectrum of each group of bins is turned into a bearing
+// (branch-free atan2 approximation, then a precomputed asin table that maps the phase
+// difference straight to a quantized azimuth byte). Rows are kept in a ring and served
+// delta/run-length compressed, so the frequency x time x azimuth picture costs little
+// bandwidth where the scene is static. Computed only while a client is polling.
+
+// DF waterfall configuration
+namespace DFWaterfallConfig {
+    constexpr size_t GROUP_BINS = 4;                 // FFT bins per column (4096 -> 1024 columns)
+    constexpr size_t HISTORY_ROWS = 256;             // Rows kept for clients
+    constexpr size_t MAX_ROWS_PER_REQUEST = 64;
+    constexpr size_t ASIN_LUT_SIZE = 2048;           // Phase -> azimuth table entries over [-pi, pi]
+    constexpr float GATE_MARGIN = 12.0f;             // Column must exceed the noise floor by this (0-255 scale, ~6 dB)
+    constexpr uint64_t CLIENT_TIMEOUT_US = 2000000;  // Mode lapses after 2 s without a poll
+}
+
+// Row encoding: byte 0 = no signal, 1-255 = azimuth -90..+90 degrees off boresight
+// (the 2-element front/back ambiguity is left to the client, as for /doa_result)
+
+// DF waterfall state (owned by the analysis thread)
+struct DFWaterfallState {
+    size_t fft_size;
+    size_t columns;
+    std::vector<float> phase;           // Per-column phase difference (radians)
+    std::vector<uint8_t> level;         // Per-column peak magnitude (0-255 scale)
+    std::vector<uint8_t> row;           // Quantized output row
+    std::vector<uint8_t> asin_lut;      // Phase index -> azimuth byte
+    uint64_t rows_computed;
+};
+
+// Initialize state and the asin lookup for a given FFT size
+void init_df_waterfall(DFWaterfallState& state, size_t fft_size);
+
+// True while a client has polled recently (skip update_df_waterfall otherwise)
+bool df_waterfall_active();
+
+// Compute and publish one waterfall row
+// Args:
+//   fft_ch1, fft_ch2: Complex FFT output of the frame
+//   ch1_mag, ch2_mag: Magnitude arrays (0-255 scale)
+//   noise_floor: Noise floor estimate (0-255 scale, < 0 to gate on magnitude alone)
+//   cal_phasor: Per-bin calibration phasors (nullptr = uncorrected)
+void update_df_waterfall(DFWaterfallState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                         const uint8_t* ch1_mag, const uint8_t* ch2_mag, float noise_floor,
+                         const float* cal_phasor);
+
+// Get rows newer than since_sequence, delta-coded against the previous row and run-length
+// coded (renews the client subscription)
+// Encoding per row: a zero byte is followed by a run length (1-255) of unchanged columns,
+// any other byte is the column's change (mod 256) from the previous row. The first row
+// returned is coded against an all-zero row.
+// Args:
+//   out: Output - concatenated encoded rows, each prefixed by its length (uint16 little-endian)
+//   rows: Output - number of rows returned
+//   last_sequence: Output - sequence number of the newest row (pass back as since_sequence)
+void get_df_waterfall_rows(uint64_t since_sequence, std::vector<uint8_t>& out, size_t& rows,
+                           uint64_t& last_sequence);
+
+// Columns per row (0 before init)
+size_t get_df_waterfall_columns();
+
+#endif // DF_WATERFALL_H
@@ -0,0 +1,88 @@
+#ifndef GCC_PHAT_H
+#define GCC_PHAT_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "array_calibration.h"
+
+// Inter-channel time-delay estimation (GCC-PHAT)
+// The RX2 x conj(RX1) cross-spectrum of the DF band is integrated over a few frames,
+// whitened (PHAT: every bin reduced to its phase) and inverse transformed with a cached
+// plan. The correlation envelope peak gives the integer lag and validity, the mean
+// bin-to-bin phase step of the whitened spectrum the sub-sample part. The carrier phase
+// only rotates the correlation, so the envelope peak is the group delay.
+//
+// Two uses:
+// - Bearing: sin(theta) = -delay * c / baseline. Only meaningful when the baseline spans
+//   at least MIN_BEARING_SPAN_SAMPLES of delay (long baselines or high sample rates); the
+//   default lambda/2 array spans a small fraction of a sample and reports no bearing.
+// - Skew monitor: with calibration applied the residual delay should stay at zero, so its
+//   smoothed value and history track cable/clock drift since the last calibration.
+
+// GCC-PHAT configuration
+namespace GccPhatConfig {
+    constexpr uint32_t INTEGRATION_FRAMES = 8;       // Cross-spectrum EWMA length
+    constexpr uint32_t ESTIMATE_INTERVAL_FRAMES = 10; // Inverse FFT and peak search every N frames
+    constexpr float PHAT_EPSILON = 1e-20f;           // Keeps empty bins at zero weight
+    constexpr float MIN_PEAK_RATIO = 8.0f;           // Peak over mean correlation power for a valid estimate
+    constexpr float MIN_BEARING_SPAN_SAMPLES = 1.0f; // Baseline delay needed before a bearing is reported
+    constexpr float SKEW_ALPHA = 0.05f;              // Skew monitor EWMA factor
+    constexpr size_t SKEW_HISTORY = 120;             // Skew estimates kept for the drift plot
+}
+
+// GCC-PHAT state (plan created on the main thread, updated by the analysis thread)
+struct GccPhatState {
+    size_t fft_size;
+    fftwf_complex* ifft_in;
+    fftwf_complex* ifft_out;
+    fftwf_plan ifft_plan;
+    double baseline_m;             // Element 0 to element 1 distance (ArrayConfig)
+
+    // Integrated cross-spectrum (one entry per bin, DC at fft_size/2)
+    std::vector<float> cross_re;
+    std::vector<float> cross_im;
+    uint32_t frames;
+    uint64_t frame_counter;
+    uint64_t center_freq;
+    size_t start_bin;
+    size_t end_bin;
+
+    // Latest estimate
+    bool valid;
+    float delay_samples;           // RX2 relative to RX1 (positive: RX2 lags)
+    float peak_ratio;
+    bool calibrated;
+
+    // Skew monitor
+    bool skew_initialized;
+    float skew_ns;
+    float skew_var_ns2;
+    std::vector<float> skew_history;
+    size_t history_index;
+    size_t history_count;
+};
+
+// Allocate buffers and create the inverse plan (call before the pipeline threads start)
+void init_gcc_phat(GccPhatState& state, size_t fft_size);
+
+// Free buffers and the plan
+void destroy_gcc_phat(GccPhatState& state);
+
+// Integrate one frame; every ESTIMATE_INTERVAL_FRAMES frames also estimate and publish the delay
+// Args:
+//   fft_ch1, fft_ch2: RX1 / RX2 FFT output
+//   start_bin, end_bin: Band to correlate over (inclusive; integration restarts when it changes)
+//   center_freq: Current center frequency in Hz (integration restarts on retune)
+//   sample_rate: Current sample rate in Hz
+//   cal_table: Per-bin calibration for this tuning (applied to RX2)
+void update_gcc_phat(GccPhatState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                     size_t start_bin, size_t end_bin, uint64_t center_freq, uint32_t sample_rate,
+                     const CalibrationTable& cal_table);
+
+// Get the latest delay, bearing and skew history as JSON
+std::string get_gcc_phat_json();
+
+#endif // GCC_PHAT_H
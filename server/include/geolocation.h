@@ -0,0 +1,120 @@
+#ifndef GEOLOCATION_H
+#define GEOLOCATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "bearing_table.h"
+
+// Bearing-only emitter geolocation from a moving platform
+// Position fixes (gpsd or manual) go into a time-indexed history; each accepted bearing of
+// a bearing-table track is placed at the platform position and heading interpolated to the
+// frame timestamp and turned into a true bearing line in a local east/north plane.
+// Each emitter keeps the normal equations of the pseudo-linear (Stansfield) fix,
+//   sum w n n^T t = sum w n (n . p),   n = (cos b, -sin b),
+// so a new bearing is an O(1) rank-one update followed by a closed-form 2x2 solve. Weights
+// are 1 / (sigma_b * range)^2 with the range taken from the current solution. The 2-element
+// array cannot tell front from back, so two hypotheses are solved, each taking whichever
+// of the primary/mirror lines points closer to its own solution. The one with the smaller
+// residual (and the emitter ahead along its bearings) is reported with a 95% error ellipse
+// from the solution covariance; it stays flagged ambiguous until the platform's path
+// (a turn) makes the mirror fit clearly worse.
+
+// Geolocation configuration
+namespace GeolocConfig {
+    constexpr size_t POSITION_HISTORY = 1024;           // Position fixes kept for interpolation
+    constexpr uint64_t MAX_EXTRAPOLATION_US = 2000000;  // Use the last GPS fix this long after it
+    constexpr float MIN_SPEED_FOR_COURSE_MPS = 1.0f;    // Slower than this, GPS course is unusable
+    constexpr size_t MAX_EMITTERS = 32;                 // Emitter pool (LRU eviction)
+    constexpr uint64_t MIN_BEARING_INTERVAL_US = 200000;// Bearings per emitter are thinned to this
+    constexpr double MIN_MOVE_M = 2.0;                  // ... and to this much platform movement
+    constexpr uint64_t EMITTER_TIMEOUT_US = 600000000;  // Drop emitters without a bearing for 10 min
+    constexpr float MIN_BEARING_SIGMA_DEG = 1.0f;
+    constexpr float MAX_BEARING_SIGMA_DEG = 30.0f;
+    constexpr uint32_t MIN_BEARINGS = 3;                // Bearings before a fix is reported
+    constexpr double MIN_CONDITION = 1e-3;              // Normal-matrix eigenvalue ratio (bearing spread)
+    constexpr double MIN_RANGE_M = 10.0;                // Range floor for the Stansfield weight
+    constexpr double ELLIPSE_CHI2_95 = 5.991;           // 2-DOF chi-square at 95%
+    constexpr double AMBIGUITY_RESIDUAL_RATIO = 2.0;    // Mirror fix reported ambiguous within this residual ratio
+    constexpr double EARTH_RADIUS_M = 6371000.0;
+    constexpr uint32_t PUBLISH_INTERVAL_FRAMES = 20;
+}
+
+// Geolocation settings (set from the web server)
+struct GeolocSettings {
+    bool use_gps_course;           // Boresight = GPS course + mount_offset (else fixed_heading)
+    float mount_offset_deg;        // Array boresight relative to the direction of travel
+    float fixed_heading_deg;       // True heading of boresight when not using GPS course
+};
+
+// Incremental normal equations of one bearing hypothesis
+struct GeolocHypothesis {
+    double a11, a12, a22;          // sum w n n^T
+    double b1, b2;                 // sum w n (n . p)
+    double c;                      // sum w (n . p)^2 (for the residual)
+    uint32_t bearings;
+    bool solved;
+    double east_m, north_m;        // Solution in the local plane
+    double residual;               // Weighted residual sum of squares
+    bool in_front;                 // Solution lies ahead along the latest bearing
+};
+
+// One geolocated emitter (keyed by bearing-table track ID)
+struct GeolocEmitter {
+    uint32_t track_id;             // 0 = unused slot
+    uint32_t track_updates;        // Track update count when last seen
+    uint64_t first_us;
+    uint64_t last_us;              // Last accepted bearing
+    double last_east_m, last_north_m;  // Platform position of the last accepted bearing
+    double center_freq_hz;
+    GeolocHypothesis hyp[2];       // Front/back ambiguity hypotheses
+};
+
+// Geolocation state (owned by the analysis thread)
+struct GeolocState {
+    GeolocSettings settings;
+    uint64_t settings_version;
+    bool has_origin;
+    double origin_lat, origin_lon; // Local plane origin (first fix used)
+    double cos_origin_lat;
+    std::vector<GeolocEmitter> emitters;
+    uint64_t frame_counter;
+};
+
+// Initialize state
+void init_geolocation(GeolocState& state);
+
+// Record a platform position fix (thread-safe; called by the GPS client or manual entry)
+// Args:
+//   timestamp_us: Host time of the fix on the pipeline clock (SampleBuffer::timestamp_us)
+//   course_deg: Course over ground (degrees true), NaN if unknown
+//   speed_mps: Ground speed, NaN if unknown
+//   manual: Fixed position (never goes stale, no course)
+void record_position_fix(uint64_t timestamp_us, double latitude, double longitude,
+                         double course_deg, double speed_mps, bool manual);
+
+// Feed the bearing tracks updated in this frame into the emitter fixes
+// Args:
+//   bearing_table: Bearing table after update_bearing_table for this frame
+//   timestamp_us: Frame timestamp (FFTBuffer::timestamp_us)
+//   center_freq: Current center frequency in Hz
+//   sample_rate: Current sample rate in Hz
+//   fft_size: FFT size (bin to frequency)
+void update_geolocation(GeolocState& state, const BearingTableState& bearing_table, uint64_t timestamp_us,
+                        uint64_t center_freq, uint32_t sample_rate, size_t fft_size);
+
+// Replace the settings (thread-safe, picked up on the next frame)
+// Returns false if an angle is out of range
+bool set_geolocation_settings(const GeolocSettings& settings);
+
+// Current settings
+GeolocSettings get_geolocation_settings();
+
+// Drop every emitter fix (thread-safe, applied on the next frame)
+void reset_geolocation();
+
+// Get the latest published fixes as JSON
+std::string get_geolocation_json();
+
+#endif // GEOLOCATION_H
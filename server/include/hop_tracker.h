@@ -0,0 +1,161 @@
+#ifndef HOP_TRACKER_H
+#define HOP_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "multires_stft.h"
+
+// Frequency-hopping (FHSS) emitter tracker
+// Links short-duration detections across frequency and time into hop sequences
+// and reports each hop sequence as a single emitter with dwell, hop rate and hop set.
+// Detections come from the 256-point STFT (one frame every 256 samples), so dwell
+// start/end are resolved to a few microseconds rather than to the main FFT frame rate.
+// All state is preallocated at init; per-hop work is O(1) via a channel-indexed
+// dwell table and a binned time index (no pairwise comparison between hops).
+
+// A single completed hop (one dwell on one channel)
+struct HopObservation {
+    uint64_t start_us;          // Dwell start timestamp (microseconds)
+    uint64_t end_us;            // Dwell end timestamp (microseconds)
+    float center_bin;           // Center FFT bin of the dwell
+    float bandwidth_bins;       // Occupied bandwidth in FFT bins
+    float power;                // Average magnitude (0-255 scale)
+};
+
+// Hop tracker tuning parameters
+struct HopTrackerParams {
+    uint64_t max_dwell_us;      // Detections longer than this are fixed carriers, not hops
+    uint64_t max_gap_us;        // Maximum silence between consecutive hops of one emitter
+    float bw_tolerance_bins;    // Bandwidth mismatch allowed when linking hops
+    uint32_t min_hops_to_report; // Hops required before an emitter is reported
+    uint64_t emitter_timeout_us; // Emitters with no hops for this long are retired
+};
+
+// Default parameters (STFT-frame detections, tolerant linking)
+constexpr HopTrackerParams DEFAULT_HOP_TRACKER = {
+    .max_dwell_us = 500000,
+    .max_gap_us = 200000,
+    .bw_tolerance_bins = 2.0f,
+    .min_hops_to_report = 4,
+    .emitter_timeout_us = 5000000
+};
+
+// Tracked hopping emitter
+struct HopEmitter {
+    uint32_t id;                // Stable emitter ID (0 = unused slot)
+    uint64_t first_seen_us;     // First hop start
+    uint64_t last_start_us;     // Start of most recent hop
+    uint64_t last_end_us;       // End of most recent hop
+    float last_center_bin;      // Channel of most recent hop
+    float bandwidth_bins;       // EWMA hop bandwidth (bins)
+    float dwell_us;             // EWMA dwell time (microseconds)
+    float hop_interval_us;      // EWMA start-to-start interval (microseconds)
+    float power;                // EWMA hop power (0-255 scale)
+    uint32_t hop_count;         // Hops linked to this emitter
+    uint32_t hop_set_size;      // Distinct channels visited
+    uint16_t min_cell;          // Lowest channel cell visited
+    uint16_t max_cell;          // Highest channel cell visited
+};
+
+// Snapshot entry published for the web interface
+struct HopEmitterReport {
+    uint32_t id;
+    uint32_t hop_count;
+    uint32_t hop_set_size;
+    float dwell_us;
+    float hop_rate_hz;
+    float bandwidth_hz;
+    float power;
+    double freq_min_hz;
+    double freq_max_hz;
+    uint64_t last_seen_us;
+    std::vector<float> hop_set_offsets_hz;  // Visited channels relative to center (Hz)
+};
+
+// In-progress dwell on one channel cell (merged across STFT frames)
+struct HopActiveDwell {
+    uint64_t start_us;
+    uint64_t last_seen_us;
+    uint64_t last_frame;
+    float center_sum;
+    float bandwidth_sum;
+    float power_sum;
+    uint32_t frames;
+    bool carrier;               // Exceeded max dwell - treat as fixed carrier
+};
+
+// Binned time index entry: emitters whose last hop ended in this time bin
+constexpr size_t HOP_TIME_BIN_SLOTS = 8;
+struct HopTimeBin {
+    uint64_t epoch;             // Absolute bin number (stale if it does not match)
+    uint8_t count;
+    uint16_t slots[HOP_TIME_BIN_SLOTS];
+};
+
+// Complete tracker state (owned by the analysis thread)
+struct HopTrackerState {
+    HopTrackerParams params;
+    size_t fft_size;
+    size_t cell_bins;                       // FFT bins per channel cell
+    std::vector<HopEmitter> emitters;       // Fixed-size emitter pool
+    std::vector<uint8_t> channel_hits;      // Per-emitter channel bitmap (emitters x cells)
+    std::vector<HopActiveDwell> active;     // Per-cell in-progress dwell table
+    std::vector<uint16_t> live_cells;       // Cells with an in-progress dwell
+    std::vector<HopTimeBin> time_index;     // Ring of time bins
+    uint64_t time_bin_us;                   // Width of one time bin
+    std::vector<float> noise_floor;         // Per-bin STFT floor (0-255 scale)
+    bool floor_initialized;
+    uint64_t frame_counter;                 // STFT frames seen
+    uint64_t block_counter;                 // STFT blocks seen
+    uint64_t last_frame_us;                 // Start of the most recent STFT frame
+    float frame_interval_us;                // STFT frame spacing
+    uint32_t next_id;
+    uint64_t hops_linked;                   // Statistics
+    uint64_t hops_dropped;
+};
+
+// Hop tracker capacity limits
+namespace HopTrackerConfig {
+    constexpr size_t MAX_EMITTERS = 64;         // Emitter pool size (LRU eviction)
+    constexpr size_t CHANNEL_CELLS = 1024;      // Channel resolution of the hop set
+    constexpr size_t TIME_BINS = 64;            // Time index ring length
+    constexpr size_t TIME_BINS_PER_GAP = 8;     // Time bins spanning max_gap_us
+    constexpr float EWMA_ALPHA = 0.2f;          // Smoothing for dwell / interval / bandwidth
+    constexpr size_t MAX_HOP_SET_REPORT = 128;  // Channels listed per emitter in reports
+    constexpr size_t STFT_SIZE = 256;           // Detection input resolution (see multires_stft.h)
+    constexpr float DETECT_THRESHOLD = 21.0f;   // Occupied bin: ~10 dB above its floor (0-255 = 120 dB)
+    constexpr float FLOOR_ALPHA = 0.002f;       // Floor tracking in quiet bins
+    constexpr float FLOOR_ALPHA_OCCUPIED = 0.00002f; // Slow drift in occupied bins (recovers from gain steps)
+    constexpr uint32_t PUBLISH_INTERVAL_BLOCKS = 5; // Publish report snapshot every N STFT blocks
+}
+
+// Initialize tracker state for a given FFT size
+void init_hop_tracker(HopTrackerState& state, size_t fft_size,
+                      const HopTrackerParams& params = DEFAULT_HOP_TRACKER);
+
+// Feed one block of STFT frames (register as a listener on the STFT_SIZE resolution)
+// Occupied bins of each frame are grouped into detections; detections persisting on the
+// same channel across frames are merged into one dwell, and dwells that end are linked
+// into emitters via add_hop_observation() with frame-accurate start/end times
+void update_hop_tracker(HopTrackerState& state, const StftBlock& block);
+
+// Link a single completed hop (from any detector with sub-frame timing)
+// Returns the emitter ID the hop was assigned to (0 if dropped)
+uint32_t add_hop_observation(HopTrackerState& state, const HopObservation& hop);
+
+// Build report entries for emitters that have enough hops
+// Args:
+//   center_freq: Current center frequency in Hz
+//   sample_rate: Current sample rate in Hz
+void get_hop_emitters(const HopTrackerState& state, uint64_t center_freq, uint32_t sample_rate,
+                      std::vector<HopEmitterReport>& out);
+
+// Publish a report snapshot for the web server (thread-safe)
+void publish_hop_emitters(const std::vector<HopEmitterReport>& reports);
+
+// Get the latest published snapshot as JSON
+std::string get_hop_emitters_json();
+
+#endif // HOP_TRACKER_H
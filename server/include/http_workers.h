@@ -0,0 +1,55 @@
+#ifndef HTTP_WORKERS_H
+#define HTTP_WORKERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// HTTP worker pool
+// The web server's event loop runs on one thread; anything slow in a handler (an IFFT, a
+// PNG encode, formatting a large JSON document) delays every other client. Handlers for such
+// endpoints submit a job instead and return at once. A worker runs the job, stores the reply
+// under the connection ID and calls the ready callback, which wakes the event loop
+// (mg_wakeup) to send it. The loop itself only parses requests and moves bytes.
+// A connection has at most one job in flight: mongoose does not parse a pipelined request
+// until the current reply is complete. Replies of connections that closed meanwhile are dropped.
+
+// HTTP worker configuration
+namespace HttpWorkerConfig {
+    constexpr unsigned MAX_WORKERS = 4;
+    constexpr size_t MAX_PENDING = 64;             // Jobs queued or running; more are refused (503)
+}
+
+// Reply produced by a job
+struct HttpJobResult {
+    int status = 200;
+    std::string headers;           // Header lines, each ending in "\r\n" (no Content-Length)
+    std::string body;              // May be binary
+};
+
+using HttpJob = std::function<void(HttpJobResult& result)>;
+
+// Called on the worker thread once a connection's reply is ready
+using HttpJobReadyFn = void (*)(unsigned long conn_id);
+
+// Start the workers (one per core beyond the first, up to MAX_WORKERS, at least one)
+void start_http_workers(HttpJobReadyFn on_ready);
+
+// Stop the workers; queued jobs are dropped
+void stop_http_workers();
+
+// Queue a job for a connection
+// Returns false if the queue is full or the connection already has a job
+bool submit_http_job(unsigned long conn_id, HttpJob job);
+
+// Take the finished reply of a connection, false if there is none (yet)
+bool take_http_result(unsigned long conn_id, HttpJobResult& result);
+
+// Forget a connection's job (connection closed); a running job's reply is discarded
+void cancel_http_job(unsigned long conn_id);
+
+// Replies finished and not yet taken (lets the event loop deliver them if a wakeup was lost)
+size_t ready_http_results();
+
+#endif // HTTP_WORKERS_H
@@ -6,6 +6,7 @@
 #include <cstring>
 #include <vector>
 #include <fftw3.h>
+#include "config.h"
 
 // Lock-free Single Producer Single Consumer (SPSC) ring buffer
 // Optimized for high-throughput, low-latency data transfer between threads
@@ -97,13 +98,16 @@ private:
 
 // Data structure for passing samples between pipeline stages
 struct SampleBuffer {
-    std::vector<int16_t> samples;  // Interleaved IQ samples (4 channels)
-    size_t count;                   // Number of IQ pairs (not total int16_t count)
+    std::vector<int16_t> samples;  // Interleaved IQ frames [I1,Q1,...,IN,QN] (channels per frame)
+    size_t count;                   // Number of sample frames (not total int16_t count)
+    size_t channels;                // Channels per frame
     uint64_t timestamp_us;          // Timestamp when samples were acquired
+    uint64_t sample_index;          // Index of first sample since acquisition start
 
-    SampleBuffer() : count(0), timestamp_us(0) {}
+    SampleBuffer() : count(0), channels(ChannelConfig::NUM_CHANNELS), timestamp_us(0), sample_index(0) {}
 
-    explicit SampleBuffer(size_t size) : samples(size), count(0), timestamp_us(0) {}
+    explicit SampleBuffer(size_t size)
+        : samples(size), count(0), channels(ChannelConfig::NUM_CHANNELS), timestamp_us(0), sample_index(0) {}
 };
 
 // Wrapper for fftwf_complex to make it copyable in vectors
@@ -128,22 +132,27 @@ struct ComplexSample {
 };
 
 // Data structure for passing FFT results between pipeline stages
+// Per-channel results are stored as planes: channel ch occupies [ch * size, (ch + 1) * size)
 struct FFTBuffer {
-    std::vector<uint8_t> ch1_mag;           // Channel 1 magnitude (0-255)
-    std::vector<uint8_t> ch2_mag;           // Channel 2 magnitude (0-255)
-    std::vector<ComplexSample> ch1_fft;     // Channel 1 complex FFT
-    std::vector<ComplexSample> ch2_fft;     // Channel 2 complex FFT
+    std::vector<uint8_t> mag;               // Magnitude planes (0-255)
+    std::vector<ComplexSample> fft;         // Complex FFT planes
+    size_t channels;                        // Channels in this frame
     size_t size;                            // FFT size
     uint64_t timestamp_us;                  // Processing timestamp
-    float noise_floor_ch1;                  // Noise floor estimate CH1
-    float noise_floor_ch2;                  // Noise floor estimate CH2
+    float noise_floor[ChannelConfig::MAX_CHANNELS];  // Noise floor estimate per channel
+    std::vector<uint8_t> beam_mag;          // Sum-beam magnitude when it replaces RX1/RX2 for CFAR (else empty)
+    float beam_noise_floor;                 // Sum-beam noise floor estimate
 
-    FFTBuffer() : size(0), timestamp_us(0), noise_floor_ch1(0.0f), noise_floor_ch2(0.0f) {}
+    FFTBuffer() : channels(0), size(0), timestamp_us(0), noise_floor{}, beam_noise_floor(0.0f) {}
 
-    explicit FFTBuffer(size_t fft_size)
-        : ch1_mag(fft_size), ch2_mag(fft_size),
-          ch1_fft(fft_size), ch2_fft(fft_size),
-          size(fft_size), timestamp_us(0), noise_floor_ch1(0.0f), noise_floor_ch2(0.0f) {}
+    FFTBuffer(size_t fft_size, size_t num_channels)
+        : mag(fft_size * num_channels), fft(fft_size * num_channels),
+          channels(num_channels), size(fft_size), timestamp_us(0), noise_floor{}, beam_noise_floor(0.0f) {}
+
+    uint8_t* channel_mag(size_t ch) { return mag.data() + ch * size; }
+    const uint8_t* channel_mag(size_t ch) const { return mag.data() + ch * size; }
+    ComplexSample* channel_fft(size_t ch) { return fft.data() + ch * size; }
+    const ComplexSample* channel_fft(size_t ch) const { return fft.data() + ch * size; }
 };
 
 #endif // LOCKFREE_QUEUE_H
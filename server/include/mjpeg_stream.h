@@ -0,0 +1,94 @@
+#ifndef MJPEG_STREAM_H
+#define MJPEG_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "waterfall_image.h"
+
+// Server-rendered MJPEG waterfall streams
+// A stream is the newest `height` rows of one channel, pooled to `width` bins (peak-preserving),
+// colormapped and JPEG-encoded at up to `fps` frames per second, newest row at the top. It is
+// served as multipart/x-mixed-replace, which browsers show in a plain <img> and video tools
+// open as a network stream, so a viewer needs no script at all. Viewers asking for the same
+// parameters share one registry entry: each frame is rendered and encoded once and the same
+// buffer, multipart part header included, is sent to every viewer, so encoding cost grows with
+// the number of distinct streams rather than with the number of viewers. Each entry keeps its
+// own ring of pooled rows, so a frame only pools the rows that arrived since the last one.
+// Frames follow the waterfall rows: when no rows arrive, no frames are sent. Pooling and
+// encoding run on a dedicated encoder thread; the web server only sends finished parts.
+
+// MJPEG stream configuration
+namespace MjpegConfig {
+    constexpr size_t MAX_STREAMS = 16;             // Distinct streams in the registry
+    constexpr uint32_t MIN_WIDTH = 64;
+    constexpr uint32_t MIN_HEIGHT = 16;
+    constexpr uint32_t DEFAULT_WIDTH = 1024;
+    constexpr uint32_t DEFAULT_HEIGHT = 256;
+    constexpr uint32_t MAX_FPS = 30;
+    constexpr uint32_t DEFAULT_FPS = 10;
+    constexpr int MIN_QUALITY = 10;
+    constexpr int MAX_QUALITY = 95;
+    constexpr int DEFAULT_QUALITY = 75;
+    constexpr const char* BOUNDARY = "waterfallframe";
+    constexpr uint32_t ENCODER_TICK_MS = 10;       // Encoder re-check interval while streams are open
+}
+
+// Stream parameters (what a viewer asks for)
+struct MjpegStreamParams {
+    int channel;               // 1 or 2
+    uint32_t width;            // Image width (bins pooled from the full row)
+    uint32_t height;           // Image height (rows of history shown)
+    Colormap colormap;
+    uint32_t fps;              // Frame rate limit
+    int quality;               // JPEG quality (1-100)
+};
+
+// Parameters of a stream nobody customized
+MjpegStreamParams default_mjpeg_params();
+
+// Validate the channel and clamp size, frame rate and quality to the supported ranges
+// Returns false if the parameters cannot describe a stream
+bool normalize_mjpeg_params(MjpegStreamParams& params);
+
+// Register one viewer of a (normalized) stream
+// Returns the stream ID, or -1 if the registry is full
+int open_mjpeg_stream(const MjpegStreamParams& params);
+
+// Drop one viewer (the stream is removed with its last viewer)
+void close_mjpeg_stream(int stream_id);
+
+// One encoded frame
+struct MjpegFrame {
+    std::shared_ptr<const std::vector<uint8_t>> part;  // Multipart part: boundary, headers, JPEG
+    uint64_t number;                                   // Frames encoded by the stream so far
+};
+
+// Called by the encoder thread after a pass that encoded at least one new frame
+using MjpegFrameReadyFn = void (*)();
+
+// Start the encoder thread
+// A pass renders every stream whose frame interval has passed and that has new rows: the new
+// rows are copied under the waterfall lock, then pooled, colormapped and JPEG-encoded without
+// any lock held
+void start_mjpeg_encoder(MjpegFrameReadyFn on_ready);
+
+// Stop the encoder thread (no-op if it never started)
+void stop_mjpeg_encoder();
+
+// New waterfall rows are available (wakes the encoder thread; cheap, safe from any thread)
+void notify_mjpeg_rows();
+
+// Newest encoded frame of a stream (never encodes)
+// Returns false if the stream does not exist or has no frame yet
+bool get_mjpeg_frame(int stream_id, MjpegFrame& frame);
+
+// Count a frame sent to a viewer, or skipped because the viewer's connection was backed up
+void record_mjpeg_send(int stream_id, size_t bytes, bool skipped);
+
+// Registered streams with viewer, encode and fan-out counts as JSON
+std::string get_mjpeg_streams_json();
+
+#endif // MJPEG_STREAM_H
@@ -0,0 +1,119 @@
+#ifndef MULTIRES_STFT_H
+#define MULTIRES_STFT_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "signal_processing.h"
+
+// Multi-resolution short-time Fourier transform
+// Computes additional FFT sizes (e.g. a 256-point burst spectrogram) from the same
+// deinterleaved sample block as the main 4096-point spectrum. Each resolution slices
+// the whole block into hop-spaced frames and transforms all frames of both channels
+// with a single batched FFTW plan (fftwf_plan_many_dft). A resolution is only computed
+// while something subscribes to it: a registered listener or a recently polling client.
+
+// Multi-resolution configuration
+namespace MultiResConfig {
+    constexpr size_t MAX_RESOLUTIONS = 4;
+    constexpr size_t HISTORY_ROWS = 256;             // Spectrogram rows kept per resolution for clients
+    constexpr uint64_t CLIENT_TIMEOUT_US = 2000000;  // Client subscription lapses after 2 s without a poll
+    constexpr size_t MAX_ROWS_PER_REQUEST = 256;
+}
+
+// One STFT resolution
+struct StftResolutionConfig {
+    size_t fft_size;            // Transform length (power of two, < main FFT size)
+    size_t hop;                 // Frame spacing in samples (fft_size = no overlap)
+};
+
+// Default resolutions alongside the main FFT: 256-point bursts, 1024-point intermediate
+constexpr StftResolutionConfig DEFAULT_STFT_RESOLUTIONS[] = {
+    {.fft_size = 256, .hop = 256},
+    {.fft_size = 1024, .hop = 512}
+};
+constexpr size_t NUM_DEFAULT_STFT_RESOLUTIONS = sizeof(DEFAULT_STFT_RESOLUTIONS) / sizeof(DEFAULT_STFT_RESOLUTIONS[0]);
+
+// One buffer worth of STFT frames handed to listeners (valid only during the callback)
+struct StftBlock {
+    size_t fft_size;
+    size_t hop;
+    size_t frames;                  // Rows in this block
+    const uint8_t* ch1_mag;         // frames x fft_size magnitudes (0-255 dB scale)
+    const uint8_t* ch2_mag;
+    const fftwf_complex* ch1_fft;   // frames x fft_size complex spectra
+    const fftwf_complex* ch2_fft;
+    uint64_t first_sample;          // Sample index of the first sample of frame 0
+    uint64_t timestamp_us;          // Host timestamp of the buffer
+    uint32_t sample_rate;
+};
+
+// Detector callback (runs on the processing thread - keep it short)
+using StftListener = std::function<void(const StftBlock&)>;
+
+// Per-resolution processing state (owned by the processing thread)
+struct StftResolution {
+    size_t fft_size;
+    size_t hop;
+    size_t max_frames;                  // Frames per channel the batched plan was built for
+    std::vector<float> window;
+    fftwf_complex* batch_in;            // [ch1 frames | ch2 frames], each max_frames x fft_size
+    fftwf_complex* batch_out;
+    fftwf_plan plan;                    // One plan for all frames of both channels
+    std::vector<uint8_t> mag;           // Magnitudes, same layout as batch_out
+    std::vector<StftListener> listeners;
+    size_t history_slot;                // Index of the published client history
+};
+
+// Multi-resolution state
+struct MultiResState {
+    std::vector<StftResolution> resolutions;
+    uint64_t frames_computed;
+};
+
+// Initialize resolutions and create their batched plans (call before the pipeline starts)
+// Args:
+//   max_samples: Largest block (per-channel samples) that will be processed
+//   window_type: Window function for every resolution (WINDOW_* constant)
+//   configs, num_configs: Resolutions to compute (at most MAX_RESOLUTIONS)
+void init_multires_stft(MultiResState& state, size_t max_samples, uint32_t window_type,
+                        const StftResolutionConfig* configs = DEFAULT_STFT_RESOLUTIONS,
+                        size_t num_configs = NUM_DEFAULT_STFT_RESOLUTIONS);
+
+// Destroy plans and free buffers
+void destroy_multires_stft(MultiResState& state);
+
+// Subscribe a detector to one resolution (call before the pipeline starts)
+// Returns false if no resolution of that size is configured
+bool add_stft_listener(MultiResState& state, size_t fft_size, StftListener listener);
+
+// Compute every subscribed resolution from a deinterleaved block
+// Args:
+//   front_end: Block shared with the main FFT (see deinterleave_iq)
+//   dc_state: DC estimate already updated by the main FFT for this block
+//   first_sample: Sample index of the first sample in the block
+//   timestamp_us: Host timestamp of the block
+//   sample_rate: Current sample rate in Hz
+// Returns: Number of resolutions computed
+size_t process_multires_stft(MultiResState& state, const IQFrontEnd& front_end,
+                             const DCOffsetState& dc_state, uint64_t first_sample,
+                             uint64_t timestamp_us, uint32_t sample_rate);
+
+// Copy published spectrogram rows for a client and renew its subscription (thread-safe)
+// Args:
+//   fft_size: Requested resolution
+//   channel: 1 or 2
+//   since_sequence: Only rows with a sequence number above this are returned
+//   out: Output - rows x fft_size bytes, oldest first
+//   last_sequence: Output - sequence number of the newest row returned
+// Returns false if the resolution is not configured
+bool get_stft_rows(size_t fft_size, int channel, uint64_t since_sequence, std::vector<uint8_t>& out,
+                   uint64_t& last_sequence);
+
+// Get configured resolutions as JSON
+std::string get_stft_resolutions_json();
+
+#endif // MULTIRES_STFT_H
@@ -4,6 +4,9 @@
 #include "lockfree_queue.h"
 #include "bladerf_sensor.h"
 #include "signal_processing.h"
+#include "pulse_detector.h"
+#include "multires_stft.h"
+#include "gcc_phat.h"
 #include <atomic>
 #include <mutex>
 #include <thread>
@@ -13,6 +16,7 @@
 namespace PipelineConfig {
     constexpr size_t SAMPLE_QUEUE_SIZE = 8;     // Samples between acquisition and processing
     constexpr size_t FFT_QUEUE_SIZE = 8;        // FFT results between processing and analysis
+    constexpr size_t SAMPLES_PER_BUFFER = 16384; // Sample frames per bladerf_sync_rx call
 }
 
 // Pipeline state and statistics
@@ -57,14 +61,18 @@ struct PipelineContext {
     OverlapState overlap;
     NoiseFloorState noise_floor;            // Noise floor estimation (local)
     NoiseFloorState* global_noise_floor;    // Global noise floor (for web server reporting)
+    PulseDetectorState pulse_detector;      // Full-rate time-domain pulse detector
+    IQFrontEnd front_end;                   // Deinterleaved block shared by all FFT sizes
+    MultiResState multires;                 // Additional STFT resolutions (batched)
     std::vector<float> window;
-    fftwf_plan fft_plan_ch1;
-    fftwf_plan fft_plan_ch2;
-    fftwf_complex* fft_in_ch1;      // Raw pointers since fftwf_complex is float[2]
-    fftwf_complex* fft_in_ch2;
-    fftwf_complex* fft_out_ch1;
-    fftwf_complex* fft_out_ch2;
+    size_t num_channels;                    // Coherent receive channels
+    std::vector<fftwf_plan> fft_plans;      // One plan per channel (fft_in[ch] -> fft_out[ch])
+    std::vector<fftwf_complex*> fft_in;     // Raw pointers since fftwf_complex is float[2]
+    std::vector<fftwf_complex*> fft_out;
     size_t fft_size;                // Size of FFT buffers
+
+    // Analysis state with FFTW plans (created on the main thread, owned by analysis thread)
+    GccPhatState gcc_phat;                  // Inter-channel delay / skew estimator
 };
 
 // Stage 1: Sample Acquisition Thread
@@ -0,0 +1,93 @@
+#ifndef PULSE_DETECTOR_H
+#define PULSE_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Time-domain burst/pulse detector
+// Runs an envelope (I^2 + Q^2) energy detector on the raw interleaved SC16 samples of
+// both channels at the full sample rate. Power is computed with packed int16
+// multiply-add (SSE2) directly on the [I1,Q1,I2,Q2] layout, so one instruction yields
+// ch1 and ch2 power for two samples. Quiet blocks are rejected with a vector compare;
+// the per-sample state machine only runs on blocks containing threshold crossings.
+
+// Pulse detector configuration
+namespace PulseConfig {
+    constexpr size_t BLOCK_SAMPLES = 64;            // Samples per vector block (per channel)
+    constexpr float HIGH_THRESHOLD_FACTOR = 10.0f;  // Pulse start: 10 dB above noise power
+    constexpr float LOW_THRESHOLD_FACTOR = 3.16f;   // Pulse end: 5 dB above noise (hysteresis)
+    constexpr uint32_t HANGOVER_SAMPLES = 4;        // Samples below low threshold to end pulse
+    constexpr uint32_t MIN_PULSE_SAMPLES = 4;       // Shorter pulses are rejected as noise (100 ns)
+    constexpr uint32_t MAX_PULSE_SAMPLES = 400000;  // Longer "pulses" are CW (10 ms at 40 MSps)
+    constexpr float NOISE_ALPHA = 0.01f;            // EWMA for noise power in quiet blocks
+    constexpr float PRI_TOLERANCE = 0.05f;          // Relative PRI jitter accepted as stable
+    constexpr size_t HISTORY_SIZE = 256;            // Pulses kept for the web interface
+    constexpr int NUM_CHANNELS = 2;
+}
+
+// Single detected pulse
+struct PulseDescriptor {
+    uint8_t channel;            // 0 = RX1, 1 = RX2
+    uint64_t start_sample;      // Sample-accurate start index (since acquisition start)
+    uint64_t timestamp_us;      // Start time (host clock, microseconds)
+    uint32_t width_samples;     // Pulse width in samples
+    float width_us;             // Pulse width in microseconds
+    float peak_amplitude;       // Peak envelope amplitude (ADC counts)
+    float mean_power_db;        // Mean pulse power relative to noise (dB)
+    float pri_us;               // Interval from previous pulse start on this channel (0 = first)
+};
+
+// Per-channel detector state (persists across buffers so pulses may span them)
+struct PulseChannelState {
+    float noise_power;          // EWMA noise power (ADC counts^2)
+    bool noise_initialized;
+    bool in_pulse;
+    uint64_t pulse_start;       // Start sample index of current pulse
+    uint32_t below_count;       // Consecutive samples below low threshold
+    int32_t peak_power;
+    double energy;              // Sum of power over current pulse
+    uint64_t last_pulse_start;  // For PRI
+    float pri_estimate_us;      // Stable PRI estimate (0 = none)
+    uint32_t pri_stable_count;  // Consecutive pulses matching the estimate
+};
+
+// Pulse detector state (owned by the processing thread)
+struct PulseDetectorState {
+    PulseChannelState channels[PulseConfig::NUM_CHANNELS];
+    std::vector<int32_t> block_power;   // Scratch for one block of interleaved powers
+    uint64_t pulses_detected;
+    uint64_t samples_processed;
+};
+
+// Per-channel summary published for the web interface
+struct PulseReport {
+    float pri_estimate_us[PulseConfig::NUM_CHANNELS];
+    float noise_power_db[PulseConfig::NUM_CHANNELS];
+    uint64_t pulses_detected;
+};
+
+// Initialize pulse detector state
+void init_pulse_detector(PulseDetectorState& state);
+
+// Run the detector over one buffer of interleaved SC16 samples
+// Args:
+//   iq_buffer: Interleaved sample frames [I1,Q1,I2,Q2,...] (BLADERF_RX_X2 layout for 2 channels)
+//   count: Number of sample frames (per-channel samples) in buffer
+//   channels: Channels per frame (only the first two are monitored)
+//   first_sample: Sample index of the first frame in buffer
+//   timestamp_us: Host timestamp of the first frame
+//   sample_rate: Current sample rate in Hz
+//   pulses: Output - pulses that ended in this buffer are appended
+void detect_pulses(PulseDetectorState& state, const int16_t* iq_buffer, size_t count, size_t channels,
+                   uint64_t first_sample, uint64_t timestamp_us, uint32_t sample_rate,
+                   std::vector<PulseDescriptor>& pulses);
+
+// Append new pulses to the published history (thread-safe)
+void publish_pulses(const PulseDetectorState& state, const std::vector<PulseDescriptor>& pulses);
+
+// Get the latest published pulse history as JSON
+std::string get_pulses_json();
+
+#endif // PULSE_DETECTOR_H
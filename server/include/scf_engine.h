@@ -0,0 +1,78 @@
+#ifndef SCF_ENGINE_H
+#define SCF_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "signal_processing.h"
+
+// Cyclostationary analysis: spectral correlation function (SCF) via the FFT
+// accumulation method (FAM), computed on demand for a selected sub-band.
+// A job captures contiguous samples through a tap in the processing thread, then a
+// background worker downconverts/decimates the sub-band, channelizes it with one batched
+// FFT, and splits the channel-pair products across worker threads, each running
+// batched second-stage FFTs with the shared precomputed plan. Results are reported as
+// spectral coherence (|S^a(f)| normalized by the PSD) so features are comparable across
+// signal levels; peaks in the cyclic-frequency profile reveal symbol rates and carriers.
+
+// SCF engine configuration
+namespace ScfConfig {
+    constexpr int CHANNEL_FFT = 64;                 // Channelizer FFT size (N')
+    constexpr int HOP = CHANNEL_FFT / 4;            // Channelizer hop (L = N'/4)
+    constexpr int BLOCKS = 256;                     // Channelizer frames / second FFT size (P)
+    constexpr size_t DECIMATED_SAMPLES = (BLOCKS - 1) * HOP + CHANNEL_FFT;
+    constexpr size_t MAX_CAPTURE_SAMPLES = 1 << 20; // Raw samples per job (limits decimation)
+    constexpr int TAPS_PER_PHASE = 8;               // Decimating FIR length = TAPS_PER_PHASE * D + 1
+    constexpr int ALPHA_BINS = 256;                 // Cyclic-frequency columns in the SCF map
+    constexpr int FREQ_BINS = CHANNEL_FFT;          // Spectral-frequency rows in the SCF map
+    constexpr int ALPHA_GUARD = 8;                  // Profile bins around alpha = 0 ignored (PSD line)
+    constexpr size_t MAX_FEATURES = 10;             // Cyclic features reported per job
+    constexpr size_t NOISE_PERCENTILE = 99;         // Profile percentile taken as the noise peak level
+    constexpr float FEATURE_THRESHOLD = 1.25f;      // Feature must exceed the noise peak level by 25%
+    constexpr unsigned MAX_THREADS = 8;
+    constexpr int WORKER_NICE = 10;                 // Keep SCF workers below the real-time threads
+}
+
+// Job request
+struct ScfRequest {
+    int channel;                // 1 or 2
+    double offset_hz;           // Sub-band center relative to the tuned frequency
+    double bandwidth_hz;        // Sub-band width (sets the decimation factor)
+};
+
+// Detected cyclic feature
+struct ScfFeature {
+    double alpha_hz;            // Cyclic frequency (symbol rate, chip rate, ...)
+    double freq_hz;             // Spectral frequency of the strongest support (absolute)
+    float coherence;            // Peak spectral coherence (0-1)
+};
+
+// Start the SCF worker and create its FFT plans (call before the pipeline starts)
+void start_scf_engine();
+
+// Stop the SCF worker and free plans and buffers
+void stop_scf_engine();
+
+// Queue a job; fails if one is already capturing or running
+// Args:
+//   request: Sub-band and channel
+//   center_freq, sample_rate: Current tuning (used for decimation and reporting)
+//   error: Output - reason for rejection
+bool submit_scf_job(const ScfRequest& request, uint64_t center_freq, uint32_t sample_rate,
+                    std::string& error);
+
+// Capture tap for the processing thread (no-op unless a job is waiting for samples)
+// Args:
+//   front_end: Deinterleaved block
+//   first_sample: Sample index of the first sample in the block (gaps restart the capture)
+void scf_capture_tap(const IQFrontEnd& front_end, uint64_t first_sample);
+
+// Get job state and the features of the last completed job as JSON
+std::string get_scf_status_json();
+
+// Get the coherence map of the last completed job (FREQ_BINS x ALPHA_BINS, 0-255)
+// Returns false if no job has completed
+bool get_scf_map(std::vector<uint8_t>& out);
+
+#endif // SCF_ENGINE_H
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <vector>
+#include "config.h"
 
 // Window function types
 constexpr uint32_t WINDOW_RECTANGULAR = 0;
@@ -31,6 +32,17 @@ void compute_magnitude_db(fftwf_complex *fft_out, uint8_t *mag_out, size_t size)
 // Remove DC offset spike at center frequency bin
 void remove_dc_offset(uint8_t *magnitude, size_t size);
 
+// Spectrum decimation modes (display-width rows)
+constexpr uint32_t DECIMATE_MAX = 0;           // Peak-preserving: each output bin is the max of its input bins
+constexpr uint32_t DECIMATE_MEAN = 1;          // Average of the input bins (smoother noise floor)
+
+// Reduce bins [start_bin, end_bin] of a magnitude row to out_width output bins
+// Output bin i covers input bins [start + floor(i*span/out_width), start + floor((i+1)*span/out_width)),
+// so every input bin lands in exactly one output bin and a one-bin signal survives MAX pooling.
+// out_width must not exceed the span (no upsampling); out_width == span copies the range.
+void decimate_spectrum(const uint8_t* mag, size_t start_bin, size_t end_bin,
+                       uint8_t* out, size_t out_width, uint32_t mode);
+
 // Compute cross-correlation between two FFT outputs
 void compute_cross_correlation(fftwf_complex *fft_ch1, fftwf_complex *fft_ch2,
                               float *correlation, float *phase_diff, size_t size);
@@ -58,10 +70,9 @@ struct AGCState {
 
 // Noise floor estimation state
 struct NoiseFloorState {
-    float noise_floor_ch1;         // Current noise floor estimate for CH1 (0-255 scale)
-    float noise_floor_ch2;         // Current noise floor estimate for CH2 (0-255 scale)
-    float smoothed_floor_ch1;      // Smoothed noise floor for CH1 (temporal filtering)
-    float smoothed_floor_ch2;      // Smoothed noise floor for CH2 (temporal filtering)
+    size_t channels;                                    // Channels estimated
+    float noise_floor[ChannelConfig::MAX_CHANNELS];     // Current noise floor estimate per channel (0-255 scale)
+    float smoothed_floor[ChannelConfig::MAX_CHANNELS];  // Smoothed noise floor per channel (temporal filtering)
     std::vector<uint8_t> sorted_buffer; // Temporary buffer for percentile calculation
     int update_counter;            // Counter for periodic updates
     bool initialized;              // Flag indicating if noise floor has been initialized
@@ -69,20 +80,17 @@ struct NoiseFloorState {
 
 // DC offset correction state (EWMA-based)
 struct DCOffsetState {
-    float dc_i_ch1;                // Channel 1 I component DC offset
-    float dc_q_ch1;                // Channel 1 Q component DC offset
-    float dc_i_ch2;                // Channel 2 I component DC offset
-    float dc_q_ch2;                // Channel 2 Q component DC offset
+    float dc_i[ChannelConfig::MAX_CHANNELS];  // Per-channel I component DC offset
+    float dc_q[ChannelConfig::MAX_CHANNELS];  // Per-channel Q component DC offset
     uint64_t last_freq;            // Last frequency (for reset detection)
     int convergence_counter;       // Convergence tracking counter
 };
 
 // Overlap-add state for smoother spectrum
 struct OverlapState {
-    std::vector<float> overlap_buf_ch1;          // Channel 1 overlap buffer (interleaved I/Q pairs)
-    std::vector<float> overlap_buf_ch2;          // Channel 2 overlap buffer (interleaved I/Q pairs)
-    std::vector<uint8_t> prev_magnitude_ch1;     // Previous magnitude for averaging
-    std::vector<uint8_t> prev_magnitude_ch2;     // Previous magnitude for averaging
+    size_t channels;
+    std::vector<float> overlap_buf;              // Per-channel overlap planes (fft_size/2 interleaved I/Q pairs each)
+    std::vector<uint8_t> prev_magnitude;         // Per-channel previous magnitude planes for averaging
     bool has_prev_fft;                           // Flag indicating if previous FFT exists
 };
 
@@ -92,6 +100,18 @@ struct IQProcessingResult {
     bool freq_changed;             // True if frequency changed (triggers resets)
 };
 
+// Deinterleaved IQ block shared by every FFT resolution of a buffer
+struct IQFrontEnd {
+    std::vector<float> samples;    // One plane per channel (interleaved I/Q pairs, scaled to +/-1)
+    size_t capacity = 0;           // Samples per channel plane
+    size_t channels = 0;
+    size_t count = 0;              // Valid samples per channel
+    int16_t peak_sample = 0;       // Peak absolute ADC sample value (channel 1)
+
+    const float* channel(size_t ch) const { return samples.data() + ch * capacity * 2; }
+    float* channel(size_t ch) { return samples.data() + ch * capacity * 2; }
+};
+
 // Initialize AGC state
 void init_agc(AGCState& agc, uint32_t initial_gain_rx1, uint32_t initial_gain_rx2);
 
@@ -106,58 +126,71 @@ void update_agc(AGCState& agc, const uint8_t* ch1_mag, const uint8_t* ch2_mag, s
                 uint32_t& gain_rx1, uint32_t& gain_rx2, bool& params_changed);
 
 // Initialize noise floor estimation state
-void init_noise_floor(NoiseFloorState& nf, size_t fft_size);
+void init_noise_floor(NoiseFloorState& nf, size_t fft_size, size_t channels = ChannelConfig::NUM_CHANNELS);
 
 // Update noise floor estimate using percentile method
 // Args:
 //   nf: Noise floor state structure
-//   ch1_mag, ch2_mag: Magnitude arrays (0-255 scale)
+//   mag: Per-channel magnitude planes (nf.channels x len, 0-255 scale)
 //   len: Array length
 //   percentile: Percentile to use for noise floor (typical: 10-25)
 //   alpha: Smoothing factor for temporal filtering (0-1, typical: 0.05-0.2)
-void update_noise_floor(NoiseFloorState& nf, const uint8_t* ch1_mag, const uint8_t* ch2_mag,
-                       size_t len, float percentile = 15.0f, float alpha = 0.1f);
+void update_noise_floor(NoiseFloorState& nf, const uint8_t* mag, size_t len,
+                       float percentile = 15.0f, float alpha = 0.1f);
 
 // Get current noise floor estimates
 // Returns: pair of (ch1_floor, ch2_floor) in 0-255 scale
 void get_noise_floor(const NoiseFloorState& nf, float& ch1_floor, float& ch2_floor);
 
+// Get the current noise floor estimate of one channel (0-255 scale)
+float get_channel_noise_floor(const NoiseFloorState& nf, size_t channel);
+
 // Initialize DC offset state
 void init_dc_offset(DCOffsetState& dc);
 
 // Initialize overlap-add state
-void init_overlap(OverlapState& overlap, size_t fft_size);
+void init_overlap(OverlapState& overlap, size_t fft_size, size_t channels = ChannelConfig::NUM_CHANNELS);
 
-// Process IQ samples through complete pipeline: deinterleave, DC removal, window, FFT, magnitude
+// Deinterleave a whole buffer once so several FFT sizes can share the front end
+// Fixed-stride kernels are used for 1, 2, 4 and 8 channels, a generic loop otherwise.
 // Args:
-//   iq_buffer: Interleaved IQ samples [I1,Q1,I2,Q2,I3,Q3,I4,Q4,...] (4 channels)
-//   buffer_size: Number of IQ sample pairs in buffer (not total int16_t count)
+//   iq_buffer: Interleaved IQ frames [I1,Q1,I2,Q2,...] (channels per frame)
+//   buffer_size: Number of sample frames (per-channel samples) in buffer
+//   channels: Channels per frame
+//   front_end: Output - scaled per-channel planes (grown on demand, reused across calls)
+void deinterleave_iq(const int16_t* iq_buffer, size_t buffer_size, size_t channels, IQFrontEnd& front_end);
+
+// Complete FFT path on a deinterleaved front end: DC removal, window, FFT, magnitude
+// The first fft_size/2 samples of the block feed the overlapped (50%) FFT. dc_state
+// is updated once per block and may be reused by other resolutions.
+// With ChannelConfig::PARALLEL_MIN_CHANNELS or more channels, the per-channel work
+// runs on a small persistent worker pool.
+// Args:
+//   front_end: Block from deinterleave_iq (channels limited to overlap_state.channels)
 //   fft_size: Size of FFT
 //   current_freq: Current center frequency (for DC offset reset detection)
-//   fft_in_ch1, fft_in_ch2: FFT input buffers (will be filled)
-//   fft_out_ch1, fft_out_ch2: FFT output buffers (will be filled)
-//   ch1_mag, ch2_mag: Output magnitude arrays (0-255 scale)
+//   fft_in: Per-channel FFT input buffers (will be filled)
+//   fft_out: Per-channel FFT output buffers (will be filled)
+//   mag: Output per-channel magnitude planes (channels x fft_size, 0-255 scale)
 //   dc_state: DC offset correction state
 //   overlap_state: Overlap-add state
 //   window: Window function coefficients
-//   plan_ch1, plan_ch2: FFTW plans for both channels
+//   plans: Per-channel FFTW plans (fft_in[ch] -> fft_out[ch])
 // Returns: IQProcessingResult with peak sample and frequency change flag
-IQProcessingResult process_iq_to_fft(
-    const int16_t* iq_buffer,
-    size_t buffer_size,
+IQProcessingResult process_frontend_to_fft(
+    const IQFrontEnd& front_end,
     size_t fft_size,
     uint64_t current_freq,
-    fftwf_complex* fft_in_ch1,
-    fftwf_complex* fft_in_ch2,
-    fftwf_complex* fft_out_ch1,
-    fftwf_complex* fft_out_ch2,
-    uint8_t* ch1_mag,
-    uint8_t* ch2_mag,
+    fftwf_complex* const* fft_in,
+    fftwf_complex* const* fft_out,
+    uint8_t* mag,
     DCOffsetState& dc_state,
     OverlapState& overlap_state,
     const std::vector<float>& window,
-    fftwf_plan plan_ch1,
-    fftwf_plan plan_ch2
+    const fftwf_plan* plans
 );
 
+// Stop the per-channel worker pool (no-op if it never started)
+void stop_channel_workers();
+
 #endif // SIGNAL_PROCESSING_H
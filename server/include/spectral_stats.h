@@ -0,0 +1,91 @@
+#ifndef SPECTRAL_STATS_H
+#define SPECTRAL_STATS_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cfar_detector.h"
+
+// Per-bin spectral kurtosis (SK) and temporal spectral flatness
+// Running sums of P, P^2 and log2(P) are accumulated per bin for M frames, then
+// turned into statistics and reset - O(N) per frame, no frame history is stored.
+//   SK = (M+1)/(M-1) * (M * sum(P^2) / sum(P)^2 - 1)
+// is 1 for Gaussian noise (std ~ 2/sqrt(M)), tends to 0 for constant-envelope
+// modulation and rises above 1 for intermittent signals. Flatness (geometric / arithmetic
+// mean of P over the block) is ~0.56 for noise and approaches 1 for steady carriers.
+
+// Spectral statistics configuration
+namespace SpectralStatsConfig {
+    constexpr uint32_t DEFAULT_M_FRAMES = 64;       // Frames per SK estimate
+    constexpr size_t DC_EXCLUSION_BINS = 2;         // Bins either side of center skipped by detection
+    constexpr float SK_TRACE_SCALE = 64.0f;         // SK 0..4 -> 0..255 in the display trace
+    constexpr float FLATNESS_TRACE_SCALE = 255.0f;  // Flatness 0..1 -> 0..255
+    constexpr int NUM_CHANNELS = 2;
+}
+
+// SK detection parameters
+struct SKDetectorParams {
+    float sigma;            // Deviation from 1 (in SK standard deviations) to flag a bin
+    size_t min_signal_bins; // Minimum contiguous flagged bins for a valid signal
+};
+
+// Default SK detection (3 sigma, three-bin minimum: windowed neighbours are correlated)
+constexpr SKDetectorParams DEFAULT_SK_DETECTOR = {
+    .sigma = 3.0f,
+    .min_signal_bins = 3
+};
+
+// Spectral statistics state (owned by the analysis thread)
+struct SpectralStatsState {
+    size_t fft_size;
+    uint32_t m_frames;                  // Frames per block
+    uint32_t frames;                    // Frames accumulated in the current block
+    uint64_t last_freq;                 // Accumulators reset on retune
+    uint64_t blocks_completed;
+
+    // Running accumulators (per channel, per bin)
+    std::vector<float> sum_p[SpectralStatsConfig::NUM_CHANNELS];
+    std::vector<float> sum_p2[SpectralStatsConfig::NUM_CHANNELS];
+    std::vector<float> sum_log2p[SpectralStatsConfig::NUM_CHANNELS];
+
+    // Results of the last completed block
+    std::vector<float> kurtosis[SpectralStatsConfig::NUM_CHANNELS];
+    std::vector<float> flatness[SpectralStatsConfig::NUM_CHANNELS];
+    std::vector<float> mean_power[SpectralStatsConfig::NUM_CHANNELS];
+    float band_flatness[SpectralStatsConfig::NUM_CHANNELS];   // Wiener entropy of the mean spectrum
+};
+
+// Initialize state for a given FFT size and block length M
+void init_spectral_stats(SpectralStatsState& state, size_t fft_size,
+                         uint32_t m_frames = SpectralStatsConfig::DEFAULT_M_FRAMES);
+
+// Accumulate one frame of complex spectra
+// Args:
+//   fft_ch1, fft_ch2: Complex FFT output (fft_size bins each)
+//   center_freq: Current center frequency (accumulators reset when it changes)
+// Returns: true when a block of M frames completed and the statistics were refreshed
+bool update_spectral_stats(SpectralStatsState& state, const fftwf_complex* fft_ch1,
+                           const fftwf_complex* fft_ch2, uint64_t center_freq);
+
+// Detect bins whose SK deviates from the Gaussian value on both channels combined
+// Returns regions in the same form as the CFAR detectors (power fields in dB)
+std::vector<SignalRegion> detect_signals_sk(const SpectralStatsState& state, const SKDetectorParams& params,
+                                            size_t bin_start, size_t bin_end);
+
+// Publish traces and detections for the web server (thread-safe)
+void publish_spectral_stats(const SpectralStatsState& state, const std::vector<SignalRegion>& regions,
+                            uint64_t center_freq, uint32_t sample_rate);
+
+// Get a quantized trace (0-255) of the last published block
+// Args:
+//   channel: 1 or 2
+//   flatness: false for SK, true for flatness
+// Returns false if nothing has been published yet
+bool get_spectral_trace(int channel, bool flatness, std::vector<uint8_t>& out);
+
+// Get summary and SK detections as JSON
+std::string get_spectral_stats_json();
+
+#endif // SPECTRAL_STATS_H
@@ -0,0 +1,68 @@
+#ifndef SPECTRUM_CODEC_H
+#define SPECTRUM_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lossless codecs for 8-bit spectrum rows
+// A codec turns one row set of a spectrum view (channels * width uint8 magnitudes) into a
+// frame payload, optionally against the view's previous row (temporal delta). Codecs that use
+// the previous row also have a keyframe form that does not. Each codec has a wire ID (the
+// frame header's encoding byte) and a name clients use to ask for it.
+//
+// delta-bitpack, built for slowly varying uint8 spectra:
+//   1. residual r[i] = row[i] - reference[i] (mod 256); keyframes use row[i] - row[i - 1]
+//   2. zigzag: r as int8 -> 0, -1, 1, -2, ... map to 0, 1, 2, 3, ...
+//   3. residuals in blocks of 32, each packed at the bit width of its largest value (0-8)
+//      Per pair of blocks: one byte with both widths (low nibble first), then each block as
+//      four groups of 8 values packed LSB-first into `width` bytes. The last pair is zero-padded.
+// A flat noise floor jitters by a few counts row to row, so most blocks pack at 3-5 bits per
+// bin; a block of unchanged bins costs nothing but its nibble. Decoding is a shift and a mask
+// per value, cheap enough for the browser's main thread.
+//
+// delta-rans, the same zigzag residuals entropy-coded, for links where bytes matter more:
+//   u8 symbols - 1, then the frequency of each code 0..symbols-1 as a LEB128 varint (they sum
+//   to 4096), then the two final rANS states (u32 each) and the renormalization bytes, read
+//   forwards. Code i is decoded with state x = states[i % 2]: slot = x & 4095, s = symbol of
+//   slot, x = freq[s] * (x >> 12) + slot - start[s], then while x < 2^23: x = (x << 8) | next
+//   byte. The states stay below 2^31, so the decoder runs on plain JS integers.
+// Residual noise is close to geometric, so rANS gets within a few percent of its entropy,
+// roughly a bit per bin below bit-packing.
+
+// Frame encodings
+enum class StreamEncoding : uint8_t {
+    RAW = 0,                   // uint8 magnitudes
+    DELTA_DEFLATE = 1,         // zlib stream of the temporal delta (keyframes: of the row)
+    DELTA_BITPACK = 2,         // Zigzag residuals, bit-packed per 32-bin block (see above)
+    DELTA_RANS = 3             // Zigzag residuals, rANS-coded with a per-frame model (see above)
+};
+
+// Append the encoded payload of one row set to out
+// Args:
+//   row: Row set to encode (size bytes)
+//   reference: Previous row set of the view, nullptr for a keyframe (ignored by RAW)
+// Returns false on failure
+using SpectrumEncodeFn = bool (*)(const uint8_t* row, const uint8_t* reference, size_t size,
+                                  std::vector<uint8_t>& out);
+
+// Decode one payload into row (size bytes)
+// Args:
+//   reference: Previous decoded row set, nullptr for a keyframe
+// Returns false if the payload is malformed
+using SpectrumDecodeFn = bool (*)(const uint8_t* data, size_t data_size, const uint8_t* reference,
+                                  uint8_t* row, size_t size);
+
+struct SpectrumCodec {
+    StreamEncoding encoding;
+    const char* name;          // Name in subscriptions ("raw", "delta-deflate", "delta-bitpack")
+    bool uses_reference;       // Frames depend on the previous row (keyframes needed)
+    SpectrumEncodeFn encode;
+    SpectrumDecodeFn decode;
+};
+
+// Codec for a wire ID or name, nullptr if unknown
+const SpectrumCodec* find_spectrum_codec(StreamEncoding encoding);
+const SpectrumCodec* find_spectrum_codec(const char* name);
+
+#endif // SPECTRUM_CODEC_H
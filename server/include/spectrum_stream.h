@@ -0,0 +1,89 @@
+#ifndef SPECTRUM_STREAM_H
+#define SPECTRUM_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "spectrum_codec.h"
+
+// Spectrum view subscriptions
+// A view is a derived form of the waterfall rows: which channels, which bin range (zoom),
+// how many output bins and how they are pooled, which rows (every Nth) and how the bytes
+// are encoded. Clients that ask for the same parameters share one registry entry, and each
+// (view, row) frame is encoded once and handed out as the same immutable buffer to every
+// subscriber, so the cost grows with the number of distinct views rather than with the
+// number of clients.
+//
+// Frame layout (little-endian):
+//   u64 sequence, u32 width, u16 channels, u8 encoding, u8 flags, then the payload
+// The payload is the view's row set (one row per channel) in the view's codec
+// (spectrum_codec.h). Delta codecs encode against the view's previous row (row
+// `sequence - every`), or without it for keyframes (flags bit 0). A view keeps the decimated
+// previous row as its delta reference, so each row is still encoded once; a subscriber that
+// did not receive the previous row (just subscribed, or skipped rows while backed up) gets
+// the keyframe variant.
+
+// Spectrum stream configuration
+namespace StreamConfig {
+    constexpr size_t MAX_VIEWS = 64;               // Distinct views in the registry
+    constexpr uint32_t MIN_WIDTH = 16;             // Narrowest output row
+    constexpr uint32_t MAX_EVERY = 100;            // Largest row divider
+    constexpr size_t FRAME_CACHE_ROWS = 8;         // Encoded rows kept per view (late subscribers catch up)
+    constexpr size_t HEADER_BYTES = 16;
+    constexpr uint32_t KEYFRAME_INTERVAL = 64;     // Delta views send every Nth view row as a keyframe
+    constexpr uint8_t FLAG_KEYFRAME = 0x01;
+}
+
+// View parameters (what a client subscribes to)
+struct StreamView {
+    uint8_t channel_mask;      // Bit 0 = RX1, bit 1 = RX2
+    uint32_t start_bin;        // First bin of the range (inclusive)
+    uint32_t end_bin;          // Last bin of the range (inclusive)
+    uint32_t width;            // Output bins per channel (clamped to the range)
+    uint32_t reduce;           // DECIMATE_MAX (peak-preserving) or DECIMATE_MEAN when width < range
+    uint32_t every;            // Rows whose sequence is a multiple of this are sent
+    StreamEncoding encoding;   // Codec of the payload
+};
+
+// Full-resolution view of both channels, every row (the /ws/waterfall default)
+StreamView default_stream_view(size_t row_width);
+
+// Validate and normalize view parameters against the row width
+// Returns false if the parameters cannot describe a view
+bool normalize_stream_view(StreamView& view, size_t row_width);
+
+// Register one subscriber of a (normalized) view
+// Returns the view ID, or -1 if the registry is full
+int subscribe_stream_view(const StreamView& view);
+
+// Drop one subscriber (the view is removed with its last subscriber)
+void unsubscribe_stream_view(int view_id);
+
+// Parameters of a registered view
+bool get_stream_view(int view_id, StreamView& view);
+
+// Encoded frame of a view for waterfall row `sequence`
+// The first request per (view, row, variant) encodes it; later requests return the cached buffer.
+// Encoding runs in the caller without any lock held, so the row pointers must be stable copies,
+// never rows of the live waterfall history (g_waterfall); copy them out under its mutex first.
+// Returns nullptr if the view does not exist or does not send this row (see StreamView::every)
+// Args:
+//   ch1_row, ch2_row: Waterfall rows of that sequence (row_width bins each)
+//   reference_sequence: Last row of this view the subscriber received (UINT64_MAX = none);
+//                       delta encodings send a keyframe unless it is the view's previous row
+//   ref_ch1_row, ref_ch2_row: Waterfall rows of reference_sequence, nullptr if no longer held
+//                             (only read when the view has no reference row of its own)
+std::shared_ptr<const std::vector<uint8_t>> get_stream_frame(int view_id, uint64_t sequence,
+                                                             const uint8_t* ch1_row, const uint8_t* ch2_row,
+                                                             size_t row_width, uint64_t reference_sequence,
+                                                             const uint8_t* ref_ch1_row, const uint8_t* ref_ch2_row);
+
+// Count a frame sent to a subscriber (statistics and compression telemetry)
+void record_stream_send(int view_id, size_t bytes);
+
+// Registered views with subscriber, encode and fan-out counts as JSON
+std::string get_stream_views_json();
+
+#endif // SPECTRUM_STREAM_H
@@ -0,0 +1,41 @@
+#ifndef STATIC_ASSETS_H
+#define STATIC_ASSETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// In-memory web assets
+// Every file under web_assets/ is read once at startup and kept in memory with a gzip variant
+// (compressed at the best level, kept only when smaller) and a strong ETag per variant
+// (content hash). Requests are answered from a hash table keyed by URI path, without touching
+// the disk; a client that already holds the current version gets a 304 with no body, and one
+// that accepts gzip gets the precompressed bytes. Files changed or added after startup are
+// picked up on the next restart.
+
+struct StaticAsset {
+    const char* mime_type;
+    std::vector<uint8_t> body;
+    std::vector<uint8_t> gzip;     // Empty if compression does not make the file smaller
+    std::string etag;              // Quoted strong ETag of body
+    std::string gzip_etag;         // Quoted strong ETag of gzip
+};
+
+// Load all files of the web_assets directory (web_assets/ or server/web_assets/)
+// Called once before the web server thread starts; the table is read-only afterwards
+// Returns the number of files loaded
+size_t load_static_assets();
+
+// Asset for a URI path ("/" is index.html), nullptr if there is none
+const StaticAsset* find_static_asset(const char* uri, size_t uri_len);
+
+// True if an Accept-Encoding header value accepts gzip
+// Codings with q=0 are refused; an explicit gzip (or x-gzip) entry takes precedence over "*"
+bool accepts_gzip(const char* accept_encoding, size_t len);
+
+// True if an If-None-Match header value (a list of ETags, or "*") matches etag
+// Uses the weak comparison RFC 9110 prescribes for If-None-Match (W/ prefixes are ignored)
+bool etag_matches(const char* if_none_match, size_t len, const std::string& etag);
+
+#endif // STATIC_ASSETS_H
@@ -0,0 +1,118 @@
+#ifndef SUPERRES_DF_H
+#define SUPERRES_DF_H
+
+#include <fftw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cfar_detector.h"
+#include "config.h"
+
+// Super-resolution direction finding (Capon/MVDR and MUSIC pseudo-spectra)
+// Each frame, the per-bin spatial covariance R_k = E[x_k x_k^H] of the selected band is
+// integrated over K frames. The band covariance (sum over the bins inside detected
+// regions, or the whole band when nothing is detected) is then inverted (MVDR) or
+// eigendecomposed (MUSIC) with the small-matrix kernels in complex_matrix.h and scanned
+// against steering vectors of the array described in ArrayConfig. Unlike the
+// interferometer, this resolves several emitters sharing one band and works with any
+// planar element layout. Off by default; enabled through the web server.
+
+// Super-resolution DF configuration
+namespace SuperResConfig {
+    constexpr size_t AZIMUTH_STEPS = 360;            // Scan grid (1 degree)
+    constexpr uint32_t DEFAULT_INTEGRATION_FRAMES = 16;
+    constexpr uint32_t MAX_INTEGRATION_FRAMES = 256;
+    constexpr float DIAGONAL_LOADING = 1e-3f;        // MVDR loading relative to mean element power
+    constexpr float SOURCE_EIGEN_RATIO = 10.0f;      // Auto source count: eigenvalues this far above the smallest
+    constexpr size_t MAX_PEAKS = 4;
+    constexpr float PEAK_FLOOR_DB = -20.0f;          // Report peaks within this of the strongest
+    constexpr uint32_t PUBLISH_INTERVAL_FRAMES = 5;  // Spectrum is computed and published every N frames
+}
+
+enum class SuperResMethod {
+    MVDR,
+    MUSIC
+};
+
+// Engine settings (set from the web server)
+struct SuperResSettings {
+    bool enabled;
+    SuperResMethod method;
+    uint32_t start_bin;            // Band extent (start = end = 0 for the full spectrum)
+    uint32_t end_bin;
+    uint32_t sources;              // MUSIC signal subspace dimension (0 = from eigenvalues)
+    uint32_t integration_frames;   // K for the covariance EWMA
+};
+
+// One pseudo-spectrum peak
+struct SuperResPeak {
+    float azimuth;                 // Degrees clockwise from boresight (0-360)
+    float level_db;                // Relative to the strongest peak
+};
+
+// Super-resolution DF state (owned by the analysis thread)
+struct SuperResState {
+    size_t fft_size;
+    size_t elements;
+    size_t pairs;                  // Element pairs i < j
+    SuperResSettings settings;
+    uint64_t settings_version;
+    uint64_t center_freq;          // Tuning the covariance was integrated at
+    uint32_t frames;               // Frames integrated since the last reset
+    uint64_t frame_counter;
+    size_t start_bin;
+    size_t end_bin;
+    bool ambiguous;                // Collinear array: mirror-image bearings are indistinguishable
+
+    // Per-bin covariance over the band, one plane per entry (SoA for the bin loop):
+    // power[i * bins + b] = R_ii, cross_re/im[p * bins + b] = R_ij for pair p = (i, j)
+    std::vector<float> power;
+    std::vector<float> cross_re;
+    std::vector<float> cross_im;
+    std::vector<uint8_t> pair_i;
+    std::vector<uint8_t> pair_j;
+
+    // Steering phase difference phi_j - phi_i per pair and azimuth at steer_freq_hz
+    double steer_freq_hz;
+    std::vector<float> steer_cos;  // pairs x AZIMUTH_STEPS
+    std::vector<float> steer_sin;
+
+    std::vector<uint8_t> bin_used; // Band bins inside a detected region this frame
+    std::vector<float> spectrum;   // Pseudo-spectrum in dB (AZIMUTH_STEPS)
+    std::vector<float> quad;       // a^H Q a scratch (AZIMUTH_STEPS)
+    float eigenvalues[ArrayConfig::MAX_ELEMENTS];
+    size_t sources_used;
+    size_t bins_used;
+    std::vector<SuperResPeak> peaks;
+};
+
+// Initialize state for a given FFT size and the configured array
+void init_superres_df(SuperResState& state, size_t fft_size);
+
+// True while the engine is enabled (skip update_superres_df otherwise)
+bool superres_df_enabled();
+
+// Integrate one frame; every PUBLISH_INTERVAL_FRAMES frames also compute and publish the
+// pseudo-spectrum
+// Args:
+//   channels: Complex FFT output per array element (ArrayConfig::NUM_ELEMENTS pointers)
+//   regions: Full-band CFAR detections of the frame
+//   center_freq: Current center frequency in Hz (integration restarts on retune)
+//   sample_rate: Current sample rate in Hz
+//   cal_phasor: Per-bin RX2-vs-RX1 calibration phasors (nullptr = uncorrected)
+void update_superres_df(SuperResState& state, const fftwf_complex* const* channels,
+                        const std::vector<SignalRegion>& regions, uint64_t center_freq,
+                        uint32_t sample_rate, const float* cal_phasor);
+
+// Replace the engine settings (thread-safe, picked up on the next frame)
+// Returns false if the band is invalid
+bool set_superres_settings(const SuperResSettings& settings);
+
+// Current engine settings
+SuperResSettings get_superres_settings();
+
+// Get the latest published pseudo-spectrum and peaks as JSON
+std::string get_superres_json();
+
+#endif // SUPERRES_DF_H
@@ -16,6 +16,8 @@ struct TelemetryCounters {
     std::atomic<uint64_t> total_fft_time_us{0};         // Cumulative FFT computation time
     std::atomic<uint64_t> total_cfar_time_us{0};        // Cumulative CFAR detection time
     std::atomic<uint64_t> total_df_time_us{0};          // Cumulative direction finding time
+    std::atomic<uint64_t> total_pulse_time_us{0};       // Cumulative time-domain pulse detection time
+    std::atomic<uint64_t> total_stft_time_us{0};        // Cumulative multi-resolution STFT time
     std::atomic<uint64_t> total_processing_time_us{0};  // Cumulative total processing time
 
     // USB transfer metrics
@@ -26,6 +28,10 @@ struct TelemetryCounters {
     // Signal detection metrics
     std::atomic<uint64_t> signals_detected{0};          // Total signals detected by CFAR
     std::atomic<uint64_t> df_computations{0};           // Total DF computations performed
+    std::atomic<uint64_t> pulses_detected{0};           // Total time-domain pulses detected
+    std::atomic<uint64_t> stft_frames{0};               // Total multi-resolution STFT frames computed
+    std::atomic<uint64_t> bearing_tracks_evicted{0};    // Emitter tracks evicted (LRU) to make room
+    std::atomic<uint64_t> bearing_regions_dropped{0};   // Detections not tracked (pool full this frame)
 
     // Memory metrics
     std::atomic<uint64_t> buffer_allocations{0};        // Buffer allocation count
@@ -0,0 +1,84 @@
+#ifndef WATERFALL_IMAGE_H
+#define WATERFALL_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "web_server.h"
+
+// Colormapped waterfall images
+// The waterfall history is cut into tiles of TILE_ROWS rows by TILE_WIDTH bins. Tile row y
+// holds rows [y * TILE_ROWS, (y + 1) * TILE_ROWS) of the row sequence, so a tile keeps its
+// coordinates while the history scrolls and a completed tile never changes. Rows are turned
+// into RGB once, through a 256-entry lookup table, when they first become visible to a tile
+// request; a PNG is encoded per (channel, tile, newest row) outside both locks and the same
+// buffer is served until the tile gains rows. Thin clients can show the history as plain
+// images without rendering anything themselves.
+
+// Waterfall tile configuration
+namespace WaterfallTileConfig {
+    constexpr uint32_t TILE_ROWS = 64;
+    constexpr uint32_t TILE_WIDTH = 1024;                                  // Bins per tile
+    constexpr uint32_t TILES_X = WATERFALL_WIDTH / TILE_WIDTH;
+    constexpr size_t BLOCKS = WATERFALL_HEIGHT / TILE_ROWS + 1;            // Tile rows kept per channel
+}
+
+// Perceptually uniform color mapping for waterfall display
+struct RGB {
+    uint8_t r, g, b;
+};
+
+// Convert a normalized magnitude value to RGB color using Viridis colormap
+// Args:
+//   value: Normalized magnitude (0.0 to 1.0)
+RGB viridis_colormap(float value);
+
+// Colormaps for rendered waterfall images
+enum class Colormap : uint8_t {
+    VIRIDIS = 0,               // Perceptually uniform (the tile and PNG default)
+    GRAY = 1,                  // Black to white
+    HOT = 2                    // Black, red, yellow, white
+};
+
+// Colormap for a name ("viridis", "gray", "hot"), false if unknown
+bool parse_colormap(const char* name, Colormap& colormap);
+
+// Name of a colormap
+const char* colormap_name(Colormap colormap);
+
+// Colormap for every uint8 magnitude (256 RGB triples, 768 bytes)
+const uint8_t* colormap_lut(Colormap colormap);
+
+// Colormap one row of magnitudes into RGB (width pixels)
+void colormap_row(const uint8_t* magnitude, const uint8_t* lut, uint8_t* rgb, size_t width);
+
+// Colormap the rows written since the last call into the tile rows
+// Takes g_waterfall.mutex only to copy the new rows out; colormapping runs under the
+// tile lock. Must be called without g_waterfall.mutex held
+void sync_waterfall_tiles();
+
+// One encoded tile
+struct WaterfallTile {
+    std::shared_ptr<const std::vector<uint8_t>> png;
+    uint32_t rows;                 // Image height (TILE_ROWS once complete)
+    uint64_t last_sequence;        // Newest row in the tile
+    bool complete;                 // All TILE_ROWS rows rendered (the image will not change)
+};
+
+// PNG of tile (tile_x, tile_y) of a channel (1 or 2), encoded on first request
+// Returns false if the tile is out of range or no longer (or not yet) held
+bool get_waterfall_tile(int channel, uint32_t tile_x, uint64_t tile_y, WaterfallTile& tile);
+
+// Newest tile row with rendered rows, false if nothing has been rendered yet
+bool get_newest_tile_row(uint64_t& tile_y);
+
+// Tile geometry and the range of tile rows held, as JSON
+std::string get_waterfall_tiles_json();
+
+// PNG of the whole history of a channel (1 or 2), oldest row at the top
+// Returns an empty vector on error
+std::vector<uint8_t> generate_waterfall_png(int channel);
+
+#endif // WATERFALL_IMAGE_H
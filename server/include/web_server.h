@@ -14,6 +14,9 @@ constexpr int WEB_SERVER_PORT = 8080;          // HTTP server port for web inter
 constexpr int WATERFALL_HEIGHT = 512;          // Number of FFT frames stored in history
 constexpr int WATERFALL_WIDTH = 4096;          // Maximum FFT size supported
 constexpr int IQ_SAMPLES = 256;                // Number of IQ samples for constellation display
+constexpr int WS_MAX_CATCHUP_ROWS = 8;         // Rows a late WebSocket client may catch up on per wakeup
+constexpr size_t WS_MAX_BACKLOG_BYTES = 256 * 1024;  // Skip rows while a client's send buffer exceeds this
+constexpr size_t MJPEG_MAX_BACKLOG_BYTES = 512 * 1024;  // Skip MJPEG frames while a viewer's send buffer exceeds this
 
 // Waterfall display buffer for storing spectrum history
 // Maintains a circular buffer of FFT magnitude data for both channels
@@ -22,9 +25,10 @@ struct WaterfallBuffer {
     std::vector<std::vector<uint8_t>> ch1_history;  // Channel 1 FFT history (circular buffer)
     std::vector<std::vector<uint8_t>> ch2_history;  // Channel 2 FFT history (circular buffer)
     int write_index;                                // Current write position in circular buffer
+    uint64_t sequence;                              // Rows written so far (row s is at s % WATERFALL_HEIGHT)
     std::mutex mutex;                               // Mutex for thread-safe access
 
-    WaterfallBuffer() : write_index(0) {
+    WaterfallBuffer() : write_index(0), sequence(0) {
         ch1_history.resize(WATERFALL_HEIGHT);
         ch2_history.resize(WATERFALL_HEIGHT);
         for (auto& row : ch1_history) {
@@ -162,6 +166,7 @@ void stop_web_server();
 
 // Update waterfall buffer with new FFT magnitude data
 // Thread-safe function to append new spectrum data to the circular buffer
+// Wakes the web server loop so the row is pushed to /ws/waterfall clients right away
 void update_waterfall(const uint8_t* ch1_mag, const uint8_t* ch2_mag, size_t fft_size);
 
 // Update IQ constellation data for both channels
@@ -1,5 +1,6 @@
 #include "array_calibration.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
@@ -9,6 +10,12 @@
 ArrayCalibration g_array_cal = {false, {}, 0.5f};
 std::mutex g_calibration_mutex;
 
+// Bumped (under g_calibration_mutex) whenever points or enable state change
+static std::atomic<uint64_t> g_calibration_version{1};
+
+// Published per-bin table (std::atomic_load / std::atomic_store only)
+static std::shared_ptr<const CalibrationTable> g_calibration_table;
+
 void add_calibration_point(uint64_t frequency, float measured_phase_diff_deg, float known_azimuth_deg) {
     std::lock_guard<std::mutex> lock(g_calibration_mutex);
 
@@ -55,6 +62,14 @@ void add_calibration_point(uint64_t frequency, float measured_phase_diff_deg, fl
         std::cout << "Added calibration at " << (frequency / 1e6) << " MHz: "
                   << "correction = " << correction_deg << "°" << std::endl;
     }
+
+    g_calibration_version.fetch_add(1, std::memory_order_release);
+}
+
+void clear_calibration() {
+    std::lock_guard<std::mutex> lock(g_calibration_mutex);
+    g_array_cal.points.clear();
+    g_calibration_version.fetch_add(1, std::memory_order_release);
 }
 
 float get_phase_correction(uint64_t frequency) {
@@ -169,6 +184,78 @@ void load_calibration(const std::string& filename) {
                   return a.frequency < b.frequency;
               });
 
+    g_calibration_version.fetch_add(1, std::memory_order_release);
+
     std::cout << "Calibration loaded from: " << filename << " ("
               << g_array_cal.points.size() << " points)" << std::endl;
 }
+
+void set_calibration_enabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(g_calibration_mutex);
+    g_array_cal.enabled = enabled;
+    g_calibration_version.fetch_add(1, std::memory_order_release);
+}
+
+// Build the per-bin table (caller holds g_calibration_mutex)
+// Bin frequencies increase monotonically, so one walk over the sorted points covers all bins
+static void build_calibration_table(CalibrationTable& table) {
+    const auto& points = g_array_cal.points;
+    table.enabled = g_array_cal.enabled && !points.empty();
+    if (!table.enabled) return;
+
+    const size_t n = table.fft_size;
+    const double bin_hz = static_cast<double>(table.sample_rate) / n;
+    table.correction_deg.resize(n);
+    table.phasor.resize(n * 2);
+
+    size_t upper = 0;
+    for (size_t k = 0; k < n; k++) {
+        const double freq = static_cast<double>(table.center_freq) + (static_cast<double>(k) - n / 2.0) * bin_hz;
+        while (upper < points.size() && static_cast<double>(points[upper].frequency) < freq) {
+            upper++;
+        }
+
+        float correction;
+        if (upper == 0) {
+            correction = points.front().phase_correction_deg;      // Below first point
+        } else if (upper == points.size()) {
+            correction = points.back().phase_correction_deg;       // Above last point
+        } else {
+            const CalibrationPoint& lo = points[upper - 1];
+            const CalibrationPoint& hi = points[upper];
+            const double frac = (freq - lo.frequency) / static_cast<double>(hi.frequency - lo.frequency);
+            correction = lo.phase_correction_deg +
+                         static_cast<float>(frac) * (hi.phase_correction_deg - lo.phase_correction_deg);
+        }
+
+        const float rad = correction * static_cast<float>(M_PI) / 180.0f;
+        table.correction_deg[k] = correction;
+        table.phasor[k * 2] = std::cos(rad);
+        table.phasor[k * 2 + 1] = std::sin(rad);
+    }
+}
+
+std::shared_ptr<const CalibrationTable> get_calibration_table(uint64_t center_freq, uint32_t sample_rate,
+                                                              size_t fft_size) {
+    std::shared_ptr<const CalibrationTable> table = std::atomic_load(&g_calibration_table);
+    if (table && table->center_freq == center_freq && table->sample_rate == sample_rate &&
+        table->fft_size == fft_size &&
+        table->version == g_calibration_version.load(std::memory_order_acquire)) {
+        return table;
+    }
+
+    // Calibration or tuning changed - build and publish a new snapshot
+    auto fresh = std::make_shared<CalibrationTable>();
+    fresh->center_freq = center_freq;
+    fresh->sample_rate = sample_rate;
+    fresh->fft_size = fft_size;
+    {
+        std::lock_guard<std::mutex> lock(g_calibration_mutex);
+        fresh->version = g_calibration_version.load(std::memory_order_acquire);
+        build_calibration_table(*fresh);
+    }
+
+    table = fresh;
+    std::atomic_store(&g_calibration_table, table);
+    return table;
+}
@@ -0,0 +1,180 @@
+#include "beamformer.h"
+#include "config.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// Beamformer settings (written by web server, snapshotted by processing thread on change)
+static BeamformerSettings g_beam_settings = {false, 0.0f, false, false};
+static uint64_t g_beam_settings_version = 1;
+static std::mutex g_beam_settings_mutex;
+static std::atomic<bool> g_beam_enabled{false};
+
+// Latest published beam levels (written by processing thread, read by web server)
+static std::string g_beam_json = "{\"enabled\":false}";
+static std::mutex g_beam_json_mutex;
+
+void init_beamformer(BeamformerState& state, size_t fft_size) {
+    state.fft_size = fft_size;
+    state.settings = BeamformerSettings{};
+    state.settings_version = 0;
+    state.frame_counter = 0;
+    state.center_freq = 0;
+    state.sample_rate = 0;
+    state.cal_table.reset();
+    state.weight_re.assign(fft_size, 1.0f);
+    state.weight_im.assign(fft_size, 0.0f);
+    state.sum_beam.assign(fft_size * 2, 0.0f);
+    state.diff_beam.assign(fft_size * 2, 0.0f);
+    init_noise_floor(state.noise_floor, fft_size, 2);
+}
+
+bool beamformer_enabled() {
+    return g_beam_enabled.load(std::memory_order_relaxed);
+}
+
+// Rebuild the per-bin RX2 weights for the current steering, tuning and calibration
+// Bin k sits at f_k = f_c + (k - N/2) * fs / N, so the inter-element phase of a plane
+// wave from theta is 2 pi d (f_k / f_c) sin(theta) with d in wavelengths at f_c
+static void build_weights(BeamformerState& state) {
+    const size_t n = state.fft_size;
+    const double sin_theta = std::sin(state.settings.steer_azimuth_deg * M_PI / 180.0);
+    const double phase_scale = 2.0 * M_PI * DFConfig::ANTENNA_SPACING_WAVELENGTHS * sin_theta;
+    const double fc = static_cast<double>(state.center_freq);
+    const double bin_hz = static_cast<double>(state.sample_rate) / static_cast<double>(n);
+    const float* cal = (state.cal_table && state.cal_table->enabled) ? state.cal_table->phasor.data() : nullptr;
+
+    for (size_t k = 0; k < n; k++) {
+        const double freq_ratio = (fc > 0.0) ? (fc + (static_cast<double>(k) - n / 2.0) * bin_hz) / fc : 1.0;
+        const double phase = -phase_scale * freq_ratio;
+        float wr = static_cast<float>(std::cos(phase));
+        float wi = static_cast<float>(std::sin(phase));
+        if (cal) {
+            const float cr = cal[k * 2];
+            const float ci = cal[k * 2 + 1];
+            const float tr = wr * cr - wi * ci;
+            wi = wr * ci + wi * cr;
+            wr = tr;
+        }
+        state.weight_re[k] = wr;
+        state.weight_im[k] = wi;
+    }
+}
+
+// Sum and difference beams: s = (x1 + w x2) / 2, d = (x1 - w x2) / 2
+// The 1/2 keeps a coherent signal at its single-channel level while uncorrelated
+// noise drops 3 dB, so beam and channel magnitudes share one display scale.
+// Complex inputs/outputs are interleaved re/im; weights are split planes.
+static void form_beams(const float* __restrict x1, const float* __restrict x2,
+                       const float* __restrict wr, const float* __restrict wi,
+                       float* __restrict sum, float* __restrict diff, size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        const float ar = x2[k * 2];
+        const float ai = x2[k * 2 + 1];
+        const float tr = 0.5f * (ar * wr[k] - ai * wi[k]);
+        const float ti = 0.5f * (ar * wi[k] + ai * wr[k]);
+        const float br = 0.5f * x1[k * 2];
+        const float bi = 0.5f * x1[k * 2 + 1];
+        sum[k * 2] = br + tr;
+        sum[k * 2 + 1] = bi + ti;
+        diff[k * 2] = br - tr;
+        diff[k * 2 + 1] = bi - ti;
+    }
+}
+
+static void publish_beams(const BeamformerState& state) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\"enabled\":true"
+         << ",\"azimuth\":" << state.settings.steer_azimuth_deg
+         << ",\"cfar\":" << (state.settings.cfar_input ? "true" : "false")
+         << ",\"display\":" << (state.settings.display_input ? "true" : "false")
+         << ",\"calibrated\":" << ((state.cal_table && state.cal_table->enabled) ? "true" : "false")
+         << ",\"sumNoiseFloor\":" << get_channel_noise_floor(state.noise_floor, 0)
+         << ",\"diffNoiseFloor\":" << get_channel_noise_floor(state.noise_floor, 1)
+         << "}";
+
+    std::lock_guard<std::mutex> lock(g_beam_json_mutex);
+    g_beam_json = json.str();
+}
+
+void update_beamformer(BeamformerState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                       uint64_t center_freq, uint32_t sample_rate,
+                       const std::shared_ptr<const CalibrationTable>& cal_table, uint8_t* beam_mag) {
+    bool rebuild = false;
+    {
+        std::lock_guard<std::mutex> lock(g_beam_settings_mutex);
+        if (state.settings_version != g_beam_settings_version) {
+            state.settings_version = g_beam_settings_version;
+            state.settings = g_beam_settings;
+            rebuild = true;
+        }
+    }
+    if (center_freq != state.center_freq || sample_rate != state.sample_rate || cal_table != state.cal_table) {
+        state.center_freq = center_freq;
+        state.sample_rate = sample_rate;
+        state.cal_table = cal_table;
+        rebuild = true;
+    }
+    if (rebuild) {
+        build_weights(state);
+    }
+
+    const size_t n = state.fft_size;
+    form_beams(reinterpret_cast<const float*>(fft_ch1), reinterpret_cast<const float*>(fft_ch2),
+               state.weight_re.data(), state.weight_im.data(),
+               state.sum_beam.data(), state.diff_beam.data(), n);
+
+    uint8_t* sum_mag = beam_mag;
+    uint8_t* diff_mag = beam_mag + n;
+    compute_magnitude_db(reinterpret_cast<fftwf_complex*>(state.sum_beam.data()), sum_mag, n);
+    compute_magnitude_db(reinterpret_cast<fftwf_complex*>(state.diff_beam.data()), diff_mag, n);
+    update_noise_floor(state.noise_floor, beam_mag, n, NoiseFloorConfig::DEFAULT_PERCENTILE,
+                       NoiseFloorConfig::SMOOTHING_ALPHA);
+    remove_dc_offset(sum_mag, n);
+    remove_dc_offset(diff_mag, n);
+
+    state.frame_counter++;
+    if (state.frame_counter % BeamformerConfig::PUBLISH_INTERVAL_FRAMES == 0) {
+        publish_beams(state);
+    }
+}
+
+bool set_beamformer_settings(const BeamformerSettings& settings) {
+    if (!std::isfinite(settings.steer_azimuth_deg) ||
+        std::fabs(settings.steer_azimuth_deg) > BeamformerConfig::MAX_STEER_AZIMUTH_DEG) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_beam_settings_mutex);
+        g_beam_settings = settings;
+        g_beam_settings_version++;
+    }
+    g_beam_enabled.store(settings.enabled, std::memory_order_relaxed);
+
+    if (!settings.enabled) {
+        std::lock_guard<std::mutex> lock(g_beam_json_mutex);
+        g_beam_json = "{\"enabled\":false}";
+    }
+
+    std::cout << "[Beamformer] " << (settings.enabled ? "Enabled" : "Disabled")
+              << " (steer " << settings.steer_azimuth_deg << " deg"
+              << (settings.cfar_input ? ", CFAR input" : "")
+              << (settings.display_input ? ", display input" : "") << ")" << std::endl;
+    return true;
+}
+
+BeamformerSettings get_beamformer_settings() {
+    std::lock_guard<std::mutex> lock(g_beam_settings_mutex);
+    return g_beam_settings;
+}
+
+std::string get_beamformer_json() {
+    std::lock_guard<std::mutex> lock(g_beam_json_mutex);
+    return g_beam_json;
+}
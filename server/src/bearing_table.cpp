@@ -0,0 +1,397 @@
+#include "bearing_table.h"
+#include "config.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// User DF bands (written by web server, snapshotted by analysis thread each frame)
+static DFBand g_df_bands[BearingTableConfig::MAX_BANDS] = {};
+static uint32_t g_next_band_id = 1;
+static std::mutex g_df_bands_mutex;
+
+// Latest published table (written by analysis thread, read by web server)
+static std::string g_bearing_table_json = "{\"tracks\":[],\"bands\":[]}";
+static std::mutex g_bearing_table_mutex;
+
+// Inputs shared by all work items of one frame
+struct BearingBatch {
+    const fftwf_complex* fft_ch1;
+    const fftwf_complex* fft_ch2;
+    const BearingTableState* state;
+    float noise_power;
+    uint64_t center_freq;
+    const float* cal_phasor;
+    uint64_t now_ms;
+};
+
+// Persistent worker pool (threads wait for a new batch generation)
+struct BearingWorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const BearingBatch* batch = nullptr;
+    uint64_t generation = 0;
+    unsigned busy = 0;
+    bool stop = false;
+    std::atomic<size_t> next_item{0};
+};
+
+static BearingWorkerPool g_bearing_pool;
+
+static uint64_t get_time_ms() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static void reset_track(BearingTrack& track, uint32_t id, uint32_t band_id, float center_bin, uint64_t now_ms) {
+    track = BearingTrack{};
+    track.id = id;
+    track.band_id = band_id;
+    track.center_bin = center_bin;
+    track.kalman.initialized = false;
+    track.first_seen_ms = now_ms;
+    track.last_seen_ms = now_ms;
+}
+
+// Measure one track and step its Kalman filter
+static void process_item(const BearingBatch& batch, const BearingWorkItem& item) {
+    const auto& ranges = batch.state->ranges;
+    BearingTrack& track = *item.track;
+
+    // Bands integrate over their own K; emitters share the full-band matrix
+    const CrossSpectralMatrix* csm = &batch.state->csm;
+    if (track.band_id != 0) {
+        update_cross_spectral_matrix(track.csm, batch.fft_ch1, batch.fft_ch2, batch.center_freq);
+        csm = &track.csm;
+    }
+
+    CrossSpectrum cross = {};
+    for (size_t r = item.first_range; r < item.first_range + item.range_count; r++) {
+        accumulate_cross_spectral_matrix(*csm, ranges[r].first, ranges[r].second, cross, batch.cal_phasor);
+    }
+    const BearingMeasurement m = estimate_bearing(cross, batch.noise_power);
+    track.last = m;
+
+    if (m.confidence >= DFConfig::MIN_CONFIDENCE_THRESHOLD && m.num_bins >= DFConfig::MIN_BINS_FOR_DF) {
+        const bool first_measurement = !track.kalman.initialized;
+        track.azimuth = update_bearing_track(track.kalman, m.azimuth, m.phase_std_deg, batch.now_ms);
+        track.back_azimuth = first_measurement ? m.back_azimuth : std::fmod(track.azimuth + 180.0f, 360.0f);
+        track.last_seen_ms = batch.now_ms;
+        track.updates++;
+        track.holding = false;
+    } else if (track.kalman.initialized) {
+        track.azimuth = coast_bearing_track(track.kalman, batch.now_ms);
+        track.back_azimuth = std::fmod(track.azimuth + 180.0f, 360.0f);
+        track.holding = true;
+    }
+}
+
+static void run_items(const BearingBatch& batch) {
+    const auto& work = batch.state->work;
+    for (;;) {
+        const size_t i = g_bearing_pool.next_item.fetch_add(1, std::memory_order_relaxed);
+        if (i >= work.size()) break;
+        process_item(batch, work[i]);
+    }
+}
+
+static void bearing_worker_func() {
+    uint64_t seen_generation = 0;
+    for (;;) {
+        const BearingBatch* batch;
+        {
+            std::unique_lock<std::mutex> lock(g_bearing_pool.mutex);
+            g_bearing_pool.start_cv.wait(lock, [&] {
+                return g_bearing_pool.stop || g_bearing_pool.generation != seen_generation;
+            });
+            if (g_bearing_pool.stop) return;
+            seen_generation = g_bearing_pool.generation;
+            batch = g_bearing_pool.batch;
+        }
+
+        run_items(*batch);
+
+        std::lock_guard<std::mutex> lock(g_bearing_pool.mutex);
+        if (--g_bearing_pool.busy == 0) {
+            g_bearing_pool.done_cv.notify_one();
+        }
+    }
+}
+
+// Process all work items, fanning out to the pool when there are enough of them
+static void dispatch_items(const BearingBatch& batch) {
+    g_bearing_pool.next_item.store(0, std::memory_order_relaxed);
+
+    if (batch.state->work.size() < BearingTableConfig::PARALLEL_MIN_ITEMS || g_bearing_pool.threads.empty()) {
+        run_items(batch);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_bearing_pool.mutex);
+        g_bearing_pool.batch = &batch;
+        g_bearing_pool.busy = static_cast<unsigned>(g_bearing_pool.threads.size());
+        g_bearing_pool.generation++;
+    }
+    g_bearing_pool.start_cv.notify_all();
+
+    // The analysis thread takes items too
+    run_items(batch);
+
+    std::unique_lock<std::mutex> lock(g_bearing_pool.mutex);
+    g_bearing_pool.done_cv.wait(lock, [] { return g_bearing_pool.busy == 0; });
+}
+
+void init_bearing_table(BearingTableState& state, size_t fft_size) {
+    init_cross_spectral_matrix(state.csm, 0, fft_size, BearingTableConfig::DEFAULT_INTEGRATION_FRAMES);
+    state.emitters.assign(BearingTableConfig::MAX_TRACKS, BearingTrack{});
+    state.bands.assign(BearingTableConfig::MAX_BANDS, BearingTrack{});
+    state.matched.assign(BearingTableConfig::MAX_TRACKS, 0);
+    state.ranges.clear();
+    state.ranges.reserve(BearingTableConfig::MAX_TRACKS * 4);
+    state.work.clear();
+    state.work.reserve(BearingTableConfig::MAX_TRACKS + BearingTableConfig::MAX_BANDS);
+    state.next_id = 1;
+    state.frame_counter = 0;
+
+    // Leave one core for the analysis thread itself
+    const unsigned hw = std::thread::hardware_concurrency();
+    const unsigned workers = std::min(BearingTableConfig::MAX_WORKERS, hw > 1 ? hw - 1 : 0u);
+    g_bearing_pool.stop = false;
+    g_bearing_pool.generation = 0;
+    for (unsigned i = 0; i < workers; i++) {
+        g_bearing_pool.threads.emplace_back(bearing_worker_func);
+    }
+    std::cout << "[Bearing] Multi-emitter DF ready (" << workers << " workers)" << std::endl;
+}
+
+void destroy_bearing_table(BearingTableState& state) {
+    {
+        std::lock_guard<std::mutex> lock(g_bearing_pool.mutex);
+        g_bearing_pool.stop = true;
+    }
+    g_bearing_pool.start_cv.notify_all();
+    for (auto& t : g_bearing_pool.threads) {
+        t.join();
+    }
+    g_bearing_pool.threads.clear();
+    state.emitters.clear();
+    state.bands.clear();
+}
+
+// Find the emitter track for a region, or start a new one
+static BearingTrack* associate_region(BearingTableState& state, const SignalRegion& region, uint64_t now_ms) {
+    const float center = 0.5f * (region.start_bin + region.end_bin);
+    const float gate = std::max(BearingTableConfig::MATCH_TOLERANCE_BINS, 0.5f * region.bin_count);
+
+    size_t best = SIZE_MAX;
+    float best_distance = gate;
+    size_t free_slot = SIZE_MAX;
+    size_t lru_slot = SIZE_MAX;
+    for (size_t i = 0; i < state.emitters.size(); i++) {
+        const BearingTrack& track = state.emitters[i];
+        if (track.id == 0) {
+            if (free_slot == SIZE_MAX) free_slot = i;
+            continue;
+        }
+        if (state.matched[i]) continue;
+        if (lru_slot == SIZE_MAX || track.last_seen_ms < state.emitters[lru_slot].last_seen_ms) {
+            lru_slot = i;
+        }
+        const float distance = std::fabs(track.center_bin - center);
+        if (distance <= best_distance) {
+            best_distance = distance;
+            best = i;
+        }
+    }
+
+    if (best != SIZE_MAX) {
+        BearingTrack& track = state.emitters[best];
+        track.center_bin += BearingTableConfig::CENTER_ALPHA * (center - track.center_bin);
+        state.matched[best] = 1;
+        return &track;
+    }
+
+    // Pool full: evict the least recently seen track not measured this frame
+    if (free_slot == SIZE_MAX) {
+        if (lru_slot == SIZE_MAX) {
+            g_telemetry.bearing_regions_dropped.fetch_add(1);
+            return nullptr;
+        }
+        g_telemetry.bearing_tracks_evicted.fetch_add(1);
+        free_slot = lru_slot;
+    }
+
+    reset_track(state.emitters[free_slot], state.next_id++, 0, center, now_ms);
+    state.matched[free_slot] = 1;
+    return &state.emitters[free_slot];
+}
+
+void update_bearing_table(BearingTableState& state, const fftwf_complex* fft_ch1,
+                          const fftwf_complex* fft_ch2, const std::vector<SignalRegion>& regions,
+                          float noise_power, uint64_t center_freq, const float* cal_phasor) {
+    const uint64_t now_ms = get_time_ms();
+    state.frame_counter++;
+    state.ranges.clear();
+    state.work.clear();
+    std::fill(state.matched.begin(), state.matched.end(), 0);
+
+    // Integrate this frame into the full-band cross-spectral matrix (O(N), vectorized)
+    update_cross_spectral_matrix(state.csm, fft_ch1, fft_ch2, center_freq);
+
+    // Retire emitters that have not produced a usable bearing for a while
+    for (auto& track : state.emitters) {
+        if (track.id != 0 && now_ms - track.last_seen_ms > BearingTableConfig::TRACK_TIMEOUT_MS) {
+            track.id = 0;
+        }
+    }
+
+    // One work item per detected region
+    for (const auto& region : regions) {
+        BearingTrack* track = associate_region(state, region, now_ms);
+        if (!track) continue;
+        track->start_bin = region.start_bin;
+        track->end_bin = region.end_bin;
+        state.work.push_back({track, state.ranges.size(), 1});
+        state.ranges.emplace_back(region.start_bin, region.end_bin);
+    }
+
+    // One work item per user band, covering the detections inside it
+    DFBand bands[BearingTableConfig::MAX_BANDS];
+    {
+        std::lock_guard<std::mutex> lock(g_df_bands_mutex);
+        std::copy(std::begin(g_df_bands), std::end(g_df_bands), bands);
+    }
+    for (size_t b = 0; b < BearingTableConfig::MAX_BANDS; b++) {
+        BearingTrack& track = state.bands[b];
+        if (bands[b].id == 0) {
+            track.id = 0;
+            continue;
+        }
+        if (track.id == 0 || track.band_id != bands[b].id) {
+            reset_track(track, state.next_id++, bands[b].id,
+                        0.5f * (bands[b].start_bin + bands[b].end_bin), now_ms);
+            init_cross_spectral_matrix(track.csm, bands[b].start_bin,
+                                       std::min<size_t>(bands[b].end_bin, state.csm.bins - 1) - bands[b].start_bin + 1,
+                                       bands[b].integration_frames);
+        }
+        track.start_bin = bands[b].start_bin;
+        track.end_bin = bands[b].end_bin;
+
+        const size_t first_range = state.ranges.size();
+        for (const auto& region : regions) {
+            const size_t lo = std::max<size_t>(region.start_bin, bands[b].start_bin);
+            const size_t hi = std::min<size_t>(region.end_bin, bands[b].end_bin);
+            if (lo <= hi) state.ranges.emplace_back(lo, hi);
+        }
+        state.work.push_back({&track, first_range, state.ranges.size() - first_range});
+    }
+
+    BearingBatch batch = {fft_ch1, fft_ch2, &state, noise_power, center_freq, cal_phasor, now_ms};
+    dispatch_items(batch);
+
+    // Emitters not seen this frame coast on their prediction
+    for (size_t i = 0; i < state.emitters.size(); i++) {
+        BearingTrack& track = state.emitters[i];
+        if (track.id == 0 || state.matched[i] || !track.kalman.initialized) continue;
+        track.azimuth = coast_bearing_track(track.kalman, now_ms);
+        track.back_azimuth = std::fmod(track.azimuth + 180.0f, 360.0f);
+        track.holding = true;
+    }
+}
+
+static void append_track_json(std::ostringstream& json, const BearingTrack& track, uint32_t integration_frames,
+                              double bin_hz, uint64_t center_freq, size_t fft_size) {
+    const double center_bin = 0.5 * (track.start_bin + track.end_bin);
+    json << "{\"id\":" << track.id
+         << ",\"bandId\":" << track.band_id
+         << std::setprecision(0)
+         << ",\"freqHz\":" << static_cast<double>(center_freq) + (center_bin - fft_size / 2.0) * bin_hz
+         << ",\"bwHz\":" << (track.end_bin - track.start_bin + 1) * bin_hz
+         << std::setprecision(2)
+         << ",\"startBin\":" << track.start_bin
+         << ",\"endBin\":" << track.end_bin
+         << ",\"azimuth\":" << track.azimuth
+         << ",\"backAzimuth\":" << track.back_azimuth
+         << ",\"phaseDiff\":" << track.last.phase_diff_deg
+         << ",\"phaseStd\":" << track.last.phase_std_deg
+         << ",\"confidence\":" << track.last.confidence
+         << ",\"snr\":" << track.last.snr_db
+         << ",\"msc\":" << track.last.msc
+         << ",\"frames\":" << integration_frames
+         << ",\"updates\":" << track.updates
+         << ",\"ageMs\":" << track.last_seen_ms - track.first_seen_ms
+         << ",\"holding\":" << ((track.holding || !track.kalman.initialized) ? "true" : "false") << "}";
+}
+
+void publish_bearing_table(const BearingTableState& state, uint64_t center_freq, uint32_t sample_rate,
+                           size_t fft_size) {
+    const double bin_hz = static_cast<double>(sample_rate) / fft_size;
+
+    std::ostringstream json;
+    json << std::fixed << "{\"frame\":" << state.frame_counter << ",\"tracks\":[";
+    bool first = true;
+    for (const auto& track : state.emitters) {
+        // Only report emitters with at least one accepted bearing
+        if (track.id == 0 || !track.kalman.initialized) continue;
+        if (!first) json << ",";
+        append_track_json(json, track, state.csm.integration_frames, bin_hz, center_freq, fft_size);
+        first = false;
+    }
+    json << "],\"bands\":[";
+    first = true;
+    for (const auto& track : state.bands) {
+        if (track.id == 0) continue;
+        if (!first) json << ",";
+        append_track_json(json, track, track.csm.integration_frames, bin_hz, center_freq, fft_size);
+        first = false;
+    }
+    json << "]}";
+
+    std::lock_guard<std::mutex> lock(g_bearing_table_mutex);
+    g_bearing_table_json = json.str();
+}
+
+std::string get_bearing_table_json() {
+    std::lock_guard<std::mutex> lock(g_bearing_table_mutex);
+    return g_bearing_table_json;
+}
+
+uint32_t add_df_band(uint32_t start_bin, uint32_t end_bin, uint32_t integration_frames) {
+    if (end_bin < start_bin) return 0;
+
+    std::lock_guard<std::mutex> lock(g_df_bands_mutex);
+    for (auto& band : g_df_bands) {
+        if (band.id == 0) {
+            band.id = g_next_band_id++;
+            band.start_bin = start_bin;
+            band.end_bin = end_bin;
+            band.integration_frames = std::clamp<uint32_t>(integration_frames, 1,
+                                                           BearingTableConfig::MAX_INTEGRATION_FRAMES);
+            return band.id;
+        }
+    }
+    return 0;
+}
+
+bool remove_df_band(uint32_t id) {
+    if (id == 0) return false;
+
+    std::lock_guard<std::mutex> lock(g_df_bands_mutex);
+    for (auto& band : g_df_bands) {
+        if (band.id == id) {
+            band = DFBand{};
+            return true;
+        }
+    }
+    return false;
+}
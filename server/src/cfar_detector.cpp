@@ -247,3 +247,24 @@ std::vector<SignalRegion> detect_signals_cfar_with_floor(const uint8_t* ch1_mag,
 
     return signals;
 }
+
+void merge_signal_regions(std::vector<SignalRegion>& regions, const std::vector<SignalRegion>& extra) {
+    if (extra.empty()) return;
+
+    regions.insert(regions.end(), extra.begin(), extra.end());
+    std::stable_sort(regions.begin(), regions.end(), [](const SignalRegion& a, const SignalRegion& b) {
+        return a.start_bin < b.start_bin;
+    });
+
+    size_t out = 0;
+    for (size_t i = 1; i < regions.size(); i++) {
+        SignalRegion& last = regions[out];
+        if (regions[i].start_bin <= last.end_bin + 1) {
+            last.end_bin = std::max(last.end_bin, regions[i].end_bin);
+            last.bin_count = last.end_bin - last.start_bin + 1;
+        } else {
+            regions[++out] = regions[i];
+        }
+    }
+    regions.resize(out + 1);
+}
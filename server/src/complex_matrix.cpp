@@ -0,0 +1,224 @@
+#include "complex_matrix.h"
+#include <algorithm>
+#include <cmath>
+
+void cmat_zero(CMatrix& m, size_t n) {
+    m.n = n;
+    for (size_t i = 0; i < ComplexMatrixConfig::MAX_DIM; i++) {
+        std::fill_n(m.re[i], ComplexMatrixConfig::MAX_DIM, 0.0f);
+        std::fill_n(m.im[i], ComplexMatrixConfig::MAX_DIM, 0.0f);
+    }
+}
+
+void cmat_add_diagonal(CMatrix& m, float value) {
+    for (size_t i = 0; i < m.n; i++) {
+        m.re[i][i] += value;
+    }
+}
+
+float cmat_trace(const CMatrix& m) {
+    float trace = 0.0f;
+    for (size_t i = 0; i < m.n; i++) {
+        trace += m.re[i][i];
+    }
+    return trace;
+}
+
+// [[a, b], [conj(b), d]]^-1 = [[d, -b], [-conj(b), a]] / (a d - |b|^2)
+static bool inverse_2x2(const CMatrix& a, CMatrix& inverse) {
+    const float p = a.re[0][0];
+    const float d = a.re[1][1];
+    const float br = a.re[0][1];
+    const float bi = a.im[0][1];
+    const float det = p * d - (br * br + bi * bi);
+    if (!(det > 0.0f) || !(p > 0.0f)) return false;
+
+    const float inv_det = 1.0f / det;
+    cmat_zero(inverse, 2);
+    inverse.re[0][0] = d * inv_det;
+    inverse.re[1][1] = p * inv_det;
+    inverse.re[0][1] = -br * inv_det;
+    inverse.im[0][1] = -bi * inv_det;
+    inverse.re[1][0] = -br * inv_det;
+    inverse.im[1][0] = bi * inv_det;
+    return true;
+}
+
+bool cmat_hermitian_inverse(const CMatrix& a, CMatrix& inverse) {
+    const size_t n = a.n;
+    if (n == 2) return inverse_2x2(a, inverse);
+
+    // Cholesky: A = L L^H (L lower triangular, real positive diagonal)
+    CMatrix l;
+    cmat_zero(l, n);
+    for (size_t j = 0; j < n; j++) {
+        float diag = a.re[j][j];
+        for (size_t k = 0; k < j; k++) {
+            diag -= l.re[j][k] * l.re[j][k] + l.im[j][k] * l.im[j][k];
+        }
+        if (!(diag > 0.0f)) return false;
+        const float ljj = std::sqrt(diag);
+        const float inv_ljj = 1.0f / ljj;
+        l.re[j][j] = ljj;
+
+        for (size_t i = j + 1; i < n; i++) {
+            // L_ij = (A_ij - sum_k L_ik conj(L_jk)) / L_jj
+            float sr = a.re[i][j];
+            float si = a.im[i][j];
+            for (size_t k = 0; k < j; k++) {
+                sr -= l.re[i][k] * l.re[j][k] + l.im[i][k] * l.im[j][k];
+                si -= l.im[i][k] * l.re[j][k] - l.re[i][k] * l.im[j][k];
+            }
+            l.re[i][j] = sr * inv_ljj;
+            l.im[i][j] = si * inv_ljj;
+        }
+    }
+
+    // W = L^-1 by forward substitution (lower triangular)
+    CMatrix w;
+    cmat_zero(w, n);
+    for (size_t j = 0; j < n; j++) {
+        w.re[j][j] = 1.0f / l.re[j][j];
+        for (size_t i = j + 1; i < n; i++) {
+            float sr = 0.0f, si = 0.0f;
+            for (size_t k = j; k < i; k++) {
+                sr += l.re[i][k] * w.re[k][j] - l.im[i][k] * w.im[k][j];
+                si += l.re[i][k] * w.im[k][j] + l.im[i][k] * w.re[k][j];
+            }
+            const float inv_lii = 1.0f / l.re[i][i];
+            w.re[i][j] = -sr * inv_lii;
+            w.im[i][j] = -si * inv_lii;
+        }
+    }
+
+    // A^-1 = W^H W
+    cmat_zero(inverse, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i; j < n; j++) {
+            float sr = 0.0f, si = 0.0f;
+            for (size_t k = j; k < n; k++) {
+                // conj(W_ki) * W_kj
+                sr += w.re[k][i] * w.re[k][j] + w.im[k][i] * w.im[k][j];
+                si += w.re[k][i] * w.im[k][j] - w.im[k][i] * w.re[k][j];
+            }
+            inverse.re[i][j] = sr;
+            inverse.im[i][j] = si;
+            inverse.re[j][i] = sr;
+            inverse.im[j][i] = -si;
+        }
+    }
+    return true;
+}
+
+void cmat_hermitian_eigen(const CMatrix& a, float* eigenvalues, CMatrix& eigenvectors) {
+    const size_t n = a.n;
+    CMatrix m = a;
+    cmat_zero(eigenvectors, n);
+    for (size_t i = 0; i < n; i++) {
+        eigenvectors.re[i][i] = 1.0f;
+    }
+
+    float scale = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        scale += std::fabs(m.re[i][i]);
+    }
+    const float tolerance = ComplexMatrixConfig::JACOBI_TOLERANCE * std::max(scale, 1e-30f);
+
+    for (int sweep = 0; sweep < ComplexMatrixConfig::MAX_JACOBI_SWEEPS; sweep++) {
+        float off = 0.0f;
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                off += m.re[p][q] * m.re[p][q] + m.im[p][q] * m.im[p][q];
+            }
+        }
+        if (std::sqrt(off) < tolerance) break;
+
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                const float mag = std::hypot(m.re[p][q], m.im[p][q]);
+                if (mag < 1e-30f) continue;
+
+                // U = diag(..1.., conj(w) at q) * R(c, s) with w = A_pq / |A_pq|: the phase
+                // makes the pivot real, then a real Jacobi rotation zeroes it
+                const float wr = m.re[p][q] / mag;
+                const float wi = m.im[p][q] / mag;
+                const float theta = (m.re[q][q] - m.re[p][p]) / (2.0f * mag);
+                const float t = std::copysign(1.0f, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+                const float c = 1.0f / std::sqrt(t * t + 1.0f);
+                const float s = t * c;
+
+                // Columns: A <- A U
+                for (size_t k = 0; k < n; k++) {
+                    const float pr = m.re[k][p], pi = m.im[k][p];
+                    const float qr = m.re[k][q], qi = m.im[k][q];
+                    // conj(w) * A_kq
+                    const float wqr = wr * qr + wi * qi;
+                    const float wqi = wr * qi - wi * qr;
+                    m.re[k][p] = c * pr - s * wqr;
+                    m.im[k][p] = c * pi - s * wqi;
+                    m.re[k][q] = s * pr + c * wqr;
+                    m.im[k][q] = s * pi + c * wqi;
+                }
+                // Rows: A <- U^H A
+                for (size_t k = 0; k < n; k++) {
+                    const float pr = m.re[p][k], pi = m.im[p][k];
+                    const float qr = m.re[q][k], qi = m.im[q][k];
+                    // w * A_qk
+                    const float wqr = wr * qr - wi * qi;
+                    const float wqi = wr * qi + wi * qr;
+                    m.re[p][k] = c * pr - s * wqr;
+                    m.im[p][k] = c * pi - s * wqi;
+                    m.re[q][k] = s * pr + c * wqr;
+                    m.im[q][k] = s * pi + c * wqi;
+                }
+                // Eigenvectors: V <- V U
+                for (size_t k = 0; k < n; k++) {
+                    const float pr = eigenvectors.re[k][p], pi = eigenvectors.im[k][p];
+                    const float qr = eigenvectors.re[k][q], qi = eigenvectors.im[k][q];
+                    const float wqr = wr * qr + wi * qi;
+                    const float wqi = wr * qi - wi * qr;
+                    eigenvectors.re[k][p] = c * pr - s * wqr;
+                    eigenvectors.im[k][p] = c * pi - s * wqi;
+                    eigenvectors.re[k][q] = s * pr + c * wqr;
+                    eigenvectors.im[k][q] = s * pi + c * wqi;
+                }
+                m.re[p][q] = m.im[p][q] = 0.0f;
+                m.re[q][p] = m.im[q][p] = 0.0f;
+            }
+        }
+    }
+
+    // Sort ascending (selection sort, n <= MAX_DIM), swapping eigenvector columns along
+    for (size_t i = 0; i < n; i++) {
+        eigenvalues[i] = m.re[i][i];
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t min_index = i;
+        for (size_t j = i + 1; j < n; j++) {
+            if (eigenvalues[j] < eigenvalues[min_index]) min_index = j;
+        }
+        if (min_index == i) continue;
+        std::swap(eigenvalues[i], eigenvalues[min_index]);
+        for (size_t k = 0; k < n; k++) {
+            std::swap(eigenvectors.re[k][i], eigenvectors.re[k][min_index]);
+            std::swap(eigenvectors.im[k][i], eigenvectors.im[k][min_index]);
+        }
+    }
+}
+
+void cmat_column_projector(const CMatrix& v, size_t first, size_t count, CMatrix& projector) {
+    const size_t n = v.n;
+    cmat_zero(projector, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float sr = 0.0f, si = 0.0f;
+            for (size_t k = first; k < first + count; k++) {
+                // V_ik * conj(V_jk)
+                sr += v.re[i][k] * v.re[j][k] + v.im[i][k] * v.im[j][k];
+                si += v.im[i][k] * v.re[j][k] - v.re[i][k] * v.im[j][k];
+            }
+            projector.re[i][j] = sr;
+            projector.im[i][j] = si;
+        }
+    }
+}
@@ -2,6 +2,13 @@
 #include <algorithm>
 #include <cstring>
 
+void delta_rows(const uint8_t* __restrict current, const uint8_t* __restrict previous,
+                uint8_t* __restrict out, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<uint8_t>(current[i] - previous[i]);
+    }
+}
+
 bool delta_encode(const uint8_t* current, size_t size, DeltaState& state,
                   std::vector<int8_t>& delta_out) {
     delta_out.resize(size);
@@ -49,6 +56,59 @@ size_t gzip_compress(const void* input, size_t input_size,
     return compressed_size;
 }
 
+size_t gzip_encode(const void* input, size_t input_size,
+                   std::vector<uint8_t>& output, int level) {
+    z_stream stream{};
+    // windowBits 15 + 16 selects the gzip wrapper
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    output.resize(deflateBound(&stream, input_size));
+    stream.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(input));
+    stream.avail_in = static_cast<uInt>(input_size);
+    stream.next_out = output.data();
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    const int result = deflate(&stream, Z_FINISH);
+    const size_t compressed_size = stream.total_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return 0;
+    }
+
+    output.resize(compressed_size);
+    return compressed_size;
+}
+
+size_t deflate_append(DeflateState& state, const void* input, size_t input_size,
+                      std::vector<uint8_t>& output) {
+    if (!state.initialized) {
+        if (deflateInit(&state.stream, Z_BEST_SPEED) != Z_OK) {
+            return 0;
+        }
+        state.initialized = true;
+    } else if (deflateReset(&state.stream) != Z_OK) {
+        return 0;
+    }
+
+    const size_t offset = output.size();
+    output.resize(offset + deflateBound(&state.stream, input_size));
+
+    state.stream.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(input));
+    state.stream.avail_in = static_cast<uInt>(input_size);
+    state.stream.next_out = output.data() + offset;
+    state.stream.avail_out = static_cast<uInt>(output.size() - offset);
+
+    if (deflate(&state.stream, Z_FINISH) != Z_STREAM_END) {
+        output.resize(offset);
+        return 0;  // Compression failed
+    }
+
+    const size_t compressed_size = state.stream.total_out;
+    output.resize(offset + compressed_size);
+    return compressed_size;
+}
+
 size_t compress_with_delta(const uint8_t* data, size_t size, DeltaState& state,
                            std::vector<uint8_t>& compressed_out, bool& is_delta_frame) {
     // Step 1: Apply delta encoding
@@ -1,5 +1,5 @@
 #include "df_processing.h"
-#include "array_calibration.h"
+#include "config.h"
 #include <cmath>
 #include <algorithm>
 #include <chrono>
@@ -72,7 +72,8 @@ static void kalman_update(KalmanState& state, float measurement, float measureme
 }
 
 // Initialize Kalman filter with first measurement
-static void kalman_initialize(KalmanState& state, float initial_azimuth, float initial_variance) {
+static void kalman_initialize(KalmanState& state, float initial_azimuth, float initial_variance,
+                              uint64_t now_ms) {
     state.azimuth = initial_azimuth;
     state.velocity = 0.0f;
 
@@ -83,158 +84,208 @@ static void kalman_initialize(KalmanState& state, float initial_azimuth, float i
     state.P[1][1] = 10.0f;  // Initial velocity uncertainty
 
     state.initialized = true;
-    state.last_update_ms = get_time_ms();
+    state.last_update_ms = now_ms;
 }
 
-DFResult compute_direction_finding(
-    const fftwf_complex* fft_out_ch1,
-    const fftwf_complex* fft_out_ch2,
-    const uint8_t* ch1_mag,
-    const uint8_t* ch2_mag,
-    size_t fft_size,
-    size_t bin_start,
-    size_t bin_end,
-    uint64_t center_freq,
-    LastValidDoA& last_valid,
-    float noise_floor_ch1,
-    float noise_floor_ch2
-) {
-    // Detect selection changes and reset bearing hold
-    if (last_valid.has_valid &&
-        (last_valid.last_start_bin != static_cast<uint32_t>(bin_start) ||
-         last_valid.last_end_bin != static_cast<uint32_t>(bin_end))) {
-        last_valid.has_valid = false;
+// Elapsed time since the last filter step, clamped to a reasonable range (seconds)
+static float kalman_dt(const KalmanState& state, uint64_t now_ms) {
+    const float dt = (now_ms - state.last_update_ms) / 1000.0f;
+    return std::max(0.001f, std::min(dt, 1.0f));
+}
+
+float update_bearing_track(KalmanState& state, float azimuth, float phase_std_deg, uint64_t now_ms) {
+    // Measurement variance based on phase standard deviation
+    // Lower std_dev = more confident measurement
+    const float measurement_variance = std::max(1.0f, phase_std_deg * phase_std_deg);
+
+    if (!state.initialized) {
+        // Initialize Kalman filter with first good measurement
+        kalman_initialize(state, azimuth, measurement_variance, now_ms);
+    } else {
+        kalman_predict(state, kalman_dt(state, now_ms));
+        kalman_update(state, azimuth, measurement_variance);
     }
 
-    // Calculate bin count for statistics
-    const size_t bin_count = (bin_end >= bin_start) ? (bin_end - bin_start + 1) : 1;
+    state.last_update_ms = now_ms;
+    return state.azimuth;
+}
 
-    // ===== CA-CFAR SIGNAL DETECTION =====
-    // Use bandwidth-integrated CFAR to detect real signals, reject noise spikes and DC
+float coast_bearing_track(KalmanState& state, uint64_t now_ms) {
+    kalman_predict(state, kalman_dt(state, now_ms));
+    state.last_update_ms = now_ms;
+    return state.azimuth;
+}
 
-    // Detect signal regions using CFAR with dynamic noise floor if available
-    std::vector<SignalRegion> detected_signals;
-    if (noise_floor_ch1 >= 0.0f && noise_floor_ch2 >= 0.0f) {
-        detected_signals = detect_signals_cfar_with_floor(ch1_mag, ch2_mag, fft_size,
-                                                          DEFAULT_CFAR, bin_start, bin_end,
-                                                          noise_floor_ch1, noise_floor_ch2);
-    } else {
-        detected_signals = detect_signals_cfar(ch1_mag, ch2_mag, fft_size,
-                                              DEFAULT_CFAR, bin_start, bin_end);
+// Cross-spectrum reduction over n bins, optionally rotating each bin by its calibration phasor
+// Independent lane accumulators let the compiler vectorize the reduction
+// without reassociating float sums (no -ffast-math needed)
+template <bool Calibrated>
+static void cross_spectrum_kernel(const float* __restrict a, const float* __restrict b,
+                                  const float* __restrict rot, size_t n, CrossSpectrum& acc) {
+    constexpr size_t LANES = 8;
+    float re[LANES] = {}, im[LANES] = {}, p1[LANES] = {}, p2[LANES] = {};
+
+    auto bin = [&](size_t k, size_t l) {
+        const float ar = a[k * 2], ai = a[k * 2 + 1];
+        const float br = b[k * 2], bi = b[k * 2 + 1];
+        float cr = br * ar + bi * ai;
+        float ci = bi * ar - br * ai;
+        if (Calibrated) {
+            const float wr = rot[k * 2], wi = rot[k * 2 + 1];
+            const float tr = cr * wr - ci * wi;
+            ci = cr * wi + ci * wr;
+            cr = tr;
+        }
+        re[l] += cr;
+        im[l] += ci;
+        p1[l] += ar * ar + ai * ai;
+        p2[l] += br * br + bi * bi;
+    };
+
+    size_t k = 0;
+    for (; k + LANES <= n; k += LANES) {
+        for (size_t l = 0; l < LANES; l++) {
+            bin(k + l, l);
+        }
+    }
+    for (; k < n; k++) {
+        bin(k, 0);
     }
 
-    // Collect all bins from detected signal regions with their phase differences
-    std::vector<BinInfo> strong_bins;
-    strong_bins.reserve(fft_size / 4);  // Preallocate reasonable size
+    for (size_t l = 0; l < LANES; l++) {
+        acc.re += re[l];
+        acc.im += im[l];
+        acc.power_ch1 += p1[l];
+        acc.power_ch2 += p2[l];
+    }
+    acc.bins += n;
+}
 
-    for (const auto& signal : detected_signals) {
-        // For each detected signal region, extract phase information from all bins
-        std::vector<float> raw_phase_diffs;
-        raw_phase_diffs.reserve(signal.end_bin - signal.start_bin + 1);
+void accumulate_cross_spectrum(const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                               size_t bin_start, size_t bin_end, CrossSpectrum& acc,
+                               const float* cal_phasor) {
+    if (bin_end < bin_start) return;
 
-        for (size_t i = signal.start_bin; i <= signal.end_bin; i++) {
-            // Compute phase from FFT output (frequency domain)
-            const float phase1 = atan2f(fft_out_ch1[i][1], fft_out_ch1[i][0]);
-            const float phase2 = atan2f(fft_out_ch2[i][1], fft_out_ch2[i][0]);
+    const float* a = reinterpret_cast<const float*>(fft_ch1 + bin_start);
+    const float* b = reinterpret_cast<const float*>(fft_ch2 + bin_start);
+    const size_t n = bin_end - bin_start + 1;
 
-            // Phase difference (CH2 - CH1)
-            float diff = phase2 - phase1;
+    if (cal_phasor) {
+        cross_spectrum_kernel<true>(a, b, cal_phasor + bin_start * 2, n, acc);
+    } else {
+        cross_spectrum_kernel<false>(a, b, nullptr, n, acc);
+    }
+}
 
-            // Initial wrap to [-π, π]
-            while (diff > M_PI) diff -= 2.0f * M_PI;
-            while (diff < -M_PI) diff += 2.0f * M_PI;
+void init_cross_spectral_matrix(CrossSpectralMatrix& csm, size_t start_bin, size_t bins,
+                                uint32_t integration_frames) {
+    csm.start_bin = start_bin;
+    csm.bins = bins;
+    csm.integration_frames = std::max<uint32_t>(integration_frames, 1);
+    csm.frames = 0;
+    csm.center_freq = 0;
+    csm.s11.assign(bins, 0.0f);
+    csm.s22.assign(bins, 0.0f);
+    csm.s12_re.assign(bins, 0.0f);
+    csm.s12_im.assign(bins, 0.0f);
+}
 
-            raw_phase_diffs.push_back(diff);
-        }
+void update_cross_spectral_matrix(CrossSpectralMatrix& csm, const fftwf_complex* fft_ch1,
+                                  const fftwf_complex* fft_ch2, uint64_t center_freq) {
+    // A retune would mix two different scenes into one estimate
+    if (center_freq != csm.center_freq) {
+        csm.center_freq = center_freq;
+        csm.frames = 0;
+    }
 
-        // Phase unwrapping for wideband signals (Itoh's method)
-        // Corrects phase jumps across frequency bins for signals wider than one wavelength
-        if (raw_phase_diffs.size() > 1) {
-            for (size_t j = 1; j < raw_phase_diffs.size(); j++) {
-                float phase_jump = raw_phase_diffs[j] - raw_phase_diffs[j-1];
-
-                // Detect and correct 2π jumps
-                if (phase_jump > M_PI) {
-                    // Positive jump - unwrap by subtracting 2π
-                    for (size_t k = j; k < raw_phase_diffs.size(); k++) {
-                        raw_phase_diffs[k] -= 2.0f * M_PI;
-                    }
-                } else if (phase_jump < -M_PI) {
-                    // Negative jump - unwrap by adding 2π
-                    for (size_t k = j; k < raw_phase_diffs.size(); k++) {
-                        raw_phase_diffs[k] += 2.0f * M_PI;
-                    }
-                }
-            }
-        }
+    // Plain averaging until K frames are in, then EWMA with alpha = 1/K
+    // (the first frame overwrites whatever was left from before a reset)
+    csm.frames = std::min(csm.frames + 1, csm.integration_frames);
+    const float alpha = 1.0f / csm.frames;
+    const float keep = 1.0f - alpha;
+
+    const float* __restrict a = reinterpret_cast<const float*>(fft_ch1 + csm.start_bin);
+    const float* __restrict b = reinterpret_cast<const float*>(fft_ch2 + csm.start_bin);
+    float* __restrict s11 = csm.s11.data();
+    float* __restrict s22 = csm.s22.data();
+    float* __restrict s12_re = csm.s12_re.data();
+    float* __restrict s12_im = csm.s12_im.data();
+
+    for (size_t k = 0; k < csm.bins; k++) {
+        const float ar = a[k * 2], ai = a[k * 2 + 1];
+        const float br = b[k * 2], bi = b[k * 2 + 1];
+        s11[k] = keep * s11[k] + alpha * (ar * ar + ai * ai);
+        s22[k] = keep * s22[k] + alpha * (br * br + bi * bi);
+        s12_re[k] = keep * s12_re[k] + alpha * (br * ar + bi * ai);
+        s12_im[k] = keep * s12_im[k] + alpha * (bi * ar - br * ai);
+    }
+}
 
-        // Store unwrapped phases with magnitude weighting
-        for (size_t j = 0; j < raw_phase_diffs.size(); j++) {
-            size_t i = signal.start_bin + j;
-            const float avg_mag = (ch1_mag[i] + ch2_mag[i]) / 2.0f;
-            strong_bins.push_back({i, avg_mag, raw_phase_diffs[j]});
+void accumulate_cross_spectral_matrix(const CrossSpectralMatrix& csm, size_t bin_start, size_t bin_end,
+                                      CrossSpectrum& acc, const float* cal_phasor) {
+    const size_t first = std::max(bin_start, csm.start_bin);
+    const size_t last = std::min(bin_end, csm.start_bin + csm.bins - 1);
+    if (csm.bins == 0 || csm.frames == 0 || last < first) return;
+
+    const size_t offset = first - csm.start_bin;
+    const size_t n = last - first + 1;
+    float re = 0.0f, im = 0.0f, p1 = 0.0f, p2 = 0.0f;
+    for (size_t k = offset; k < offset + n; k++) {
+        float cr = csm.s12_re[k];
+        float ci = csm.s12_im[k];
+        if (cal_phasor) {
+            // Calibration is applied on read, so the integration survives calibration changes
+            const float wr = cal_phasor[(csm.start_bin + k) * 2];
+            const float wi = cal_phasor[(csm.start_bin + k) * 2 + 1];
+            const float tr = cr * wr - ci * wi;
+            ci = cr * wi + ci * wr;
+            cr = tr;
         }
+        re += cr;
+        im += ci;
+        p1 += csm.s11[k];
+        p2 += csm.s22[k];
     }
+    acc.re += re;
+    acc.im += im;
+    acc.power_ch1 += p1;
+    acc.power_ch2 += p2;
+    acc.bins += n;
+}
 
-    // Calculate statistics for debugging
-    uint32_t magnitude_sum = 0;
-    uint8_t peak_mag = 0;
-    for (size_t i = bin_start; i <= bin_end; i++) {
-        const uint8_t avg_mag = (ch1_mag[i] + ch2_mag[i]) / 2;
-        magnitude_sum += avg_mag;
-        if (avg_mag > peak_mag) peak_mag = avg_mag;
-    }
-    const uint8_t mean_mag = magnitude_sum / bin_count;
+float noise_power_from_floor(float noise_floor_ch1, float noise_floor_ch2) {
+    if (noise_floor_ch1 < 0.0f || noise_floor_ch2 < 0.0f) return 0.0f;
 
-    constexpr size_t min_bins_for_df = 3;  // Need at least 3 bins for reliable DF
+    // Convert noise floor from 0-255 magnitude scale to power
+    // Magnitude scale: 0-255 represents -120 to 0 dBm (120 dB range)
+    // Approximate conversion: magnitude relates to power logarithmically
+    // Use empirical scaling based on FFT output characteristics
+    const float avg_noise_mag = (noise_floor_ch1 + noise_floor_ch2) / 2.0f;
+    const float noise_scale = 1e-6f;  // Scaling factor for FFT power units
+    return noise_scale * avg_noise_mag * avg_noise_mag;
+}
 
+BearingMeasurement estimate_bearing(const CrossSpectrum& cross, float noise_power) {
     // Default values if no strong signals present
     float avg_phase_diff_rad = 0.0f;
     float avg_phase_diff_deg = 0.0f;
     float std_dev_rad = M_PI;  // Maximum uncertainty
     float std_dev_deg = 180.0f;
+    double msc = 0.0;
 
-    if (strong_bins.size() >= min_bins_for_df) {
-        // Compute weighted average phase difference
-        // Weight by signal magnitude for better accuracy on strong signals
-        float weighted_sum = 0.0f;
-        float weight_total = 0.0f;
-
-        for (const auto& bin : strong_bins) {
-            const float weight = bin.magnitude;
-            weighted_sum += bin.phase_diff * weight;
-            weight_total += weight;
-        }
-
-        avg_phase_diff_rad = weighted_sum / weight_total;
+    if (cross.bins >= DFConfig::MIN_BINS_FOR_DF) {
+        // Array calibration (per-bin phase error) is already applied to the cross-spectrum
+        avg_phase_diff_rad = static_cast<float>(std::atan2(cross.im, cross.re));
         avg_phase_diff_deg = avg_phase_diff_rad * 180.0f / M_PI;
 
-        // Apply array calibration correction (frequency-dependent phase error)
-        const float phase_correction = get_phase_correction(center_freq);
-        avg_phase_diff_deg += phase_correction;
-        avg_phase_diff_rad = avg_phase_diff_deg * M_PI / 180.0f;
-
-        // Calculate weighted standard deviation using Welford's algorithm (numerically stable)
-        float M = 0.0f;  // Running mean
-        float S = 0.0f;  // Running sum of squared differences
-        float W = 0.0f;  // Running sum of weights
-
-        for (const auto& bin : strong_bins) {
-            float diff = bin.phase_diff - avg_phase_diff_rad;
-            // Handle phase wrapping
-            while (diff > M_PI) diff -= 2.0f * M_PI;
-            while (diff < -M_PI) diff += 2.0f * M_PI;
-
-            const float weight = bin.magnitude;
-            W += weight;
-
-            // Numerically stable weighted variance update
-            const float delta = diff - M;
-            M += delta * weight / W;
-            S += weight * delta * (diff - M);
-        }
-
-        std_dev_rad = std::sqrt(S / W);
+        // Phase spread from the coherence of the summed cross-spectrum:
+        // MSC = |sum(X2 X1*)|^2 / (sum|X1|^2 * sum|X2|^2), and for Gaussian phase jitter
+        // MSC = exp(-sigma^2), so sigma = sqrt(-ln(MSC))
+        const double power_product = cross.power_ch1 * cross.power_ch2;
+        msc = (power_product > 0.0) ?
+              (cross.re * cross.re + cross.im * cross.im) / power_product : 0.0;
+        std_dev_rad = std::min(static_cast<float>(std::sqrt(-std::log(std::clamp(msc, 1e-12, 1.0)))),
+                               static_cast<float>(M_PI));
         std_dev_deg = std_dev_rad * 180.0f / M_PI;
     }
 
@@ -274,49 +325,9 @@ DFResult compute_direction_finding(
     azimuth_norm = std::fmod(azimuth_norm + 360.0f, 360.0f);
     back_azimuth_norm = std::fmod(back_azimuth_norm + 360.0f, 360.0f);
 
-    // Calculate SNR estimate from FFT bins (frequency domain)
-    // Use the average power of strong signal bins vs noise floor
-    float signal_power = 0.0f;
-    float noise_power = 0.0f;
-
-    if (strong_bins.size() >= min_bins_for_df) {
-        // Calculate average signal power from strong bins
-        for (const auto& bin : strong_bins) {
-            // Convert FFT output to power: |FFT[k]|^2 = real^2 + imag^2
-            const float real1 = fft_out_ch1[bin.index][0];
-            const float imag1 = fft_out_ch1[bin.index][1];
-            signal_power += (real1 * real1 + imag1 * imag1);
-        }
-        signal_power /= strong_bins.size();
-
-        // Use dynamic noise floor if available, otherwise estimate locally
-        if (noise_floor_ch1 >= 0.0f && noise_floor_ch2 >= 0.0f) {
-            // Convert noise floor from 0-255 magnitude scale to power
-            // Magnitude scale: 0-255 represents -120 to 0 dBm (120 dB range)
-            // noise_mag = 0-255, convert to linear power
-            const float avg_noise_mag = (noise_floor_ch1 + noise_floor_ch2) / 2.0f;
-            // Approximate conversion: magnitude relates to power logarithmically
-            // Use empirical scaling based on FFT output characteristics
-            const float noise_scale = 1e-6f;  // Scaling factor for FFT power units
-            noise_power = noise_scale * avg_noise_mag * avg_noise_mag;
-        } else {
-            // Fallback: Estimate noise floor from bins below mean (noise reference)
-            size_t noise_bin_count = 0;
-            for (size_t i = bin_start; i <= bin_end; i++) {
-                const uint8_t avg_mag = (ch1_mag[i] + ch2_mag[i]) / 2;
-                if (avg_mag <= mean_mag) {  // Use bins at or below mean as noise reference
-                    const float real1 = fft_out_ch1[i][0];
-                    const float imag1 = fft_out_ch1[i][1];
-                    noise_power += (real1 * real1 + imag1 * imag1);
-                    noise_bin_count++;
-                }
-            }
-
-            if (noise_bin_count > 0) {
-                noise_power /= noise_bin_count;
-            }
-        }
-    }
+    // SNR estimate: average CH1 power of the measured bins vs the noise power
+    const float signal_power = (cross.bins >= DFConfig::MIN_BINS_FOR_DF) ?
+                               static_cast<float>(cross.power_ch1 / cross.bins) : 0.0f;
 
     // Calculate SNR in dB: 10*log10(signal_power / noise_power)
     const float snr_db = (noise_power > 0.0f && signal_power > 0.0f) ?
@@ -341,73 +352,124 @@ DFResult compute_direction_finding(
     // Calculate coherence metric (exponential decay with std_dev)
     const float coherence = std::exp(-std_dev_deg / 10.0f);
 
+    return BearingMeasurement{
+        .azimuth = azimuth_norm,
+        .back_azimuth = back_azimuth_norm,
+        .phase_diff_deg = avg_phase_diff_deg,
+        .phase_std_deg = std_dev_deg,
+        .confidence = confidence,
+        .snr_db = snr_db,
+        .coherence = coherence,
+        .msc = static_cast<float>(std::min(msc, 1.0)),
+        .num_bins = cross.bins
+    };
+}
+
+DFResult compute_direction_finding(
+    const fftwf_complex* fft_out_ch1,
+    const fftwf_complex* fft_out_ch2,
+    const uint8_t* ch1_mag,
+    const uint8_t* ch2_mag,
+    size_t bin_start,
+    size_t bin_end,
+    const std::vector<SignalRegion>& regions,
+    const float* cal_phasor,
+    LastValidDoA& last_valid,
+    float noise_floor_ch1,
+    float noise_floor_ch2
+) {
+    // Detect selection changes and reset bearing hold
+    if (last_valid.has_valid &&
+        (last_valid.last_start_bin != static_cast<uint32_t>(bin_start) ||
+         last_valid.last_end_bin != static_cast<uint32_t>(bin_end))) {
+        last_valid.has_valid = false;
+    }
+
+    // Calculate bin count for statistics
+    const size_t bin_count = (bin_end >= bin_start) ? (bin_end - bin_start + 1) : 1;
+
+    // Cross-spectrum X2 * conj(X1) summed over the detected regions inside the DF range.
+    // Averaging in the complex domain weights each bin by |X1||X2| and needs no unwrapping,
+    // so the phase is taken with a single atan2 no matter how many bins the signals span.
+    // Detection (CFAR) is done once per frame by the caller and shared with other consumers.
+    CrossSpectrum cross = {};
+    size_t num_signals = 0;
+    for (const auto& signal : regions) {
+        const size_t start = std::max(signal.start_bin, bin_start);
+        const size_t end = std::min(signal.end_bin, bin_end);
+        if (start > end) continue;
+        accumulate_cross_spectrum(fft_out_ch1, fft_out_ch2, start, end, cross, cal_phasor);
+        num_signals++;
+    }
+
+    // Use dynamic noise floor if available, otherwise estimate locally
+    float noise_power = noise_power_from_floor(noise_floor_ch1, noise_floor_ch2);
+    if (cross.bins >= DFConfig::MIN_BINS_FOR_DF && noise_power <= 0.0f) {
+        // Fallback: Estimate noise floor from bins below mean (noise reference)
+        uint32_t magnitude_sum = 0;
+        for (size_t i = bin_start; i <= bin_end; i++) {
+            magnitude_sum += (ch1_mag[i] + ch2_mag[i]) / 2;
+        }
+        const uint8_t mean_mag = magnitude_sum / bin_count;
+
+        size_t noise_bin_count = 0;
+        for (size_t i = bin_start; i <= bin_end; i++) {
+            const uint8_t avg_mag = (ch1_mag[i] + ch2_mag[i]) / 2;
+            if (avg_mag <= mean_mag) {  // Use bins at or below mean as noise reference
+                const float real1 = fft_out_ch1[i][0];
+                const float imag1 = fft_out_ch1[i][1];
+                noise_power += (real1 * real1 + imag1 * imag1);
+                noise_bin_count++;
+            }
+        }
+
+        if (noise_bin_count > 0) {
+            noise_power /= noise_bin_count;
+        }
+    }
+
+    const BearingMeasurement m = estimate_bearing(cross, noise_power);
+
     // Apply Kalman filter for smooth bearing tracking
     // This reduces jitter and provides predictive capability
-    constexpr float MIN_CONFIDENCE_THRESHOLD = 20.0f;  // Minimum confidence to report new bearing
-
-    bool use_current_result = (confidence >= MIN_CONFIDENCE_THRESHOLD &&
-                               strong_bins.size() >= min_bins_for_df);
-
-    float final_azimuth = azimuth_norm;
-    float final_back_azimuth = back_azimuth_norm;
-    float final_phase_diff = avg_phase_diff_deg;
-    float final_phase_std = std_dev_deg;
-    float final_confidence = confidence;
-    float final_snr = snr_db;
-    float final_coherence = coherence;
+    bool use_current_result = (m.confidence >= DFConfig::MIN_CONFIDENCE_THRESHOLD && cross.bins >= DFConfig::MIN_BINS_FOR_DF);
+
+    float final_azimuth = m.azimuth;
+    float final_back_azimuth = m.back_azimuth;
+    float final_phase_diff = m.phase_diff_deg;
+    float final_phase_std = m.phase_std_deg;
+    float final_confidence = m.confidence;
+    float final_snr = m.snr_db;
+    float final_coherence = m.coherence;
     bool is_holding = false;
 
     // Get current time for Kalman filter
     uint64_t current_time_ms = get_time_ms();
 
     if (use_current_result) {
-        // Measurement variance based on phase standard deviation
-        // Lower std_dev = more confident measurement
-        float measurement_variance = std::max(1.0f, std_dev_deg * std_dev_deg);
-
-        if (!last_valid.kalman.initialized) {
-            // Initialize Kalman filter with first good measurement
-            kalman_initialize(last_valid.kalman, azimuth_norm, measurement_variance);
-            final_azimuth = azimuth_norm;
-        } else {
-            // Kalman filter predict + update
-            float dt = (current_time_ms - last_valid.kalman.last_update_ms) / 1000.0f; // Convert to seconds
-            dt = std::max(0.001f, std::min(dt, 1.0f));  // Clamp to reasonable range
-
-            kalman_predict(last_valid.kalman, dt);
-            kalman_update(last_valid.kalman, azimuth_norm, measurement_variance);
-
-            // Use Kalman filtered azimuth
-            final_azimuth = last_valid.kalman.azimuth;
-
-            // Update back azimuth to maintain 180° offset
+        const bool first_measurement = !last_valid.kalman.initialized;
+        final_azimuth = update_bearing_track(last_valid.kalman, m.azimuth, m.phase_std_deg, current_time_ms);
+
+        // Update back azimuth to maintain 180° offset once the filter is running
+        if (!first_measurement) {
             final_back_azimuth = std::fmod(final_azimuth + 180.0f, 360.0f);
         }
 
-        last_valid.kalman.last_update_ms = current_time_ms;
-
         // Store this as the new valid result
         last_valid.has_valid = true;
         last_valid.azimuth = final_azimuth;
         last_valid.back_azimuth = final_back_azimuth;
-        last_valid.phase_diff_deg = avg_phase_diff_deg;
-        last_valid.phase_std_deg = std_dev_deg;
-        last_valid.confidence = confidence;
-        last_valid.snr_db = snr_db;
-        last_valid.coherence = coherence;
+        last_valid.phase_diff_deg = m.phase_diff_deg;
+        last_valid.phase_std_deg = m.phase_std_deg;
+        last_valid.confidence = m.confidence;
+        last_valid.snr_db = m.snr_db;
+        last_valid.coherence = m.coherence;
         last_valid.last_start_bin = static_cast<uint32_t>(bin_start);
         last_valid.last_end_bin = static_cast<uint32_t>(bin_end);
 
     } else if (last_valid.has_valid && last_valid.kalman.initialized) {
         // No good measurement, but we have Kalman state - use prediction only
-        float dt = (current_time_ms - last_valid.kalman.last_update_ms) / 1000.0f;
-        dt = std::max(0.001f, std::min(dt, 1.0f));
-
-        kalman_predict(last_valid.kalman, dt);
-        last_valid.kalman.last_update_ms = current_time_ms;
-
-        // Use predicted azimuth
-        final_azimuth = last_valid.kalman.azimuth;
+        final_azimuth = coast_bearing_track(last_valid.kalman, current_time_ms);
         final_back_azimuth = std::fmod(final_azimuth + 180.0f, 360.0f);
         final_phase_diff = last_valid.phase_diff_deg;
         final_phase_std = last_valid.phase_std_deg;
@@ -438,7 +500,7 @@ DFResult compute_direction_finding(
         .snr_db = final_snr,
         .coherence = final_coherence,
         .is_holding = is_holding,
-        .num_bins = strong_bins.size(),
-        .num_signals = detected_signals.size()
+        .num_bins = cross.bins,
+        .num_signals = num_signals
     };
 }
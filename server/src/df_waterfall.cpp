@@ -0,0 +1,217 @@
+#include "df_waterfall.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+// Published row history (written by analysis thread, read by web server)
+static std::vector<uint8_t> g_dfw_history;     // HISTORY_ROWS x columns ring
+static size_t g_dfw_columns = 0;
+static uint64_t g_dfw_sequence = 0;            // Rows written so far (row N lives at (N - 1) % HISTORY_ROWS)
+static std::mutex g_dfw_mutex;
+static std::atomic<uint64_t> g_dfw_last_request_us{0};
+
+static uint64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Bitwise select (mask all ones -> a, all zeros -> b)
+static inline float select_float(uint32_t mask, float a, float b) {
+    uint32_t ab, bb;
+    memcpy(&ab, &a, sizeof(ab));
+    memcpy(&bb, &b, sizeof(bb));
+    const uint32_t rb = (ab & mask) | (bb & ~mask);
+    float r;
+    memcpy(&r, &rb, sizeof(r));
+    return r;
+}
+
+// atan2 via a polynomial on [0, 1] plus octant fix-ups (|error| < 2e-4 rad, far below
+// the azimuth quantization). Comparisons are done on the bit patterns and selects are
+// bitwise, so the column loop vectorizes without relaxing floating-point trapping rules.
+static inline float fast_atan2(float y, float x) {
+    uint32_t xb, yb;
+    memcpy(&xb, &x, sizeof(xb));
+    memcpy(&yb, &y, sizeof(yb));
+    const uint32_t axb = xb & 0x7FFFFFFFu;
+    const uint32_t ayb = yb & 0x7FFFFFFFu;
+    const bool swap = ayb > axb;            // Non-negative floats order like their bit patterns
+    const uint32_t mxb = swap ? ayb : axb;
+    const uint32_t mnb = swap ? axb : ayb;
+    float mx, mn;
+    memcpy(&mx, &mxb, sizeof(mx));
+    memcpy(&mn, &mnb, sizeof(mn));
+
+    const float a = mn / (mx + 1e-30f);
+    const float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    r = select_float(0u - static_cast<uint32_t>(swap), 1.57079637f - r, r);
+    r = select_float(0u - (xb >> 31), 3.14159274f - r, r);
+
+    // Result takes the sign of y
+    uint32_t rb;
+    memcpy(&rb, &r, sizeof(rb));
+    rb |= yb & 0x80000000u;
+    memcpy(&r, &rb, sizeof(r));
+    return r;
+}
+
+void init_df_waterfall(DFWaterfallState& state, size_t fft_size) {
+    state.fft_size = fft_size;
+    state.columns = fft_size / DFWaterfallConfig::GROUP_BINS;
+    state.phase.assign(state.columns, 0.0f);
+    state.level.assign(state.columns, 0);
+    state.row.assign(state.columns, 0);
+    state.rows_computed = 0;
+
+    // Interferometer with 0.5 wavelength spacing: sin(theta) = dphi / pi
+    // Entry i covers dphi = -pi + 2*pi*i/(N-1); azimuth -90..+90 maps to bytes 1..255
+    constexpr size_t n = DFWaterfallConfig::ASIN_LUT_SIZE;
+    state.asin_lut.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        const double sin_theta = -1.0 + 2.0 * i / (n - 1);
+        const double theta_deg = std::asin(std::clamp(sin_theta, -1.0, 1.0)) * 180.0 / M_PI;
+        state.asin_lut[i] = static_cast<uint8_t>(1.0 + std::lround((theta_deg + 90.0) / 180.0 * 254.0));
+    }
+
+    std::lock_guard<std::mutex> lock(g_dfw_mutex);
+    g_dfw_columns = state.columns;
+    g_dfw_history.assign(DFWaterfallConfig::HISTORY_ROWS * state.columns, 0);
+    g_dfw_sequence = 0;
+}
+
+bool df_waterfall_active() {
+    const uint64_t last_request = g_dfw_last_request_us.load(std::memory_order_relaxed);
+    return last_request != 0 && steady_now_us() - last_request < DFWaterfallConfig::CLIENT_TIMEOUT_US;
+}
+
+// Group cross-spectrum X2 * conj(X1), optionally calibrated, and its phase per column
+template <bool Calibrated>
+static void column_phases(const float* __restrict a, const float* __restrict b, const float* __restrict rot,
+                          size_t columns, float* __restrict phase) {
+    constexpr size_t G = DFWaterfallConfig::GROUP_BINS;
+    for (size_t c = 0; c < columns; c++) {
+        float re = 0.0f, im = 0.0f;
+        for (size_t g = 0; g < G; g++) {
+            const size_t k = c * G + g;
+            const float ar = a[k * 2], ai = a[k * 2 + 1];
+            const float br = b[k * 2], bi = b[k * 2 + 1];
+            float cr = br * ar + bi * ai;
+            float ci = bi * ar - br * ai;
+            if (Calibrated) {
+                const float wr = rot[k * 2], wi = rot[k * 2 + 1];
+                const float tr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = tr;
+            }
+            re += cr;
+            im += ci;
+        }
+        phase[c] = fast_atan2(im, re);
+    }
+}
+
+void update_df_waterfall(DFWaterfallState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                         const uint8_t* ch1_mag, const uint8_t* ch2_mag, float noise_floor,
+                         const float* cal_phasor) {
+    constexpr size_t G = DFWaterfallConfig::GROUP_BINS;
+    const size_t columns = state.columns;
+    const float* a = reinterpret_cast<const float*>(fft_ch1);
+    const float* b = reinterpret_cast<const float*>(fft_ch2);
+    float* phase = state.phase.data();
+    uint8_t* __restrict level = state.level.data();
+
+    // Pass 1: phase and peak level per column
+    if (cal_phasor) {
+        column_phases<true>(a, b, cal_phasor, columns, phase);
+    } else {
+        column_phases<false>(a, b, nullptr, columns, phase);
+    }
+    for (size_t c = 0; c < columns; c++) {
+        uint8_t peak = 0;
+        for (size_t g = 0; g < G; g++) {
+            const size_t k = c * G + g;
+            peak = std::max(peak, static_cast<uint8_t>((ch1_mag[k] + ch2_mag[k]) >> 1));
+        }
+        level[c] = peak;
+    }
+
+    // Pass 2: gate on level and map phase to azimuth through the lookup table
+    const float gate = (noise_floor >= 0.0f) ? noise_floor + DFWaterfallConfig::GATE_MARGIN
+                                             : DFWaterfallConfig::GATE_MARGIN;
+    const float lut_scale = (DFWaterfallConfig::ASIN_LUT_SIZE - 1) / (2.0f * static_cast<float>(M_PI));
+    const uint8_t* lut = state.asin_lut.data();
+    uint8_t* row = state.row.data();
+    for (size_t c = 0; c < columns; c++) {
+        const int index = static_cast<int>((phase[c] + static_cast<float>(M_PI)) * lut_scale + 0.5f);
+        const uint8_t azimuth = lut[std::clamp(index, 0, static_cast<int>(DFWaterfallConfig::ASIN_LUT_SIZE - 1))];
+        row[c] = (level[c] > gate) ? azimuth : 0;
+    }
+    state.rows_computed++;
+
+    std::lock_guard<std::mutex> lock(g_dfw_mutex);
+    const size_t slot = g_dfw_sequence % DFWaterfallConfig::HISTORY_ROWS;
+    memcpy(g_dfw_history.data() + slot * columns, row, columns);
+    g_dfw_sequence++;
+}
+
+// Append one row coded against the previous one
+static void encode_row(const uint8_t* row, const uint8_t* prev, size_t columns, std::vector<uint8_t>& out) {
+    const size_t length_pos = out.size();
+    out.push_back(0);
+    out.push_back(0);
+
+    size_t c = 0;
+    while (c < columns) {
+        const uint8_t delta = static_cast<uint8_t>(row[c] - prev[c]);
+        if (delta != 0) {
+            out.push_back(delta);
+            c++;
+            continue;
+        }
+        size_t run = 1;
+        while (c + run < columns && run < 255 && row[c + run] == prev[c + run]) {
+            run++;
+        }
+        out.push_back(0);
+        out.push_back(static_cast<uint8_t>(run));
+        c += run;
+    }
+
+    const size_t length = out.size() - length_pos - 2;
+    out[length_pos] = static_cast<uint8_t>(length & 0xFF);
+    out[length_pos + 1] = static_cast<uint8_t>(length >> 8);
+}
+
+void get_df_waterfall_rows(uint64_t since_sequence, std::vector<uint8_t>& out, size_t& rows,
+                           uint64_t& last_sequence) {
+    // Renew the subscription so the analysis thread keeps computing rows
+    g_dfw_last_request_us.store(steady_now_us(), std::memory_order_relaxed);
+
+    out.clear();
+    std::lock_guard<std::mutex> lock(g_dfw_mutex);
+    const size_t columns = g_dfw_columns;
+    const uint64_t available = g_dfw_sequence - std::min(since_sequence, g_dfw_sequence);
+    rows = static_cast<size_t>(std::min<uint64_t>(
+        available, std::min(DFWaterfallConfig::HISTORY_ROWS, DFWaterfallConfig::MAX_ROWS_PER_REQUEST)));
+    last_sequence = g_dfw_sequence;
+
+    // Worst case is 2 bytes per column plus the length prefix
+    out.reserve(rows * (2 * columns + 2));
+    const std::vector<uint8_t> zero_row(columns, 0);
+    const uint8_t* prev = zero_row.data();
+    for (size_t r = 0; r < rows; r++) {
+        const uint64_t seq = g_dfw_sequence - rows + r;
+        const uint8_t* row = g_dfw_history.data() + (seq % DFWaterfallConfig::HISTORY_ROWS) * columns;
+        encode_row(row, prev, columns, out);
+        prev = row;
+    }
+}
+
+size_t get_df_waterfall_columns() {
+    std::lock_guard<std::mutex> lock(g_dfw_mutex);
+    return g_dfw_columns;
+}
@@ -0,0 +1,232 @@
+#include "gcc_phat.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+// Latest published estimate (written by analysis thread, read by web server)
+static std::string g_gcc_phat_json = "{\"valid\":false}";
+static std::mutex g_gcc_phat_json_mutex;
+
+void init_gcc_phat(GccPhatState& state, size_t fft_size) {
+    state.fft_size = fft_size;
+    state.ifft_in = fftwf_alloc_complex(fft_size);
+    state.ifft_out = fftwf_alloc_complex(fft_size);
+    state.ifft_plan = fftwf_plan_dft_1d(static_cast<int>(fft_size), state.ifft_in, state.ifft_out,
+                                        FFTW_BACKWARD, FFTW_MEASURE);
+    memset(state.ifft_in, 0, fft_size * sizeof(fftwf_complex));
+
+    const double dx = ArrayConfig::ELEMENT_X_M[1] - ArrayConfig::ELEMENT_X_M[0];
+    const double dy = ArrayConfig::ELEMENT_Y_M[1] - ArrayConfig::ELEMENT_Y_M[0];
+    state.baseline_m = std::hypot(dx, dy);
+
+    state.cross_re.assign(fft_size, 0.0f);
+    state.cross_im.assign(fft_size, 0.0f);
+    state.frames = 0;
+    state.frame_counter = 0;
+    state.center_freq = 0;
+    state.start_bin = 0;
+    state.end_bin = 0;
+
+    state.valid = false;
+    state.delay_samples = 0.0f;
+    state.peak_ratio = 0.0f;
+    state.calibrated = false;
+
+    state.skew_initialized = false;
+    state.skew_ns = 0.0f;
+    state.skew_var_ns2 = 0.0f;
+    state.skew_history.assign(GccPhatConfig::SKEW_HISTORY, 0.0f);
+    state.history_index = 0;
+    state.history_count = 0;
+}
+
+void destroy_gcc_phat(GccPhatState& state) {
+    if (state.ifft_plan) fftwf_destroy_plan(state.ifft_plan);
+    fftwf_free(state.ifft_in);
+    fftwf_free(state.ifft_out);
+    state.ifft_plan = nullptr;
+    state.ifft_in = nullptr;
+    state.ifft_out = nullptr;
+}
+
+// EWMA of X2 conj(X1), with RX2 corrected by the calibration phasor when present
+static void accumulate_cross(const float* __restrict x1, const float* __restrict x2, const float* __restrict rot,
+                             float* __restrict acc_re, float* __restrict acc_im, size_t bins, float alpha) {
+    for (size_t b = 0; b < bins; b++) {
+        const float ar = x2[b * 2], ai = x2[b * 2 + 1];
+        const float br = x1[b * 2], bi = x1[b * 2 + 1];
+        float cr = ar * br + ai * bi;
+        float ci = ai * br - ar * bi;
+        if (rot) {
+            const float wr = rot[b * 2];
+            const float wi = rot[b * 2 + 1];
+            const float tr = cr * wr - ci * wi;
+            ci = cr * wi + ci * wr;
+            cr = tr;
+        }
+        acc_re[b] += alpha * (cr - acc_re[b]);
+        acc_im[b] += alpha * (ci - acc_im[b]);
+    }
+}
+
+// Whiten the band into the inverse FFT input, in natural (DC at index 0) bin order
+static void fill_phat(GccPhatState& state) {
+    const size_t n = state.fft_size;
+    const size_t half = n / 2;
+    memset(state.ifft_in, 0, n * sizeof(fftwf_complex));
+    for (size_t k = state.start_bin; k <= state.end_bin; k++) {
+        const float re = state.cross_re[k];
+        const float im = state.cross_im[k];
+        const float inv = 1.0f / (std::sqrt(re * re + im * im) + GccPhatConfig::PHAT_EPSILON);
+        const size_t idx = (k + half) % n;
+        state.ifft_in[idx][0] = re * inv;
+        state.ifft_in[idx][1] = im * inv;
+    }
+}
+
+// Locate the correlation envelope peak, then refine it to a fraction of a sample
+// A parabola through the envelope peak is biased by up to ~0.2 samples on the sinc-shaped
+// PHAT peak, so the fraction comes from the mean bin-to-bin phase step of the whitened
+// cross-spectrum, arg(sum G[k+1] conj(G[k])) = -2 pi delay / N, taking the alias nearest
+// the envelope peak.
+// Returns false if the peak does not stand out from the correlation floor
+static bool find_delay(GccPhatState& state) {
+    const size_t n = state.fft_size;
+    const fftwf_complex* r = state.ifft_out;
+
+    size_t peak = 0;
+    float peak_power = 0.0f;
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const float p = r[i][0] * r[i][0] + r[i][1] * r[i][1];
+        total += p;
+        if (p > peak_power) {
+            peak_power = p;
+            peak = i;
+        }
+    }
+    const double mean = (total - peak_power) / static_cast<double>(n - 1);
+    state.peak_ratio = mean > 0.0 ? static_cast<float>(peak_power / mean) : 0.0f;
+    if (peak_power <= 0.0f || state.peak_ratio < GccPhatConfig::MIN_PEAK_RATIO) return false;
+
+    // Lags past n/2 wrap around to negative delays
+    const double lag = (peak > n / 2) ? static_cast<double>(peak) - static_cast<double>(n) : static_cast<double>(peak);
+
+    double step_re = 0.0, step_im = 0.0;
+    const fftwf_complex* g = state.ifft_in;
+    for (size_t k = state.start_bin; k < state.end_bin; k++) {
+        const size_t i0 = (k + n / 2) % n;
+        const size_t i1 = (k + 1 + n / 2) % n;
+        step_re += g[i1][0] * g[i0][0] + g[i1][1] * g[i0][1];
+        step_im += g[i1][1] * g[i0][0] - g[i1][0] * g[i0][1];
+    }
+    double delay = lag;
+    if (step_re != 0.0 || step_im != 0.0) {
+        const double slope_delay = -std::atan2(step_im, step_re) * static_cast<double>(n) / (2.0 * M_PI);
+        const double residual = slope_delay - lag - std::round((slope_delay - lag) / n) * n;
+        if (std::fabs(residual) <= 1.0) delay = lag + residual;
+    }
+    state.delay_samples = static_cast<float>(delay);
+    return true;
+}
+
+static void update_skew(GccPhatState& state, float delay_ns) {
+    if (!state.skew_initialized) {
+        state.skew_ns = delay_ns;
+        state.skew_var_ns2 = 0.0f;
+        state.skew_initialized = true;
+    } else {
+        const float err = delay_ns - state.skew_ns;
+        state.skew_ns += GccPhatConfig::SKEW_ALPHA * err;
+        state.skew_var_ns2 = (1.0f - GccPhatConfig::SKEW_ALPHA) *
+                             (state.skew_var_ns2 + GccPhatConfig::SKEW_ALPHA * err * err);
+    }
+    state.skew_history[state.history_index] = delay_ns;
+    state.history_index = (state.history_index + 1) % state.skew_history.size();
+    state.history_count = std::min(state.history_count + 1, state.skew_history.size());
+}
+
+static void publish_gcc_phat(const GccPhatState& state, uint32_t sample_rate) {
+    const double ns_per_sample = 1e9 / static_cast<double>(std::max<uint32_t>(sample_rate, 1));
+    const double span_samples = state.baseline_m / ArrayConfig::SPEED_OF_LIGHT * sample_rate;
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"valid\":" << (state.valid ? "true" : "false")
+         << ",\"delaySamples\":" << state.delay_samples
+         << ",\"delayNs\":" << state.delay_samples * ns_per_sample
+         << ",\"peakRatio\":" << state.peak_ratio
+         << ",\"startBin\":" << state.start_bin
+         << ",\"endBin\":" << state.end_bin
+         << ",\"baselineM\":" << state.baseline_m
+         << ",\"maxDelaySamples\":" << span_samples;
+
+    // Bearing only when the baseline spans enough delay to resolve it
+    json << ",\"bearing\":";
+    if (state.valid && span_samples >= GccPhatConfig::MIN_BEARING_SPAN_SAMPLES) {
+        const double sin_theta = std::clamp(-state.delay_samples / span_samples, -1.0, 1.0);
+        json << std::asin(sin_theta) * 180.0 / M_PI;
+    } else {
+        json << "null";
+    }
+
+    json << ",\"calibrated\":" << (state.calibrated ? "true" : "false")
+         << ",\"skewNs\":" << state.skew_ns
+         << ",\"skewStdNs\":" << std::sqrt(state.skew_var_ns2)
+         << ",\"skewHistory\":[";
+    // Oldest first
+    const size_t size = state.skew_history.size();
+    const size_t first = (state.history_index + size - state.history_count) % size;
+    for (size_t i = 0; i < state.history_count; i++) {
+        if (i > 0) json << ",";
+        json << state.skew_history[(first + i) % size];
+    }
+    json << "]}";
+
+    std::lock_guard<std::mutex> lock(g_gcc_phat_json_mutex);
+    g_gcc_phat_json = json.str();
+}
+
+void update_gcc_phat(GccPhatState& state, const fftwf_complex* fft_ch1, const fftwf_complex* fft_ch2,
+                     size_t start_bin, size_t end_bin, uint64_t center_freq, uint32_t sample_rate,
+                     const CalibrationTable& cal_table) {
+    end_bin = std::min(end_bin, state.fft_size - 1);
+    if (start_bin > end_bin) return;
+
+    // Retune or a new band invalidates the integrated cross-spectrum
+    if (center_freq != state.center_freq || start_bin != state.start_bin || end_bin != state.end_bin) {
+        state.center_freq = center_freq;
+        state.start_bin = start_bin;
+        state.end_bin = end_bin;
+        state.frames = 0;
+    }
+
+    state.frames = std::min(state.frames + 1, GccPhatConfig::INTEGRATION_FRAMES);
+    const float alpha = 1.0f / state.frames;
+    state.calibrated = cal_table.enabled;
+    const float* rot = cal_table.enabled ? cal_table.phasor.data() + start_bin * 2 : nullptr;
+    accumulate_cross(reinterpret_cast<const float*>(fft_ch1 + start_bin),
+                     reinterpret_cast<const float*>(fft_ch2 + start_bin), rot,
+                     state.cross_re.data() + start_bin, state.cross_im.data() + start_bin,
+                     end_bin - start_bin + 1, alpha);
+
+    state.frame_counter++;
+    if (state.frame_counter % GccPhatConfig::ESTIMATE_INTERVAL_FRAMES != 0) return;
+
+    fill_phat(state);
+    fftwf_execute(state.ifft_plan);
+    state.valid = find_delay(state);
+    if (state.valid) {
+        update_skew(state, static_cast<float>(state.delay_samples * 1e9 / std::max<uint32_t>(sample_rate, 1)));
+    }
+    publish_gcc_phat(state, sample_rate);
+}
+
+std::string get_gcc_phat_json() {
+    std::lock_guard<std::mutex> lock(g_gcc_phat_json_mutex);
+    return g_gcc_phat_json;
+}
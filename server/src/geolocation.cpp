@@ -0,0 +1,385 @@
+#include "geolocation.h"
+#include "config.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// Platform position history (written by GPS client / manual entry, read by analysis thread)
+struct PositionFix {
+    uint64_t timestamp_us;
+    double latitude;
+    double longitude;
+    double course_deg;             // NaN if unknown or too slow to be meaningful
+    bool manual;
+};
+
+static PositionFix g_fixes[GeolocConfig::POSITION_HISTORY];
+static size_t g_fix_head = 0;      // Next write slot
+static size_t g_fix_count = 0;
+static std::mutex g_fix_mutex;
+
+// Settings (written by web server, snapshotted by analysis thread on change)
+static GeolocSettings g_geoloc_settings = {true, 0.0f, 0.0f};
+static uint64_t g_geoloc_settings_version = 1;
+static std::mutex g_geoloc_settings_mutex;
+static std::atomic<uint64_t> g_geoloc_reset{0};
+static uint64_t g_geoloc_reset_seen = 0;
+
+// Latest published fixes (written by analysis thread, read by web server)
+static std::string g_geoloc_json = "{\"emitters\":[]}";
+static std::mutex g_geoloc_json_mutex;
+
+// Range assumed for the Stansfield weight before a hypothesis has a solution
+static constexpr double NOMINAL_RANGE_M = 1000.0;
+
+static double wrap_degrees(double deg) {
+    deg = std::fmod(deg, 360.0);
+    return deg < 0.0 ? deg + 360.0 : deg;
+}
+
+void record_position_fix(uint64_t timestamp_us, double latitude, double longitude,
+                         double course_deg, double speed_mps, bool manual) {
+    PositionFix fix;
+    fix.timestamp_us = timestamp_us;
+    fix.latitude = latitude;
+    fix.longitude = longitude;
+    fix.course_deg = (std::isfinite(course_deg) && std::isfinite(speed_mps) &&
+                      speed_mps >= GeolocConfig::MIN_SPEED_FOR_COURSE_MPS) ? wrap_degrees(course_deg) : NAN;
+    fix.manual = manual;
+
+    std::lock_guard<std::mutex> lock(g_fix_mutex);
+    // History must stay time-ordered for the interpolation search
+    if (g_fix_count > 0) {
+        const PositionFix& last = g_fixes[(g_fix_head + GeolocConfig::POSITION_HISTORY - 1) % GeolocConfig::POSITION_HISTORY];
+        if (timestamp_us <= last.timestamp_us) return;
+    }
+    g_fixes[g_fix_head] = fix;
+    g_fix_head = (g_fix_head + 1) % GeolocConfig::POSITION_HISTORY;
+    g_fix_count = std::min(g_fix_count + 1, GeolocConfig::POSITION_HISTORY);
+}
+
+// Platform position and course at a timestamp (linear between the bracketing fixes)
+// Returns false if the history does not cover the timestamp
+static bool interpolate_fix(uint64_t timestamp_us, PositionFix& out) {
+    constexpr size_t N = GeolocConfig::POSITION_HISTORY;
+    std::lock_guard<std::mutex> lock(g_fix_mutex);
+    if (g_fix_count == 0) return false;
+
+    const size_t oldest = (g_fix_head + N - g_fix_count) % N;
+    const auto at = [&](size_t i) -> const PositionFix& { return g_fixes[(oldest + i) % N]; };
+
+    const PositionFix& newest = at(g_fix_count - 1);
+    if (timestamp_us >= newest.timestamp_us) {
+        if (!newest.manual && timestamp_us - newest.timestamp_us > GeolocConfig::MAX_EXTRAPOLATION_US) return false;
+        out = newest;
+        return true;
+    }
+    if (timestamp_us < at(0).timestamp_us) return false;
+
+    // First fix after the timestamp
+    size_t lo = 0, hi = g_fix_count - 1;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (at(mid).timestamp_us > timestamp_us) hi = mid; else lo = mid + 1;
+    }
+    const PositionFix& a = at(lo - 1);
+    const PositionFix& b = at(lo);
+    const double f = static_cast<double>(timestamp_us - a.timestamp_us) /
+                     static_cast<double>(b.timestamp_us - a.timestamp_us);
+
+    out.timestamp_us = timestamp_us;
+    out.latitude = a.latitude + f * (b.latitude - a.latitude);
+    out.longitude = a.longitude + f * (b.longitude - a.longitude);
+    out.manual = a.manual && b.manual;
+    if (std::isfinite(a.course_deg) && std::isfinite(b.course_deg)) {
+        const double turn = std::remainder(b.course_deg - a.course_deg, 360.0);
+        out.course_deg = wrap_degrees(a.course_deg + f * turn);
+    } else {
+        out.course_deg = (f < 0.5) ? a.course_deg : b.course_deg;
+    }
+    return true;
+}
+
+void init_geolocation(GeolocState& state) {
+    state.settings = GeolocSettings{true, 0.0f, 0.0f};
+    state.settings_version = 0;
+    state.has_origin = false;
+    state.origin_lat = 0.0;
+    state.origin_lon = 0.0;
+    state.cos_origin_lat = 1.0;
+    state.emitters.assign(GeolocConfig::MAX_EMITTERS, GeolocEmitter{});
+    state.frame_counter = 0;
+}
+
+// Solve the 2x2 normal equations of one hypothesis (closed form)
+static void solve_hypothesis(GeolocHypothesis& h, double east_m, double north_m, double bearing_rad) {
+    h.solved = false;
+    if (h.bearings < GeolocConfig::MIN_BEARINGS) return;
+
+    // Bearing spread: ratio of the normal matrix eigenvalues
+    const double tr = h.a11 + h.a22;
+    const double det = h.a11 * h.a22 - h.a12 * h.a12;
+    const double disc = std::sqrt(std::max(0.0, 0.25 * tr * tr - det));
+    const double l_max = 0.5 * tr + disc;
+    const double l_min = 0.5 * tr - disc;
+    if (l_max <= 0.0 || l_min / l_max < GeolocConfig::MIN_CONDITION) return;
+
+    h.east_m = (h.a22 * h.b1 - h.a12 * h.b2) / det;
+    h.north_m = (h.a11 * h.b2 - h.a12 * h.b1) / det;
+    h.residual = std::max(0.0, h.c - (h.east_m * h.b1 + h.north_m * h.b2));
+    h.in_front = (h.east_m - east_m) * std::sin(bearing_rad) + (h.north_m - north_m) * std::cos(bearing_rad) > 0.0;
+    h.solved = true;
+}
+
+// Rank-one update with one bearing line through the platform position
+static void add_bearing(GeolocHypothesis& h, double east_m, double north_m, double bearing_deg, double sigma_deg) {
+    const double b = bearing_deg * M_PI / 180.0;
+    const double n1 = std::cos(b);
+    const double n2 = -std::sin(b);
+    const double np = n1 * east_m + n2 * north_m;
+
+    const double range = h.solved ? std::max(std::hypot(h.east_m - east_m, h.north_m - north_m),
+                                             GeolocConfig::MIN_RANGE_M)
+                                  : NOMINAL_RANGE_M;
+    const double sigma_m = sigma_deg * M_PI / 180.0 * range;
+    const double w = 1.0 / (sigma_m * sigma_m);
+
+    h.a11 += w * n1 * n1;
+    h.a12 += w * n1 * n2;
+    h.a22 += w * n2 * n2;
+    h.b1 += w * n1 * np;
+    h.b2 += w * n2 * np;
+    h.c += w * np * np;
+    h.bearings++;
+    solve_hypothesis(h, east_m, north_m, b);
+}
+
+// Hypothesis to report: solved, ahead of the bearings, smallest residual (-1 = none)
+static int best_hypothesis(const GeolocEmitter& e) {
+    int best = -1;
+    for (int i = 0; i < 2; i++) {
+        const GeolocHypothesis& h = e.hyp[i];
+        if (!h.solved || !h.in_front) continue;
+        if (best < 0 || h.residual < e.hyp[best].residual) best = i;
+    }
+    return best;
+}
+
+static GeolocEmitter* find_emitter(GeolocState& state, uint32_t track_id, uint64_t timestamp_us) {
+    GeolocEmitter* free_slot = nullptr;
+    GeolocEmitter* oldest = nullptr;
+    for (auto& e : state.emitters) {
+        if (e.track_id == track_id) return &e;
+        if (e.track_id == 0) {
+            if (!free_slot) free_slot = &e;
+        } else if (!oldest || e.last_us < oldest->last_us) {
+            oldest = &e;
+        }
+    }
+    GeolocEmitter* slot = free_slot ? free_slot : oldest;
+    *slot = GeolocEmitter{};
+    slot->track_id = track_id;
+    slot->first_us = timestamp_us;
+    return slot;
+}
+
+// Bearing standard deviation from the phase spread: sin(theta) = dphi / pi for a
+// lambda/2 pair, so d(theta) = d(dphi) / (pi cos(theta))
+static double bearing_sigma_deg(const BearingTrack& track) {
+    const double cos_theta = std::max(std::fabs(std::cos(track.azimuth * M_PI / 180.0)), 0.2);
+    return std::clamp(track.last.phase_std_deg / (M_PI * cos_theta),
+                      static_cast<double>(GeolocConfig::MIN_BEARING_SIGMA_DEG),
+                      static_cast<double>(GeolocConfig::MAX_BEARING_SIGMA_DEG));
+}
+
+static void process_track(GeolocState& state, const BearingTrack& track, uint64_t timestamp_us,
+                          double freq_hz) {
+    if (track.id == 0 || track.holding || !track.kalman.initialized) return;
+    if (track.last.confidence < DFConfig::MIN_CONFIDENCE_THRESHOLD) return;
+
+    GeolocEmitter* e = nullptr;
+    for (auto& slot : state.emitters) {
+        if (slot.track_id == track.id) {
+            e = &slot;
+            break;
+        }
+    }
+    if (e) {
+        if (e->track_updates == track.updates) return;  // No new measurement
+        e->track_updates = track.updates;
+        if (timestamp_us - e->last_us < GeolocConfig::MIN_BEARING_INTERVAL_US) return;
+    }
+
+    PositionFix pose;
+    if (!interpolate_fix(timestamp_us, pose)) return;
+
+    double heading = state.settings.fixed_heading_deg;
+    if (state.settings.use_gps_course) {
+        if (!std::isfinite(pose.course_deg)) return;
+        heading = pose.course_deg + state.settings.mount_offset_deg;
+    }
+
+    if (!state.has_origin) {
+        state.has_origin = true;
+        state.origin_lat = pose.latitude;
+        state.origin_lon = pose.longitude;
+        state.cos_origin_lat = std::cos(pose.latitude * M_PI / 180.0);
+    }
+    const double east_m = (pose.longitude - state.origin_lon) * M_PI / 180.0 *
+                          GeolocConfig::EARTH_RADIUS_M * state.cos_origin_lat;
+    const double north_m = (pose.latitude - state.origin_lat) * M_PI / 180.0 * GeolocConfig::EARTH_RADIUS_M;
+
+    if (e) {
+        // Bearings from (nearly) the same spot add no geometry
+        if (std::hypot(east_m - e->last_east_m, north_m - e->last_north_m) < GeolocConfig::MIN_MOVE_M) return;
+    } else {
+        e = find_emitter(state, track.id, timestamp_us);
+        e->track_updates = track.updates;
+    }
+
+    // Each hypothesis takes the line of the pair closer to its own solution, so an emitter
+    // passing from ahead of the array to behind it (or a turn) stays in one hypothesis.
+    // Until solved, hypothesis 0 takes the primary bearing and 1 the mirror.
+    const double sigma = bearing_sigma_deg(track);
+    const double candidates[2] = {wrap_degrees(heading + track.azimuth),
+                                  wrap_degrees(heading + track.back_azimuth)};
+    for (int i = 0; i < 2; i++) {
+        GeolocHypothesis& h = e->hyp[i];
+        double bearing = candidates[i];
+        if (h.solved) {
+            const double expected = std::atan2(h.east_m - east_m, h.north_m - north_m) * 180.0 / M_PI;
+            const double d0 = std::fabs(std::remainder(candidates[0] - expected, 360.0));
+            const double d1 = std::fabs(std::remainder(candidates[1] - expected, 360.0));
+            bearing = (d0 <= d1) ? candidates[0] : candidates[1];
+        }
+        add_bearing(h, east_m, north_m, bearing, sigma);
+    }
+    e->last_us = timestamp_us;
+    e->last_east_m = east_m;
+    e->last_north_m = north_m;
+    e->center_freq_hz = freq_hz;
+}
+
+static void publish_geolocation(const GeolocState& state, uint64_t timestamp_us) {
+    std::ostringstream json;
+    json << std::fixed << "{\"emitters\":[";
+    bool first = true;
+    size_t pending = 0;
+    for (const auto& e : state.emitters) {
+        if (e.track_id == 0) continue;
+        const int best = best_hypothesis(e);
+        if (best < 0) {
+            pending++;
+            continue;
+        }
+        const GeolocHypothesis& h = e.hyp[best];
+        const GeolocHypothesis& other = e.hyp[1 - best];
+        // Both hypotheses still fit about equally well: the platform has not turned enough
+        const bool ambiguous = other.solved && other.in_front &&
+                               other.residual < GeolocConfig::AMBIGUITY_RESIDUAL_RATIO * h.residual + 1.0;
+
+        // Covariance A^-1, inflated by the residual when bearings disagree more than modelled
+        const double det = h.a11 * h.a22 - h.a12 * h.a12;
+        const double scale = std::max(1.0, h.residual / std::max<uint32_t>(h.bearings - 2, 1));
+        const double cxx = scale * h.a22 / det;
+        const double cxy = -scale * h.a12 / det;
+        const double cyy = scale * h.a11 / det;
+        const double mean = 0.5 * (cxx + cyy);
+        const double disc = std::sqrt(0.25 * (cxx - cyy) * (cxx - cyy) + cxy * cxy);
+        const double major = std::sqrt(GeolocConfig::ELLIPSE_CHI2_95 * (mean + disc));
+        const double minor = std::sqrt(GeolocConfig::ELLIPSE_CHI2_95 * std::max(0.0, mean - disc));
+        // Major axis direction (east, north) -> degrees clockwise from north
+        const double orient = wrap_degrees(0.5 * std::atan2(2.0 * cxy, cyy - cxx) * 180.0 / M_PI);
+
+        const double lat = state.origin_lat + h.north_m / GeolocConfig::EARTH_RADIUS_M * 180.0 / M_PI;
+        const double lon = state.origin_lon +
+                           h.east_m / (GeolocConfig::EARTH_RADIUS_M * state.cos_origin_lat) * 180.0 / M_PI;
+
+        if (!first) json << ",";
+        first = false;
+        json << "{\"id\":" << e.track_id
+             << std::setprecision(0) << ",\"freqHz\":" << e.center_freq_hz
+             << std::setprecision(7) << ",\"lat\":" << lat << ",\"lon\":" << lon
+             << std::setprecision(1) << ",\"majorM\":" << major << ",\"minorM\":" << minor
+             << ",\"orientDeg\":" << orient
+             << ",\"bearings\":" << h.bearings
+             << ",\"ambiguous\":" << (ambiguous ? "true" : "false")
+             << ",\"ageS\":" << (timestamp_us - e.last_us) / 1e6 << "}";
+    }
+    json << "],\"pending\":" << pending << "}";
+
+    std::lock_guard<std::mutex> lock(g_geoloc_json_mutex);
+    g_geoloc_json = json.str();
+}
+
+void update_geolocation(GeolocState& state, const BearingTableState& bearing_table, uint64_t timestamp_us,
+                        uint64_t center_freq, uint32_t sample_rate, size_t fft_size) {
+    {
+        std::lock_guard<std::mutex> lock(g_geoloc_settings_mutex);
+        if (state.settings_version != g_geoloc_settings_version) {
+            state.settings_version = g_geoloc_settings_version;
+            state.settings = g_geoloc_settings;
+        }
+    }
+    const uint64_t reset = g_geoloc_reset.load(std::memory_order_relaxed);
+    if (reset != g_geoloc_reset_seen) {
+        g_geoloc_reset_seen = reset;
+        init_geolocation(state);
+    }
+
+    for (auto& e : state.emitters) {
+        if (e.track_id != 0 && timestamp_us - e.last_us > GeolocConfig::EMITTER_TIMEOUT_US) {
+            e.track_id = 0;
+        }
+    }
+
+    const double bin_hz = static_cast<double>(sample_rate) / fft_size;
+    const auto track_freq = [&](const BearingTrack& track) {
+        return static_cast<double>(center_freq) + (0.5 * (track.start_bin + track.end_bin) - fft_size / 2.0) * bin_hz;
+    };
+    for (const auto& track : bearing_table.emitters) {
+        process_track(state, track, timestamp_us, track_freq(track));
+    }
+    for (const auto& track : bearing_table.bands) {
+        process_track(state, track, timestamp_us, track_freq(track));
+    }
+
+    state.frame_counter++;
+    if (state.frame_counter % GeolocConfig::PUBLISH_INTERVAL_FRAMES == 0) {
+        publish_geolocation(state, timestamp_us);
+    }
+}
+
+bool set_geolocation_settings(const GeolocSettings& settings) {
+    if (!std::isfinite(settings.mount_offset_deg) || !std::isfinite(settings.fixed_heading_deg) ||
+        std::fabs(settings.mount_offset_deg) > 360.0f || std::fabs(settings.fixed_heading_deg) > 360.0f) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_geoloc_settings_mutex);
+        g_geoloc_settings = settings;
+        g_geoloc_settings_version++;
+    }
+    std::cout << "[Geoloc] Heading from " << (settings.use_gps_course ? "GPS course" : "fixed heading")
+              << " (offset " << settings.mount_offset_deg << " deg, fixed " << settings.fixed_heading_deg
+              << " deg)" << std::endl;
+    return true;
+}
+
+GeolocSettings get_geolocation_settings() {
+    std::lock_guard<std::mutex> lock(g_geoloc_settings_mutex);
+    return g_geoloc_settings;
+}
+
+void reset_geolocation() {
+    g_geoloc_reset.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string get_geolocation_json() {
+    std::lock_guard<std::mutex> lock(g_geoloc_json_mutex);
+    return g_geoloc_json;
+}
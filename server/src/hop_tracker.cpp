@@ -0,0 +1,375 @@
+#include "hop_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+
+// Latest published report snapshot (written by analysis thread, read by web server)
+static std::vector<HopEmitterReport> g_hop_reports;
+static std::mutex g_hop_reports_mutex;
+
+static inline size_t cell_of(const HopTrackerState& state, float center_bin) {
+    const size_t bin = static_cast<size_t>(std::max(0.0f, center_bin + 0.5f));
+    return std::min(bin / state.cell_bins, HopTrackerConfig::CHANNEL_CELLS - 1);
+}
+
+static inline uint8_t* hits_of(HopTrackerState& state, size_t slot) {
+    return state.channel_hits.data() + slot * HopTrackerConfig::CHANNEL_CELLS;
+}
+
+void init_hop_tracker(HopTrackerState& state, size_t fft_size, const HopTrackerParams& params) {
+    state.params = params;
+    state.fft_size = fft_size;
+    state.cell_bins = std::max<size_t>(1, fft_size / HopTrackerConfig::CHANNEL_CELLS);
+
+    state.emitters.assign(HopTrackerConfig::MAX_EMITTERS, HopEmitter{});
+    state.channel_hits.assign(HopTrackerConfig::MAX_EMITTERS * HopTrackerConfig::CHANNEL_CELLS, 0);
+    state.active.assign(HopTrackerConfig::CHANNEL_CELLS, HopActiveDwell{});
+    state.live_cells.clear();
+    state.live_cells.reserve(HopTrackerConfig::CHANNEL_CELLS);
+
+    state.time_index.assign(HopTrackerConfig::TIME_BINS, HopTimeBin{});
+    for (auto& bin : state.time_index) {
+        bin.epoch = UINT64_MAX;
+        bin.count = 0;
+    }
+    state.time_bin_us = std::max<uint64_t>(1, params.max_gap_us / HopTrackerConfig::TIME_BINS_PER_GAP);
+
+    state.noise_floor.assign(fft_size, 0.0f);
+    state.floor_initialized = false;
+    state.frame_counter = 0;
+    state.block_counter = 0;
+    state.last_frame_us = 0;
+    state.frame_interval_us = 0.0f;
+    state.next_id = 1;
+    state.hops_linked = 0;
+    state.hops_dropped = 0;
+}
+
+// Register emitter in the time bin containing its last hop end
+static void index_emitter(HopTrackerState& state, uint16_t slot, uint64_t end_us) {
+    const uint64_t epoch = end_us / state.time_bin_us;
+    HopTimeBin& bin = state.time_index[epoch % HopTrackerConfig::TIME_BINS];
+    if (bin.epoch != epoch) {
+        bin.epoch = epoch;
+        bin.count = 0;
+    }
+    if (bin.count < HOP_TIME_BIN_SLOTS) {
+        bin.slots[bin.count++] = slot;
+    }
+}
+
+// Pick a free slot, or evict the least recently active emitter
+static size_t allocate_emitter(HopTrackerState& state, uint64_t now_us) {
+    size_t victim = 0;
+    uint64_t oldest = UINT64_MAX;
+    for (size_t i = 0; i < state.emitters.size(); i++) {
+        const HopEmitter& e = state.emitters[i];
+        if (e.id == 0 ||
+            (now_us > e.last_end_us && now_us - e.last_end_us > state.params.emitter_timeout_us)) {
+            victim = i;
+            break;
+        }
+        if (e.last_end_us < oldest) {
+            oldest = e.last_end_us;
+            victim = i;
+        }
+    }
+    std::fill_n(hits_of(state, victim), HopTrackerConfig::CHANNEL_CELLS, 0);
+    return victim;
+}
+
+uint32_t add_hop_observation(HopTrackerState& state, const HopObservation& hop) {
+    const HopTrackerParams& p = state.params;
+    if (hop.end_us < hop.start_us || hop.end_us - hop.start_us > p.max_dwell_us) {
+        state.hops_dropped++;
+        return 0;
+    }
+
+    const size_t cell = cell_of(state, hop.center_bin);
+
+    // Candidate lookup: only emitters whose last hop ended within max_gap of this start
+    const uint64_t lo_us = (hop.start_us > p.max_gap_us) ? hop.start_us - p.max_gap_us : 0;
+    const uint64_t lo_epoch = lo_us / state.time_bin_us;
+    const uint64_t hi_epoch = hop.start_us / state.time_bin_us + 1;  // Tolerate slight overlap
+
+    size_t best_slot = SIZE_MAX;
+    float best_score = INFINITY;
+
+    for (uint64_t epoch = lo_epoch; epoch <= hi_epoch; epoch++) {
+        const HopTimeBin& bin = state.time_index[epoch % HopTrackerConfig::TIME_BINS];
+        if (bin.epoch != epoch) continue;
+
+        for (uint8_t k = 0; k < bin.count; k++) {
+            const HopEmitter& e = state.emitters[bin.slots[k]];
+            if (e.id == 0) continue;
+            // Entry is stale if the emitter has hopped since it was indexed here
+            if (e.last_end_us / state.time_bin_us != epoch) continue;
+            if (std::fabs(e.bandwidth_bins - hop.bandwidth_bins) > p.bw_tolerance_bins) continue;
+            // A hop must change channel; same-channel continuation is handled by the dwell table
+            if (cell_of(state, e.last_center_bin) == cell) continue;
+
+            // Score by timing consistency: expected start from the learned hop interval,
+            // otherwise immediately after the previous dwell ended
+            const float expected = (e.hop_count > 1)
+                ? static_cast<float>(e.last_start_us) + e.hop_interval_us
+                : static_cast<float>(e.last_end_us);
+            float score = std::fabs(static_cast<float>(hop.start_us) - expected);
+            score += std::fabs(e.dwell_us - static_cast<float>(hop.end_us - hop.start_us)) * 0.5f;
+
+            if (score < best_score) {
+                best_score = score;
+                best_slot = bin.slots[k];
+            }
+        }
+    }
+
+    constexpr float alpha = HopTrackerConfig::EWMA_ALPHA;
+    const float dwell = static_cast<float>(hop.end_us - hop.start_us);
+
+    if (best_slot == SIZE_MAX) {
+        // Start a new tentative emitter
+        best_slot = allocate_emitter(state, hop.end_us);
+        HopEmitter& e = state.emitters[best_slot];
+        e.id = state.next_id++;
+        if (state.next_id == 0) state.next_id = 1;
+        e.first_seen_us = hop.start_us;
+        e.bandwidth_bins = hop.bandwidth_bins;
+        e.dwell_us = dwell;
+        e.hop_interval_us = 0.0f;
+        e.power = hop.power;
+        e.hop_count = 0;
+        e.hop_set_size = 0;
+        e.min_cell = static_cast<uint16_t>(cell);
+        e.max_cell = static_cast<uint16_t>(cell);
+    } else {
+        HopEmitter& e = state.emitters[best_slot];
+        const float interval = static_cast<float>(hop.start_us - std::min(hop.start_us, e.last_start_us));
+        e.hop_interval_us = (e.hop_count > 1) ? alpha * interval + (1.0f - alpha) * e.hop_interval_us : interval;
+        e.bandwidth_bins = alpha * hop.bandwidth_bins + (1.0f - alpha) * e.bandwidth_bins;
+        e.dwell_us = alpha * dwell + (1.0f - alpha) * e.dwell_us;
+        e.power = alpha * hop.power + (1.0f - alpha) * e.power;
+        state.hops_linked++;
+    }
+
+    HopEmitter& e = state.emitters[best_slot];
+    e.last_start_us = hop.start_us;
+    e.last_end_us = hop.end_us;
+    e.last_center_bin = hop.center_bin;
+    e.hop_count++;
+
+    uint8_t& hit = hits_of(state, best_slot)[cell];
+    if (!hit) {
+        hit = 1;
+        e.hop_set_size++;
+        e.min_cell = std::min<uint16_t>(e.min_cell, static_cast<uint16_t>(cell));
+        e.max_cell = std::max<uint16_t>(e.max_cell, static_cast<uint16_t>(cell));
+    }
+
+    index_emitter(state, static_cast<uint16_t>(best_slot), hop.end_us);
+    return e.id;
+}
+
+// Close an in-progress dwell and hand it to the linker
+static void finish_dwell(HopTrackerState& state, HopActiveDwell& dwell) {
+    if (!dwell.carrier && dwell.frames > 0) {
+        // Dwell extends to the end of the last frame it was observed in
+        const uint64_t frame_span = static_cast<uint64_t>(state.frame_interval_us);
+        HopObservation hop;
+        hop.start_us = dwell.start_us;
+        hop.end_us = dwell.last_seen_us + frame_span;
+        hop.center_bin = dwell.center_sum / dwell.frames;
+        hop.bandwidth_bins = dwell.bandwidth_sum / dwell.frames;
+        hop.power = dwell.power_sum / dwell.frames;
+        add_hop_observation(state, hop);
+    }
+    dwell.frames = 0;
+    dwell.carrier = false;
+}
+
+// Merge one detection of the current frame into the per-cell dwell table
+static void add_frame_detection(HopTrackerState& state, size_t start_bin, size_t end_bin,
+                                float power, uint64_t frame_us) {
+    const float center = 0.5f * static_cast<float>(start_bin + end_bin);
+    const size_t cell = cell_of(state, center);
+    HopActiveDwell& dwell = state.active[cell];
+
+    if (dwell.frames == 0) {
+        dwell.start_us = frame_us;
+        dwell.center_sum = 0.0f;
+        dwell.bandwidth_sum = 0.0f;
+        dwell.power_sum = 0.0f;
+        dwell.carrier = false;
+        state.live_cells.push_back(static_cast<uint16_t>(cell));
+    } else if (dwell.last_frame == state.frame_counter) {
+        return;  // Two detections in one cell this frame - keep the first
+    }
+
+    dwell.last_seen_us = frame_us;
+    dwell.last_frame = state.frame_counter;
+    dwell.frames++;
+    dwell.center_sum += center;
+    dwell.bandwidth_sum += static_cast<float>(end_bin - start_bin + 1);
+    dwell.power_sum += power;
+
+    if (frame_us - dwell.start_us > state.params.max_dwell_us) {
+        dwell.carrier = true;
+    }
+}
+
+// Detect occupied bins in one STFT frame (either channel above its floor) and
+// close the dwells that were not refreshed by it
+static void update_frame(HopTrackerState& state, const uint8_t* ch1_mag, const uint8_t* ch2_mag,
+                         uint64_t frame_us) {
+    state.frame_counter++;
+    state.last_frame_us = frame_us;
+
+    const size_t n = state.fft_size;
+    float* floor = state.noise_floor.data();
+    size_t run_start = SIZE_MAX;
+    float run_power = 0.0f;
+
+    for (size_t bin = 0; bin <= n; bin++) {
+        bool occupied = false;
+        float mag = 0.0f;
+        if (bin < n) {
+            mag = static_cast<float>(std::max(ch1_mag[bin], ch2_mag[bin]));
+            occupied = mag > floor[bin] + HopTrackerConfig::DETECT_THRESHOLD;
+            const float alpha = occupied ? HopTrackerConfig::FLOOR_ALPHA_OCCUPIED : HopTrackerConfig::FLOOR_ALPHA;
+            floor[bin] += alpha * (mag - floor[bin]);
+        }
+
+        if (occupied) {
+            if (run_start == SIZE_MAX) {
+                run_start = bin;
+                run_power = 0.0f;
+            }
+            run_power += mag;
+        } else if (run_start != SIZE_MAX) {
+            add_frame_detection(state, run_start, bin - 1, run_power / static_cast<float>(bin - run_start),
+                                frame_us);
+            run_start = SIZE_MAX;
+        }
+    }
+
+    // Dwells not refreshed this frame have ended
+    size_t kept = 0;
+    for (size_t i = 0; i < state.live_cells.size(); i++) {
+        const uint16_t cell = state.live_cells[i];
+        HopActiveDwell& dwell = state.active[cell];
+        if (dwell.last_frame == state.frame_counter) {
+            state.live_cells[kept++] = cell;
+        } else {
+            finish_dwell(state, dwell);
+        }
+    }
+    state.live_cells.resize(kept);
+}
+
+void update_hop_tracker(HopTrackerState& state, const StftBlock& block) {
+    if (block.fft_size != state.fft_size || block.sample_rate == 0) return;
+    state.block_counter++;
+
+    const double us_per_sample = 1e6 / static_cast<double>(block.sample_rate);
+    state.frame_interval_us = static_cast<float>(block.hop * us_per_sample);
+
+    size_t first = 0;
+    if (!state.floor_initialized && block.frames > 0) {
+        // Seed the floor from the first frame; nothing is detected until it exists
+        for (size_t bin = 0; bin < state.fft_size; bin++) {
+            state.noise_floor[bin] = static_cast<float>(std::min(block.ch1_mag[bin], block.ch2_mag[bin]));
+        }
+        state.floor_initialized = true;
+        first = 1;
+    }
+
+    for (size_t f = first; f < block.frames; f++) {
+        const uint64_t frame_us = block.timestamp_us +
+            static_cast<uint64_t>(static_cast<double>(f * block.hop) * us_per_sample);
+        update_frame(state, block.ch1_mag + f * block.fft_size, block.ch2_mag + f * block.fft_size, frame_us);
+    }
+}
+
+void get_hop_emitters(const HopTrackerState& state, uint64_t center_freq, uint32_t sample_rate,
+                      std::vector<HopEmitterReport>& out) {
+    out.clear();
+
+    const double bin_hz = static_cast<double>(sample_rate) / static_cast<double>(state.fft_size);
+    const double half = static_cast<double>(state.fft_size) / 2.0;
+    const uint64_t now_us = state.last_frame_us;
+
+    for (size_t slot = 0; slot < state.emitters.size(); slot++) {
+        const HopEmitter& e = state.emitters[slot];
+        if (e.id == 0 || e.hop_count < state.params.min_hops_to_report || e.hop_set_size < 2) continue;
+        if (now_us > e.last_end_us && now_us - e.last_end_us > state.params.emitter_timeout_us) continue;
+
+        HopEmitterReport r;
+        r.id = e.id;
+        r.hop_count = e.hop_count;
+        r.hop_set_size = e.hop_set_size;
+        r.dwell_us = e.dwell_us;
+        r.hop_rate_hz = (e.hop_interval_us > 0.0f) ? 1e6f / e.hop_interval_us : 0.0f;
+        r.bandwidth_hz = static_cast<float>(e.bandwidth_bins * bin_hz);
+        r.power = e.power;
+        r.last_seen_us = e.last_end_us;
+
+        const double cell_center = 0.5 * static_cast<double>(state.cell_bins);
+        r.freq_min_hz = center_freq + ((e.min_cell * state.cell_bins + cell_center) - half) * bin_hz;
+        r.freq_max_hz = center_freq + ((e.max_cell * state.cell_bins + cell_center) - half) * bin_hz;
+
+        const uint8_t* hits = state.channel_hits.data() + slot * HopTrackerConfig::CHANNEL_CELLS;
+        for (size_t c = e.min_cell; c <= e.max_cell; c++) {
+            if (!hits[c]) continue;
+            if (r.hop_set_offsets_hz.size() >= HopTrackerConfig::MAX_HOP_SET_REPORT) break;
+            r.hop_set_offsets_hz.push_back(
+                static_cast<float>(((c * state.cell_bins + cell_center) - half) * bin_hz));
+        }
+
+        out.push_back(std::move(r));
+    }
+
+    // Most active emitters first
+    std::sort(out.begin(), out.end(), [](const HopEmitterReport& a, const HopEmitterReport& b) {
+        return a.hop_count > b.hop_count;
+    });
+}
+
+void publish_hop_emitters(const std::vector<HopEmitterReport>& reports) {
+    std::lock_guard<std::mutex> lock(g_hop_reports_mutex);
+    g_hop_reports = reports;
+}
+
+std::string get_hop_emitters_json() {
+    std::vector<HopEmitterReport> reports;
+    {
+        std::lock_guard<std::mutex> lock(g_hop_reports_mutex);
+        reports = g_hop_reports;
+    }
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\"emitters\":[";
+    for (size_t i = 0; i < reports.size(); i++) {
+        const HopEmitterReport& r = reports[i];
+        if (i > 0) json << ",";
+        json << "{\"id\":" << r.id
+             << ",\"hops\":" << r.hop_count
+             << ",\"hopSetSize\":" << r.hop_set_size
+             << ",\"dwellUs\":" << r.dwell_us
+             << ",\"hopRateHz\":" << r.hop_rate_hz
+             << ",\"bandwidthHz\":" << r.bandwidth_hz
+             << ",\"power\":" << r.power
+             << ",\"freqMinHz\":" << r.freq_min_hz
+             << ",\"freqMaxHz\":" << r.freq_max_hz
+             << ",\"lastSeenUs\":" << r.last_seen_us
+             << ",\"hopSetOffsetsHz\":[";
+        for (size_t k = 0; k < r.hop_set_offsets_hz.size(); k++) {
+            if (k > 0) json << ",";
+            json << r.hop_set_offsets_hz[k];
+        }
+        json << "]}";
+    }
+    json << "]}";
+    return json.str();
+}
@@ -0,0 +1,122 @@
+#include "http_workers.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A job from submission until its reply is taken
+struct PendingHttpJob {
+    bool done;
+    HttpJobResult result;
+};
+
+// Worker pool (jobs in FIFO order, replies keyed by connection ID)
+struct HttpWorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::deque<std::pair<unsigned long, HttpJob>> queue;
+    std::unordered_map<unsigned long, PendingHttpJob> pending;
+    HttpJobReadyFn on_ready = nullptr;
+    bool stop = false;
+};
+
+static HttpWorkerPool g_http_pool;
+static std::atomic<size_t> g_http_ready{0};
+
+static void http_worker_func() {
+    for (;;) {
+        std::pair<unsigned long, HttpJob> job;
+        {
+            std::unique_lock<std::mutex> lock(g_http_pool.mutex);
+            g_http_pool.work_cv.wait(lock, [] { return g_http_pool.stop || !g_http_pool.queue.empty(); });
+            if (g_http_pool.stop) return;
+            job = std::move(g_http_pool.queue.front());
+            g_http_pool.queue.pop_front();
+            // Connection closed while queued
+            if (g_http_pool.pending.count(job.first) == 0) continue;
+        }
+
+        HttpJobResult result;
+        job.second(result);
+
+        {
+            std::lock_guard<std::mutex> lock(g_http_pool.mutex);
+            auto it = g_http_pool.pending.find(job.first);
+            if (it == g_http_pool.pending.end()) continue;  // Closed while running
+            it->second.done = true;
+            it->second.result = std::move(result);
+            g_http_ready.fetch_add(1);
+        }
+        g_http_pool.on_ready(job.first);
+    }
+}
+
+void start_http_workers(HttpJobReadyFn on_ready) {
+    // Leave one core for the event loop
+    const unsigned hw = std::thread::hardware_concurrency();
+    const unsigned workers = std::clamp(hw > 1 ? hw - 1 : 1u, 1u, HttpWorkerConfig::MAX_WORKERS);
+    g_http_pool.on_ready = on_ready;
+    g_http_pool.stop = false;
+    for (unsigned i = 0; i < workers; i++) {
+        g_http_pool.threads.emplace_back(http_worker_func);
+    }
+    std::cout << "[HTTP] Worker pool ready (" << workers << " workers)" << std::endl;
+}
+
+void stop_http_workers() {
+    {
+        std::lock_guard<std::mutex> lock(g_http_pool.mutex);
+        g_http_pool.stop = true;
+    }
+    g_http_pool.work_cv.notify_all();
+    for (auto& t : g_http_pool.threads) {
+        t.join();
+    }
+    g_http_pool.threads.clear();
+    g_http_pool.queue.clear();
+    g_http_pool.pending.clear();
+    g_http_ready = 0;
+}
+
+bool submit_http_job(unsigned long conn_id, HttpJob job) {
+    {
+        std::lock_guard<std::mutex> lock(g_http_pool.mutex);
+        if (g_http_pool.threads.empty() || g_http_pool.pending.size() >= HttpWorkerConfig::MAX_PENDING ||
+            g_http_pool.pending.count(conn_id) != 0) {
+            return false;
+        }
+        g_http_pool.pending[conn_id] = PendingHttpJob{false, HttpJobResult{}};
+        g_http_pool.queue.emplace_back(conn_id, std::move(job));
+    }
+    g_http_pool.work_cv.notify_one();
+    return true;
+}
+
+bool take_http_result(unsigned long conn_id, HttpJobResult& result) {
+    std::lock_guard<std::mutex> lock(g_http_pool.mutex);
+    auto it = g_http_pool.pending.find(conn_id);
+    if (it == g_http_pool.pending.end() || !it->second.done) return false;
+    result = std::move(it->second.result);
+    g_http_pool.pending.erase(it);
+    g_http_ready.fetch_sub(1);
+    return true;
+}
+
+void cancel_http_job(unsigned long conn_id) {
+    std::lock_guard<std::mutex> lock(g_http_pool.mutex);
+    auto it = g_http_pool.pending.find(conn_id);
+    if (it == g_http_pool.pending.end()) return;
+    if (it->second.done) g_http_ready.fetch_sub(1);
+    g_http_pool.pending.erase(it);
+}
+
+size_t ready_http_results() {
+    return g_http_ready.load();
+}
@@ -8,6 +8,7 @@
 #include "config_validation.h"
 #include "telemetry.h"
 #include "pipeline.h"
+#include "scf_engine.h"
 #include <algorithm>
 #include <atomic>
 #include <chrono>
@@ -223,23 +224,33 @@ int main(int argc, char *argv[]) {
     init_dc_offset(pipeline_ctx.dc_offset);
     init_overlap(pipeline_ctx.overlap, FFT_SIZE);
     init_noise_floor(pipeline_ctx.noise_floor, FFT_SIZE);
+    init_pulse_detector(pipeline_ctx.pulse_detector);
     pipeline_ctx.global_noise_floor = &g_noise_floor;
     generate_window(g_window_type, FFT_SIZE, pipeline_ctx.window);
 
     // Allocate FFT buffers for processing thread (using raw allocation since fftwf_complex is float[2])
-    pipeline_ctx.fft_in_ch1 = (fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE);
-    pipeline_ctx.fft_in_ch2 = (fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE);
-    pipeline_ctx.fft_out_ch1 = (fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE);
-    pipeline_ctx.fft_out_ch2 = (fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE);
+    pipeline_ctx.num_channels = ChannelConfig::NUM_CHANNELS;
     pipeline_ctx.fft_size = FFT_SIZE;
+    for (size_t ch = 0; ch < pipeline_ctx.num_channels; ch++) {
+        pipeline_ctx.fft_in.push_back((fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE));
+        pipeline_ctx.fft_out.push_back((fftwf_complex*)malloc(sizeof(fftwf_complex) * FFT_SIZE));
+    }
+
+    // Create FFT plans for processing thread (one per channel so channels can run concurrently)
+    for (size_t ch = 0; ch < pipeline_ctx.num_channels; ch++) {
+        pipeline_ctx.fft_plans.push_back(fftwf_plan_dft_1d(FFT_SIZE, pipeline_ctx.fft_in[ch],
+                                                           pipeline_ctx.fft_out[ch],
+                                                           FFTW_FORWARD, FFTW_MEASURE));
+    }
+
+    // Batched plans for the additional STFT resolutions (same sample blocks)
+    init_multires_stft(pipeline_ctx.multires, PipelineConfig::SAMPLES_PER_BUFFER, g_window_type);
 
-    // Create FFT plans for processing thread
-    pipeline_ctx.fft_plan_ch1 = fftwf_plan_dft_1d(FFT_SIZE, pipeline_ctx.fft_in_ch1,
-                                                   pipeline_ctx.fft_out_ch1,
-                                                   FFTW_FORWARD, FFTW_MEASURE);
-    pipeline_ctx.fft_plan_ch2 = fftwf_plan_dft_1d(FFT_SIZE, pipeline_ctx.fft_in_ch2,
-                                                   pipeline_ctx.fft_out_ch2,
-                                                   FFTW_FORWARD, FFTW_MEASURE);
+    // Inverse plan for the GCC-PHAT delay estimator (analysis thread)
+    init_gcc_phat(pipeline_ctx.gcc_phat, FFT_SIZE);
+
+    // On-demand cyclostationary analysis (plans created here, worker idles until a job arrives)
+    start_scf_engine();
 
     // Save wisdom for future runs
     if (fftwf_export_wisdom_to_filename(wisdom_file)) {
@@ -400,14 +411,19 @@ int main(int argc, char *argv[]) {
     bladerf_close(dev);
 
     std::cout << "[5/8] Destroying pipeline FFTW plans..." << std::endl;
-    fftwf_destroy_plan(pipeline_ctx.fft_plan_ch1);
-    fftwf_destroy_plan(pipeline_ctx.fft_plan_ch2);
+    stop_channel_workers();
+    for (fftwf_plan plan : pipeline_ctx.fft_plans) {
+        fftwf_destroy_plan(plan);
+    }
+    destroy_multires_stft(pipeline_ctx.multires);
+    destroy_gcc_phat(pipeline_ctx.gcc_phat);
+    stop_scf_engine();
 
     std::cout << "[6/8] Freeing pipeline FFT buffers..." << std::endl;
-    free(pipeline_ctx.fft_in_ch1);
-    free(pipeline_ctx.fft_in_ch2);
-    free(pipeline_ctx.fft_out_ch1);
-    free(pipeline_ctx.fft_out_ch2);
+    for (size_t ch = 0; ch < pipeline_ctx.num_channels; ch++) {
+        free(pipeline_ctx.fft_in[ch]);
+        free(pipeline_ctx.fft_out[ch]);
+    }
 
     std::cout << "[7/8] Deleting pipeline queues..." << std::endl;
     delete sample_queue;
@@ -0,0 +1,332 @@
+#include "mjpeg_stream.h"
+#include "signal_processing.h"
+#include "web_server.h"
+#include "stb_image_write.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// One registered stream, its pooled rows and its newest frame
+struct MjpegStreamEntry {
+    bool in_use;
+    MjpegStreamParams params;
+    uint32_t viewers;
+    std::vector<uint8_t> rows;     // height x width pooled magnitudes, row s at s % height
+    uint64_t pooled_sequence;      // Next waterfall row to pool
+    bool rendering;                // A frame is being pooled and encoded (rows are checked out)
+    uint64_t next_due_ms;          // Earliest time of the next frame
+    std::shared_ptr<const std::vector<uint8_t>> part;
+    uint64_t frames_encoded;
+    uint64_t encode_us;            // Render and encode time of all frames
+    uint64_t frames_sent;
+    uint64_t frames_skipped;
+    uint64_t bytes_sent;
+};
+
+// Stream registry (encoder thread, web server thread and handlers)
+static std::array<MjpegStreamEntry, MjpegConfig::MAX_STREAMS> g_mjpeg_streams{};
+static std::atomic<size_t> g_mjpeg_open_streams{0};   // Read by the encoder without the registry lock
+static std::mutex g_mjpeg_mutex;
+
+// Encoder thread (renders every due stream, then wakes the web server)
+struct MjpegEncoder {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool rows_pending = false;     // Waterfall rows (or a new stream) arrived since the last pass
+    bool stop = false;
+    MjpegFrameReadyFn on_ready = nullptr;
+};
+static MjpegEncoder g_mjpeg_encoder;
+
+static bool same_params(const MjpegStreamParams& a, const MjpegStreamParams& b) {
+    return a.channel == b.channel && a.width == b.width && a.height == b.height &&
+           a.colormap == b.colormap && a.fps == b.fps && a.quality == b.quality;
+}
+
+MjpegStreamParams default_mjpeg_params() {
+    MjpegStreamParams params;
+    params.channel = 1;
+    params.width = MjpegConfig::DEFAULT_WIDTH;
+    params.height = MjpegConfig::DEFAULT_HEIGHT;
+    params.colormap = Colormap::VIRIDIS;
+    params.fps = MjpegConfig::DEFAULT_FPS;
+    params.quality = MjpegConfig::DEFAULT_QUALITY;
+    return params;
+}
+
+bool normalize_mjpeg_params(MjpegStreamParams& params) {
+    if (params.channel != 1 && params.channel != 2) return false;
+
+    // No upsampling: at most one column per bin and one row per history row
+    params.width = std::clamp<uint32_t>(params.width, MjpegConfig::MIN_WIDTH, WATERFALL_WIDTH);
+    params.height = std::clamp<uint32_t>(params.height, MjpegConfig::MIN_HEIGHT, WATERFALL_HEIGHT);
+    params.fps = std::clamp<uint32_t>(params.fps, 1, MjpegConfig::MAX_FPS);
+    params.quality = std::clamp(params.quality, MjpegConfig::MIN_QUALITY, MjpegConfig::MAX_QUALITY);
+    return true;
+}
+
+int open_mjpeg_stream(const MjpegStreamParams& params) {
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+
+    int free_slot = -1;
+    for (size_t i = 0; i < g_mjpeg_streams.size(); i++) {
+        MjpegStreamEntry& entry = g_mjpeg_streams[i];
+        if (entry.in_use && same_params(entry.params, params)) {
+            entry.viewers++;
+            return static_cast<int>(i);
+        }
+        if (!entry.in_use && free_slot < 0) free_slot = static_cast<int>(i);
+    }
+    if (free_slot < 0) return -1;
+
+    MjpegStreamEntry& entry = g_mjpeg_streams[free_slot];
+    entry = MjpegStreamEntry{};
+    entry.in_use = true;
+    entry.params = params;
+    entry.viewers = 1;
+    entry.rows.assign(static_cast<size_t>(params.width) * params.height, 0);
+    g_mjpeg_open_streams++;
+    notify_mjpeg_rows();  // First frame from the current history right away
+    return free_slot;
+}
+
+void close_mjpeg_stream(int stream_id) {
+    if (stream_id < 0 || stream_id >= static_cast<int>(MjpegConfig::MAX_STREAMS)) return;
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+    MjpegStreamEntry& entry = g_mjpeg_streams[stream_id];
+    if (!entry.in_use) return;
+    if (--entry.viewers == 0) {
+        entry = MjpegStreamEntry{};
+        g_mjpeg_open_streams--;
+    }
+}
+
+static void append_jpeg(void* context, void* data, int size) {
+    auto* out = static_cast<std::vector<uint8_t>*>(context);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+}
+
+// Multipart part (boundary, headers, JPEG) of one colormapped image
+static std::shared_ptr<const std::vector<uint8_t>> encode_part(const uint8_t* rgb, const MjpegStreamParams& params) {
+    thread_local std::vector<uint8_t> jpeg;
+    jpeg.clear();
+    if (!stbi_write_jpg_to_func(append_jpeg, &jpeg, static_cast<int>(params.width),
+                                static_cast<int>(params.height), 3, rgb, params.quality) || jpeg.empty()) {
+        std::cerr << "[MJPEG] JPEG encoding failed" << std::endl;
+        return nullptr;
+    }
+
+    char header[128];
+    const int header_len = snprintf(header, sizeof(header),
+                                    "--%s\r\nContent-Type: image/jpeg\r\nContent-Length: %zu\r\n\r\n",
+                                    MjpegConfig::BOUNDARY, jpeg.size());
+    auto part = std::make_shared<std::vector<uint8_t>>();
+    part->reserve(header_len + jpeg.size() + 2);
+    part->insert(part->end(), header, header + header_len);
+    part->insert(part->end(), jpeg.begin(), jpeg.end());
+    part->push_back('\r');
+    part->push_back('\n');
+    return part;
+}
+
+// Render a new frame of one stream if its interval has passed and new rows arrived
+// Returns true if a frame was encoded
+static bool render_mjpeg_frame(int stream_id, uint64_t now_ms) {
+    // Frame scratch (encoder thread)
+    thread_local std::vector<uint8_t> raw;
+    thread_local std::vector<uint8_t> magnitudes;
+    thread_local std::vector<uint8_t> pixels;
+
+    // Check the pooled ring out of the registry; it is pooled and rendered without any lock
+    MjpegStreamParams params;
+    std::vector<uint8_t> rows;
+    uint64_t first;
+    {
+        std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+        MjpegStreamEntry& entry = g_mjpeg_streams[stream_id];
+        if (!entry.in_use || now_ms < entry.next_due_ms || entry.rendering) return false;
+        entry.rendering = true;
+        params = entry.params;
+        rows.swap(entry.rows);
+        first = entry.pooled_sequence;
+    }
+
+    const size_t width = params.width;
+    const uint64_t height = params.height;
+    uint64_t latest;
+    {
+        // Copy only the rows that arrived since the last frame (at most one image of them)
+        std::lock_guard<std::mutex> waterfall_lock(g_waterfall.mutex);
+        latest = g_waterfall.sequence;
+        first = std::max(first, (latest > height) ? latest - height : 0);
+        raw.resize(static_cast<size_t>(latest - std::min(first, latest)) * WATERFALL_WIDTH);
+        const auto& history = (params.channel == 1) ? g_waterfall.ch1_history : g_waterfall.ch2_history;
+        for (uint64_t seq = first; seq < latest; seq++) {
+            std::copy(history[seq % WATERFALL_HEIGHT].begin(), history[seq % WATERFALL_HEIGHT].end(),
+                      raw.begin() + static_cast<size_t>(seq - first) * WATERFALL_WIDTH);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const std::vector<uint8_t>> part;
+    if (first < latest) {
+        for (uint64_t seq = first; seq < latest; seq++) {
+            decimate_spectrum(raw.data() + static_cast<size_t>(seq - first) * WATERFALL_WIDTH, 0,
+                              WATERFALL_WIDTH - 1, rows.data() + (seq % height) * width, width, DECIMATE_MAX);
+        }
+
+        // Newest row at the top; rows not written yet stay at magnitude 0
+        magnitudes.resize(width * height);
+        for (uint64_t y = 0; y < height; y++) {
+            const uint64_t seq = latest + height - 1 - y;  // == latest - 1 - y (mod height), never negative
+            std::copy_n(rows.data() + (seq % height) * width, width, magnitudes.data() + y * width);
+        }
+        pixels.resize(magnitudes.size() * 3);
+        colormap_row(magnitudes.data(), colormap_lut(params.colormap), pixels.data(), magnitudes.size());
+        part = encode_part(pixels.data(), params);
+    }
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+    MjpegStreamEntry& entry = g_mjpeg_streams[stream_id];
+    if (!entry.in_use || !same_params(entry.params, params)) return false;
+    entry.rendering = false;
+    entry.rows.swap(rows);
+    if (first >= latest) return false;  // No new rows: keep the schedule
+    entry.pooled_sequence = latest;
+
+    // Keep the average rate at fps; after a stall, restart the schedule from now
+    const uint64_t interval = 1000 / params.fps;
+    entry.next_due_ms = (now_ms - entry.next_due_ms < interval) ? entry.next_due_ms + interval
+                                                                 : now_ms + interval;
+    if (!part) return false;
+    entry.part = part;
+    entry.frames_encoded++;
+    entry.encode_us += static_cast<uint64_t>(elapsed_us);
+    return true;
+}
+
+static void mjpeg_encoder_func() {
+    std::unique_lock<std::mutex> lock(g_mjpeg_encoder.mutex);
+    while (!g_mjpeg_encoder.stop) {
+        // New rows start a pass at once; while streams are open the tick catches frames that
+        // were not due yet when their rows arrived
+        const bool streams_open = g_mjpeg_open_streams.load() > 0;
+        const auto wake = [] { return g_mjpeg_encoder.stop || g_mjpeg_encoder.rows_pending; };
+        if (streams_open) {
+            g_mjpeg_encoder.cv.wait_for(lock, std::chrono::milliseconds(MjpegConfig::ENCODER_TICK_MS), wake);
+        } else {
+            g_mjpeg_encoder.cv.wait(lock, wake);
+        }
+        if (g_mjpeg_encoder.stop) break;
+        g_mjpeg_encoder.rows_pending = false;
+        lock.unlock();
+
+        const uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        bool encoded = false;
+        for (int id = 0; id < static_cast<int>(MjpegConfig::MAX_STREAMS); id++) {
+            encoded |= render_mjpeg_frame(id, now_ms);
+        }
+        if (encoded) g_mjpeg_encoder.on_ready();
+
+        lock.lock();
+    }
+}
+
+void start_mjpeg_encoder(MjpegFrameReadyFn on_ready) {
+    g_mjpeg_encoder.on_ready = on_ready;
+    g_mjpeg_encoder.stop = false;
+    g_mjpeg_encoder.rows_pending = false;
+    g_mjpeg_encoder.thread = std::thread(mjpeg_encoder_func);
+    std::cout << "[MJPEG] Encoder thread ready" << std::endl;
+}
+
+void stop_mjpeg_encoder() {
+    if (!g_mjpeg_encoder.thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(g_mjpeg_encoder.mutex);
+        g_mjpeg_encoder.stop = true;
+    }
+    g_mjpeg_encoder.cv.notify_one();
+    g_mjpeg_encoder.thread.join();
+}
+
+void notify_mjpeg_rows() {
+    {
+        std::lock_guard<std::mutex> lock(g_mjpeg_encoder.mutex);
+        g_mjpeg_encoder.rows_pending = true;
+    }
+    g_mjpeg_encoder.cv.notify_one();
+}
+
+bool get_mjpeg_frame(int stream_id, MjpegFrame& frame) {
+    if (stream_id < 0 || stream_id >= static_cast<int>(MjpegConfig::MAX_STREAMS)) return false;
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+    const MjpegStreamEntry& entry = g_mjpeg_streams[stream_id];
+    if (!entry.in_use || !entry.part) return false;
+    frame.part = entry.part;
+    frame.number = entry.frames_encoded;
+    return true;
+}
+
+void record_mjpeg_send(int stream_id, size_t bytes, bool skipped) {
+    if (stream_id < 0 || stream_id >= static_cast<int>(MjpegConfig::MAX_STREAMS)) return;
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+    MjpegStreamEntry& entry = g_mjpeg_streams[stream_id];
+    if (!entry.in_use) return;
+    if (skipped) {
+        entry.frames_skipped++;
+    } else {
+        entry.frames_sent++;
+        entry.bytes_sent += bytes;
+    }
+}
+
+std::string get_mjpeg_streams_json() {
+    std::lock_guard<std::mutex> lock(g_mjpeg_mutex);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(2);
+    json << "{\"streams\":[";
+    bool first = true;
+    for (size_t i = 0; i < g_mjpeg_streams.size(); i++) {
+        const MjpegStreamEntry& entry = g_mjpeg_streams[i];
+        if (!entry.in_use) continue;
+        if (!first) json << ",";
+        first = false;
+        const double fanout = entry.frames_encoded > 0 ?
+                              static_cast<double>(entry.frames_sent) / entry.frames_encoded : 0.0;
+        const double encode_ms = entry.frames_encoded > 0 ?
+                                 entry.encode_us / 1000.0 / entry.frames_encoded : 0.0;
+        json << "{\"id\":" << i
+             << ",\"ch\":" << entry.params.channel
+             << ",\"width\":" << entry.params.width
+             << ",\"height\":" << entry.params.height
+             << ",\"colormap\":\"" << colormap_name(entry.params.colormap) << "\""
+             << ",\"fps\":" << entry.params.fps
+             << ",\"quality\":" << entry.params.quality
+             << ",\"viewers\":" << entry.viewers
+             << ",\"encoded\":" << entry.frames_encoded
+             << ",\"encodeMs\":" << encode_ms
+             << ",\"frameBytes\":" << (entry.part ? entry.part->size() : 0)
+             << ",\"sent\":" << entry.frames_sent
+             << ",\"skipped\":" << entry.frames_skipped
+             << ",\"bytesSent\":" << entry.bytes_sent
+             << ",\"fanout\":" << fanout
+             << "}";
+    }
+    json << "]}";
+    return json.str();
+}
@@ -0,0 +1,249 @@
+#include "multires_stft.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+// Published spectrogram history for one resolution (written by processing thread, read by web server)
+struct StftHistory {
+    size_t fft_size;
+    size_t hop;
+    std::vector<uint8_t> ch1;               // HISTORY_ROWS x fft_size ring
+    std::vector<uint8_t> ch2;
+    uint64_t sequence;                      // Rows written so far (row N lives at (N - 1) % HISTORY_ROWS)
+    uint32_t sample_rate;
+    std::atomic<uint64_t> last_request_us{0};
+    std::mutex mutex;
+};
+
+// Created once at init, before any thread reads them
+static std::vector<std::unique_ptr<StftHistory>> g_stft_history;
+
+static uint64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void init_multires_stft(MultiResState& state, size_t max_samples, uint32_t window_type,
+                        const StftResolutionConfig* configs, size_t num_configs) {
+    state.resolutions.clear();
+    state.frames_computed = 0;
+    g_stft_history.clear();
+
+    num_configs = std::min(num_configs, MultiResConfig::MAX_RESOLUTIONS);
+    state.resolutions.reserve(num_configs);
+
+    for (size_t r = 0; r < num_configs; r++) {
+        const StftResolutionConfig& cfg = configs[r];
+        if (cfg.fft_size < 8 || cfg.fft_size > max_samples || cfg.hop == 0) {
+            std::cerr << "[STFT] Skipping invalid resolution " << cfg.fft_size << "/" << cfg.hop << std::endl;
+            continue;
+        }
+
+        StftResolution res;
+        res.fft_size = cfg.fft_size;
+        res.hop = cfg.hop;
+        res.max_frames = (max_samples - cfg.fft_size) / cfg.hop + 1;
+        generate_window(window_type, cfg.fft_size, res.window);
+
+        const size_t total = 2 * res.max_frames * res.fft_size;
+        res.batch_in = fftwf_alloc_complex(total);
+        res.batch_out = fftwf_alloc_complex(total);
+        res.mag.assign(total, 0);
+
+        // Both channels' frames are contiguous, so one plan covers the whole block
+        const int n = static_cast<int>(res.fft_size);
+        res.plan = fftwf_plan_many_dft(1, &n, static_cast<int>(2 * res.max_frames),
+                                       res.batch_in, nullptr, 1, n,
+                                       res.batch_out, nullptr, 1, n,
+                                       FFTW_FORWARD, FFTW_MEASURE);
+        // FFTW_MEASURE scribbles on the input while planning
+        memset(res.batch_in, 0, total * sizeof(fftwf_complex));
+
+        auto history = std::make_unique<StftHistory>();
+        history->fft_size = res.fft_size;
+        history->hop = res.hop;
+        history->ch1.assign(MultiResConfig::HISTORY_ROWS * res.fft_size, 0);
+        history->ch2.assign(MultiResConfig::HISTORY_ROWS * res.fft_size, 0);
+        history->sequence = 0;
+        history->sample_rate = 0;
+        res.history_slot = g_stft_history.size();
+        g_stft_history.push_back(std::move(history));
+
+        std::cout << "[STFT] Resolution " << res.fft_size << " (hop " << res.hop << ", "
+                  << res.max_frames << " frames/block)" << std::endl;
+        state.resolutions.push_back(std::move(res));
+    }
+}
+
+void destroy_multires_stft(MultiResState& state) {
+    for (auto& res : state.resolutions) {
+        fftwf_destroy_plan(res.plan);
+        fftwf_free(res.batch_in);
+        fftwf_free(res.batch_out);
+    }
+    state.resolutions.clear();
+}
+
+bool add_stft_listener(MultiResState& state, size_t fft_size, StftListener listener) {
+    for (auto& res : state.resolutions) {
+        if (res.fft_size == fft_size) {
+            res.listeners.push_back(std::move(listener));
+            return true;
+        }
+    }
+    return false;
+}
+
+// Slice one channel into hop-spaced frames with DC removal and windowing
+static void fill_frames(const float* samples, size_t frames, const StftResolution& res,
+                        float dc_i, float dc_q, fftwf_complex* out) {
+    const size_t n = res.fft_size;
+    const float* w = res.window.data();
+
+    for (size_t f = 0; f < frames; f++) {
+        const float* src = samples + f * res.hop * 2;
+        fftwf_complex* dst = out + f * n;
+        for (size_t k = 0; k < n; k++) {
+            dst[k][0] = (src[k * 2 + 0] - dc_i) * w[k];
+            dst[k][1] = (src[k * 2 + 1] - dc_q) * w[k];
+        }
+    }
+}
+
+// Append rows to a client history ring
+static void publish_rows(StftHistory& history, const uint8_t* ch1, const uint8_t* ch2,
+                         size_t frames, uint32_t sample_rate) {
+    const size_t n = history.fft_size;
+    std::lock_guard<std::mutex> lock(history.mutex);
+
+    // Only the newest HISTORY_ROWS rows can survive
+    const size_t skip = (frames > MultiResConfig::HISTORY_ROWS) ? frames - MultiResConfig::HISTORY_ROWS : 0;
+    history.sequence += skip;
+    for (size_t f = skip; f < frames; f++) {
+        const size_t row = history.sequence % MultiResConfig::HISTORY_ROWS;
+        memcpy(history.ch1.data() + row * n, ch1 + f * n, n);
+        memcpy(history.ch2.data() + row * n, ch2 + f * n, n);
+        history.sequence++;
+    }
+    history.sample_rate = sample_rate;
+}
+
+size_t process_multires_stft(MultiResState& state, const IQFrontEnd& front_end,
+                             const DCOffsetState& dc_state, uint64_t first_sample,
+                             uint64_t timestamp_us, uint32_t sample_rate) {
+    const uint64_t now_us = steady_now_us();
+    size_t computed = 0;
+
+    for (auto& res : state.resolutions) {
+        StftHistory& history = *g_stft_history[res.history_slot];
+
+        // Skip resolutions nobody is subscribed to
+        const uint64_t last_request = history.last_request_us.load(std::memory_order_relaxed);
+        const bool client_subscribed = last_request != 0 &&
+                                       now_us - last_request < MultiResConfig::CLIENT_TIMEOUT_US;
+        if (res.listeners.empty() && !client_subscribed) continue;
+        if (front_end.count < res.fft_size) continue;
+
+        const size_t frames = std::min(res.max_frames, (front_end.count - res.fft_size) / res.hop + 1);
+        const size_t n = res.fft_size;
+        fftwf_complex* in_ch2 = res.batch_in + res.max_frames * n;
+
+        fill_frames(front_end.channel(0), frames, res, dc_state.dc_i[0], dc_state.dc_q[0], res.batch_in);
+        fill_frames(front_end.channel(1), frames, res, dc_state.dc_i[1], dc_state.dc_q[1], in_ch2);
+
+        fftwf_execute(res.plan);
+
+        uint8_t* mag_ch1 = res.mag.data();
+        uint8_t* mag_ch2 = res.mag.data() + res.max_frames * n;
+        fftwf_complex* out_ch2 = res.batch_out + res.max_frames * n;
+        compute_magnitude_db(res.batch_out, mag_ch1, frames * n);
+        compute_magnitude_db(out_ch2, mag_ch2, frames * n);
+        for (size_t f = 0; f < frames; f++) {
+            remove_dc_offset(mag_ch1 + f * n, n);
+            remove_dc_offset(mag_ch2 + f * n, n);
+        }
+
+        if (!res.listeners.empty()) {
+            StftBlock block;
+            block.fft_size = n;
+            block.hop = res.hop;
+            block.frames = frames;
+            block.ch1_mag = mag_ch1;
+            block.ch2_mag = mag_ch2;
+            block.ch1_fft = res.batch_out;
+            block.ch2_fft = out_ch2;
+            block.first_sample = first_sample;
+            block.timestamp_us = timestamp_us;
+            block.sample_rate = sample_rate;
+            for (auto& listener : res.listeners) {
+                listener(block);
+            }
+        }
+
+        if (client_subscribed) {
+            publish_rows(history, mag_ch1, mag_ch2, frames, sample_rate);
+        }
+
+        state.frames_computed += frames;
+        computed++;
+    }
+
+    return computed;
+}
+
+bool get_stft_rows(size_t fft_size, int channel, uint64_t since_sequence, std::vector<uint8_t>& out,
+                   uint64_t& last_sequence) {
+    for (auto& entry : g_stft_history) {
+        StftHistory& history = *entry;
+        if (history.fft_size != fft_size) continue;
+
+        // Renew the subscription so the processing thread keeps computing this resolution
+        history.last_request_us.store(steady_now_us(), std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(history.mutex);
+        const size_t n = history.fft_size;
+        const uint64_t available = history.sequence - std::min(since_sequence, history.sequence);
+        const size_t rows = static_cast<size_t>(std::min<uint64_t>(
+            available, std::min(MultiResConfig::HISTORY_ROWS, MultiResConfig::MAX_ROWS_PER_REQUEST)));
+        const std::vector<uint8_t>& src = (channel == 2) ? history.ch2 : history.ch1;
+
+        out.resize(rows * n);
+        for (size_t r = 0; r < rows; r++) {
+            const uint64_t seq = history.sequence - rows + r;
+            const size_t slot = seq % MultiResConfig::HISTORY_ROWS;
+            memcpy(out.data() + r * n, src.data() + slot * n, n);
+        }
+        last_sequence = history.sequence;
+        return true;
+    }
+    return false;
+}
+
+std::string get_stft_resolutions_json() {
+    std::ostringstream json;
+    json << "{\"resolutions\":[";
+    for (size_t i = 0; i < g_stft_history.size(); i++) {
+        StftHistory& history = *g_stft_history[i];
+        uint32_t sample_rate;
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(history.mutex);
+            sample_rate = history.sample_rate;
+            sequence = history.sequence;
+        }
+        // Time resolution of one row (0 until the first rows are published)
+        const double row_us = (sample_rate > 0) ? history.hop * 1e6 / sample_rate : 0.0;
+        if (i > 0) json << ",";
+        json << "{\"fftSize\":" << history.fft_size
+             << ",\"hop\":" << history.hop
+             << ",\"rowUs\":" << row_us
+             << ",\"sequence\":" << sequence << "}";
+    }
+    json << "]}";
+    return json.str();
+}
@@ -3,7 +3,16 @@
 #include "config.h"
 #include "signal_processing.h"
 #include "df_processing.h"
+#include "array_calibration.h"
+#include "beamformer.h"
 #include "cfar_detector.h"
+#include "hop_tracker.h"
+#include "bearing_table.h"
+#include "geolocation.h"
+#include "df_waterfall.h"
+#include "superres_df.h"
+#include "spectral_stats.h"
+#include "scf_engine.h"
 #include "web_server.h"
 #include <cstring>
 #include <cstdlib>
@@ -25,13 +34,22 @@ extern LastValidDoA g_last_valid_doa;
 void acquisition_thread_func(PipelineContext* ctx) {
     std::cout << "[Pipeline] Acquisition thread started" << std::endl;
 
+    // One bladeRF delivers two phase-coherent channels as BLADERF_RX_X2 frames. Larger
+    // arrays need synchronized devices writing the same frame layout; everything
+    // downstream of this thread already handles any channel count.
+    static_assert(ChannelConfig::NUM_CHANNELS == 2, "Acquisition drives a single bladeRF in BLADERF_RX_X2");
+
     // Allocate sample buffer (reused across iterations)
-    constexpr size_t NUM_SAMPLES = 16384;  // Matches main.cpp buffer size
-    constexpr size_t BUFFER_SIZE = NUM_SAMPLES * 2 * 2;  // 2 channels, I+Q
+    constexpr size_t NUM_SAMPLES = PipelineConfig::SAMPLES_PER_BUFFER;
+    constexpr size_t BUFFER_SIZE = NUM_SAMPLES * 2 * ChannelConfig::NUM_CHANNELS;  // I+Q per channel
 
     SampleBuffer sample_buf;
     sample_buf.samples.resize(BUFFER_SIZE);
     sample_buf.count = NUM_SAMPLES;
+    sample_buf.channels = ChannelConfig::NUM_CHANNELS;
+
+    // Running sample counter for sample-accurate timestamps downstream
+    uint64_t sample_counter = 0;
 
     // USB error recovery state
     uint32_t consecutive_errors = 0;
@@ -155,6 +173,9 @@ void acquisition_thread_func(PipelineContext* ctx) {
         consecutive_errors = 0;
         error_backoff_ms = USBConfig::INITIAL_BACKOFF_MS;
 
+        sample_buf.sample_index = sample_counter;
+        sample_counter += NUM_SAMPLES;
+
         // Update watchdog heartbeat
         g_rx_heartbeat.fetch_add(1);
 
@@ -188,6 +209,33 @@ void processing_thread_func(PipelineContext* ctx) {
     uint32_t frame_count = 0;
     auto fps_update_time = std::chrono::steady_clock::now();
 
+    // Pulses found in the current buffer
+    std::vector<PulseDescriptor> pulses;
+    pulses.reserve(PulseConfig::HISTORY_SIZE);
+
+    // Steered RX1/RX2 sum and difference beams (formed only while enabled)
+    BeamformerState beamformer;
+    init_beamformer(beamformer, ctx->fft_size);
+    std::vector<uint8_t> beam_mag(2 * ctx->fft_size);
+
+    // Frequency-hopping emitter tracker on the 256-point STFT frames (sub-frame hop timing)
+    HopTrackerState hop_tracker;
+    init_hop_tracker(hop_tracker, HopTrackerConfig::STFT_SIZE);
+    std::vector<HopEmitterReport> hop_reports;
+    const bool hop_subscribed = add_stft_listener(ctx->multires, HopTrackerConfig::STFT_SIZE,
+        [&](const StftBlock& block) {
+            update_hop_tracker(hop_tracker, block);
+            if (hop_tracker.block_counter % HopTrackerConfig::PUBLISH_INTERVAL_BLOCKS == 0) {
+                get_hop_emitters(hop_tracker, ctx->center_freq->load(std::memory_order_relaxed),
+                                 block.sample_rate, hop_reports);
+                publish_hop_emitters(hop_reports);
+            }
+        });
+    if (!hop_subscribed) {
+        std::cerr << "[Pipeline] No " << HopTrackerConfig::STFT_SIZE
+                  << "-point STFT resolution, hop tracker disabled" << std::endl;
+    }
+
     while (ctx->running->load(std::memory_order_acquire)) {
         // Pop samples from acquisition queue
         if (!ctx->sample_queue->pop(sample_buf)) {
@@ -197,51 +245,99 @@ void processing_thread_func(PipelineContext* ctx) {
             continue;
         }
 
+        // Time-domain pulse detection on every sample of the buffer (FFT only sees a window)
+        auto pulse_start = std::chrono::high_resolution_clock::now();
+        pulses.clear();
+        detect_pulses(ctx->pulse_detector, sample_buf.samples.data(), sample_buf.count, sample_buf.channels,
+                      sample_buf.sample_index, sample_buf.timestamp_us,
+                      ctx->sample_rate->load(std::memory_order_relaxed), pulses);
+        if (!pulses.empty()) {
+            publish_pulses(ctx->pulse_detector, pulses);
+            g_telemetry.pulses_detected.fetch_add(pulses.size());
+        }
+        auto pulse_end = std::chrono::high_resolution_clock::now();
+        g_telemetry.total_pulse_time_us.fetch_add(
+            std::chrono::duration_cast<std::chrono::microseconds>(pulse_end - pulse_start).count());
+
         // Time the FFT processing
         auto fft_start = std::chrono::high_resolution_clock::now();
 
-        // Allocate magnitude output buffers
-        std::vector<uint8_t> ch1_mag(ctx->fft_size);
-        std::vector<uint8_t> ch2_mag(ctx->fft_size);
+        // Magnitude planes are written straight into the outgoing FFT buffer
+        const size_t channels = ctx->num_channels;
+        fft_buf.channels = channels;
+        fft_buf.size = ctx->fft_size;
+        fft_buf.mag.resize(channels * ctx->fft_size);
+        uint8_t* ch1_mag = fft_buf.channel_mag(0);
+        uint8_t* ch2_mag = fft_buf.channel_mag(1);
 
         // Get current center frequency from context
         uint64_t current_freq = ctx->center_freq->load(std::memory_order_relaxed);
 
-        // Perform FFT and magnitude computation
-        (void)process_iq_to_fft(
-            sample_buf.samples.data(),
-            sample_buf.count,
+        // Deinterleave the whole buffer once; every FFT resolution reads from it
+        deinterleave_iq(sample_buf.samples.data(), sample_buf.count, sample_buf.channels, ctx->front_end);
+
+        // Perform FFT and magnitude computation for every channel
+        (void)process_frontend_to_fft(
+            ctx->front_end,
             ctx->fft_size,
             current_freq,
-            ctx->fft_in_ch1,
-            ctx->fft_in_ch2,
-            ctx->fft_out_ch1,
-            ctx->fft_out_ch2,
-            ch1_mag.data(),
-            ch2_mag.data(),
+            ctx->fft_in.data(),
+            ctx->fft_out.data(),
+            fft_buf.mag.data(),
             ctx->dc_offset,
             ctx->overlap,
             ctx->window,
-            ctx->fft_plan_ch1,
-            ctx->fft_plan_ch2
+            ctx->fft_plans.data()
         );
 
         auto fft_end = std::chrono::high_resolution_clock::now();
         auto fft_time_us = std::chrono::duration_cast<std::chrono::microseconds>(fft_end - fft_start);
         g_telemetry.total_fft_time_us.fetch_add(fft_time_us.count());
 
+        // Additional STFT resolutions from the same block (only those with subscribers)
+        const uint64_t stft_frames_before = ctx->multires.frames_computed;
+        if (process_multires_stft(ctx->multires, ctx->front_end, ctx->dc_offset, sample_buf.sample_index,
+                                  sample_buf.timestamp_us, ctx->sample_rate->load(std::memory_order_relaxed)) > 0) {
+            auto stft_end = std::chrono::high_resolution_clock::now();
+            g_telemetry.total_stft_time_us.fetch_add(
+                std::chrono::duration_cast<std::chrono::microseconds>(stft_end - fft_end).count());
+            g_telemetry.stft_frames.fetch_add(ctx->multires.frames_computed - stft_frames_before);
+        }
+
+        // Feed a pending SCF capture (no-op unless a job is waiting for samples)
+        scf_capture_tap(ctx->front_end, sample_buf.sample_index);
+
         // Update noise floor estimation (15th percentile, 0.1 smoothing factor)
-        update_noise_floor(ctx->noise_floor, ch1_mag.data(), ch2_mag.data(), ctx->fft_size, 15.0f, 0.1f);
+        update_noise_floor(ctx->noise_floor, fft_buf.mag.data(), ctx->fft_size, 15.0f, 0.1f);
 
         // Also update global noise floor for web server reporting
-        update_noise_floor(*ctx->global_noise_floor, ch1_mag.data(), ch2_mag.data(), ctx->fft_size, 15.0f, 0.1f);
+        update_noise_floor(*ctx->global_noise_floor, fft_buf.mag.data(), ctx->fft_size, 15.0f, 0.1f);
 
         // Remove DC offset spike/dip at center frequency
-        remove_dc_offset(ch1_mag.data(), ctx->fft_size);
-        remove_dc_offset(ch2_mag.data(), ctx->fft_size);
+        for (size_t ch = 0; ch < channels; ch++) {
+            remove_dc_offset(fft_buf.channel_mag(ch), ctx->fft_size);
+        }
+
+        // Sum/difference beams; either may stand in for RX1/RX2 downstream
+        bool beam_display = false;
+        fft_buf.beam_mag.clear();
+        if (beamformer_enabled()) {
+            const uint32_t sample_rate = ctx->sample_rate->load(std::memory_order_relaxed);
+            update_beamformer(beamformer, ctx->fft_out[0], ctx->fft_out[1], current_freq, sample_rate,
+                              get_calibration_table(current_freq, sample_rate, ctx->fft_size), beam_mag.data());
+            beam_display = beamformer.settings.display_input;
+            if (beamformer.settings.cfar_input) {
+                fft_buf.beam_mag.assign(beam_mag.begin(), beam_mag.begin() + ctx->fft_size);
+                fft_buf.beam_noise_floor = get_channel_noise_floor(beamformer.noise_floor, 0);
+            }
+        }
 
-        // Update waterfall display
-        update_waterfall(ch1_mag.data(), ch2_mag.data(), ctx->fft_size);
+        // Update waterfall display (channels 1 and 2, or the sum and difference beams)
+        if (beam_display) {
+            update_waterfall(beam_mag.data(), beam_mag.data() + ctx->fft_size, ctx->fft_size);
+        } else {
+            update_waterfall(ch1_mag, ch2_mag, ctx->fft_size);
+        }
 
         // Decimate IQ samples for constellation display
         static_assert(4096 >= 256 && 4096 % 256 == 0, "FFT_SIZE must be >= 256 and divisible by 256");
@@ -249,39 +345,38 @@ void processing_thread_func(PipelineContext* ctx) {
         int16_t ch1_iq[256][2], ch2_iq[256][2];
         for (int i = 0; i < 256; i++) {
             const size_t idx = i * decimation_step;
-            ch1_iq[i][0] = static_cast<int16_t>(ctx->fft_in_ch1[idx][0] * 32767.0f);
-            ch1_iq[i][1] = static_cast<int16_t>(ctx->fft_in_ch1[idx][1] * 32767.0f);
-            ch2_iq[i][0] = static_cast<int16_t>(ctx->fft_in_ch2[idx][0] * 32767.0f);
-            ch2_iq[i][1] = static_cast<int16_t>(ctx->fft_in_ch2[idx][1] * 32767.0f);
+            ch1_iq[i][0] = static_cast<int16_t>(ctx->fft_in[0][idx][0] * 32767.0f);
+            ch1_iq[i][1] = static_cast<int16_t>(ctx->fft_in[0][idx][1] * 32767.0f);
+            ch2_iq[i][0] = static_cast<int16_t>(ctx->fft_in[1][idx][0] * 32767.0f);
+            ch2_iq[i][1] = static_cast<int16_t>(ctx->fft_in[1][idx][1] * 32767.0f);
         }
         // Update IQ data with FFT output for frequency-domain filtering
         update_iq_data(reinterpret_cast<int16_t*>(ch1_iq), reinterpret_cast<int16_t*>(ch2_iq), 256,
-                      ctx->fft_out_ch1, ctx->fft_out_ch2, ctx->fft_size);
+                      ctx->fft_out[0], ctx->fft_out[1], ctx->fft_size);
 
         // Compute and update cross-correlation data
         std::vector<float> xcorr_mag(ctx->fft_size);
         std::vector<float> xcorr_phase(ctx->fft_size);
-        compute_cross_correlation(ctx->fft_out_ch1, ctx->fft_out_ch2,
+        compute_cross_correlation(ctx->fft_out[0], ctx->fft_out[1],
                                  xcorr_mag.data(), xcorr_phase.data(), ctx->fft_size);
         update_xcorr_data(xcorr_mag.data(), xcorr_phase.data(), ctx->fft_size);
 
-        // Copy results to FFT buffer
-        fft_buf.ch1_mag = ch1_mag;
-        fft_buf.ch2_mag = ch2_mag;
-
         // Convert fftwf_complex to ComplexSample
-        fft_buf.ch1_fft.resize(ctx->fft_size);
-        fft_buf.ch2_fft.resize(ctx->fft_size);
-        for (size_t i = 0; i < ctx->fft_size; i++) {
-            fft_buf.ch1_fft[i].from_fftw(ctx->fft_out_ch1[i]);
-            fft_buf.ch2_fft[i].from_fftw(ctx->fft_out_ch2[i]);
+        fft_buf.fft.resize(channels * ctx->fft_size);
+        for (size_t ch = 0; ch < channels; ch++) {
+            ComplexSample* dst = fft_buf.channel_fft(ch);
+            const fftwf_complex* src = ctx->fft_out[ch];
+            for (size_t i = 0; i < ctx->fft_size; i++) {
+                dst[i].from_fftw(src[i]);
+            }
         }
 
-        fft_buf.size = ctx->fft_size;
         fft_buf.timestamp_us = sample_buf.timestamp_us;
 
         // Get current noise floor estimates for analysis stage
-        get_noise_floor(ctx->noise_floor, fft_buf.noise_floor_ch1, fft_buf.noise_floor_ch2);
+        for (size_t ch = 0; ch < channels; ch++) {
+            fft_buf.noise_floor[ch] = get_channel_noise_floor(ctx->noise_floor, ch);
+        }
 
         // Push to analysis queue
         if (!ctx->fft_queue->push(fft_buf)) {
@@ -322,11 +417,38 @@ void analysis_thread_func(PipelineContext* ctx) {
 
     // Allocate temporary buffers for converting ComplexSample back to fftwf_complex
     // Use raw pointers since fftwf_complex is float[2] and can't be in vectors
-    fftwf_complex* fft_ch1_tmp = (fftwf_complex*)malloc(sizeof(fftwf_complex) * ctx->fft_size);
-    fftwf_complex* fft_ch2_tmp = (fftwf_complex*)malloc(sizeof(fftwf_complex) * ctx->fft_size);
+    std::vector<fftwf_complex*> fft_tmp(ctx->num_channels);
+    for (auto& buf : fft_tmp) {
+        buf = (fftwf_complex*)malloc(sizeof(fftwf_complex) * ctx->fft_size);
+    }
+    // Channels 1 and 2 feed the interferometer, CFAR and the single-pair products
+    fftwf_complex* fft_ch1_tmp = fft_tmp[0];
+    fftwf_complex* fft_ch2_tmp = fft_tmp[1];
 
     // Use global DoA state for proper bearing hold and Kalman filtering across frames
 
+    // Per-bin spectral kurtosis / flatness (sub-CFAR non-Gaussian signals)
+    SpectralStatsState spectral_stats;
+    init_spectral_stats(spectral_stats, ctx->fft_size);
+    std::vector<SignalRegion> sk_regions;   // Latest SK detections (refreshed once per M-frame block)
+    uint64_t sk_center_freq = 0;
+
+    // Per-emitter and per-band bearings with their own Kalman tracks
+    BearingTableState bearing_table;
+    init_bearing_table(bearing_table, ctx->fft_size);
+
+    // Bearing-only emitter fixes from the moving platform
+    GeolocState geolocation;
+    init_geolocation(geolocation);
+
+    // Bearing-versus-frequency waterfall (computed only while a client polls)
+    DFWaterfallState df_waterfall;
+    init_df_waterfall(df_waterfall, ctx->fft_size);
+
+    // MVDR / MUSIC pseudo-spectrum over the array (computed only while enabled)
+    SuperResState superres;
+    init_superres_df(superres, ctx->fft_size);
+
     while (ctx->running->load(std::memory_order_acquire)) {
         // Pop FFT results from processing queue
         if (!ctx->fft_queue->pop(fft_buf)) {
@@ -337,10 +459,23 @@ void analysis_thread_func(PipelineContext* ctx) {
         }
 
         // Convert ComplexSample back to fftwf_complex for DF processing
-        for (size_t i = 0; i < fft_buf.size; i++) {
-            fft_buf.ch1_fft[i].to_fftw(fft_ch1_tmp[i]);
-            fft_buf.ch2_fft[i].to_fftw(fft_ch2_tmp[i]);
+        for (size_t ch = 0; ch < fft_buf.channels && ch < fft_tmp.size(); ch++) {
+            const ComplexSample* src = fft_buf.channel_fft(ch);
+            for (size_t i = 0; i < fft_buf.size; i++) {
+                src[i].to_fftw(fft_tmp[ch][i]);
+            }
         }
+        const uint8_t* ch1_mag = fft_buf.channel_mag(0);
+        const uint8_t* ch2_mag = fft_buf.channel_mag(1);
+        const float noise_floor_ch1 = fft_buf.noise_floor[0];
+        const float noise_floor_ch2 = fft_buf.noise_floor[1];
+
+        // Detection input: RX1/RX2, or the steered sum beam when the beamformer feeds CFAR
+        const bool beam_cfar = !fft_buf.beam_mag.empty();
+        const uint8_t* cfar_mag1 = beam_cfar ? fft_buf.beam_mag.data() : ch1_mag;
+        const uint8_t* cfar_mag2 = beam_cfar ? fft_buf.beam_mag.data() : ch2_mag;
+        const float cfar_floor1 = beam_cfar ? fft_buf.beam_noise_floor : noise_floor_ch1;
+        const float cfar_floor2 = beam_cfar ? fft_buf.beam_noise_floor : noise_floor_ch2;
 
         // Determine bin range for DF processing
         // If both start and end are 0, use entire spectrum
@@ -354,22 +489,43 @@ void analysis_thread_func(PipelineContext* ctx) {
         // Get current center frequency
         const uint64_t center_freq = ctx->center_freq->load(std::memory_order_relaxed);
 
-        // Time the direction finding (includes CFAR internally)
+        // Per-bin calibration for this tuning (immutable snapshot, rebuilt only on change)
+        const std::shared_ptr<const CalibrationTable> cal_table = get_calibration_table(
+            center_freq, ctx->sample_rate->load(std::memory_order_relaxed), fft_buf.size);
+        const float* cal_phasor = cal_table->enabled ? cal_table->phasor.data() : nullptr;
+
+        // Higher-order statistics refresh once per M-frame block
+        if (update_spectral_stats(spectral_stats, fft_ch1_tmp, fft_ch2_tmp, center_freq)) {
+            sk_regions = detect_signals_sk(spectral_stats, DEFAULT_SK_DETECTOR, 0, fft_buf.size - 1);
+            sk_center_freq = center_freq;
+            publish_spectral_stats(spectral_stats, sk_regions, center_freq,
+                                   ctx->sample_rate->load(std::memory_order_relaxed));
+        }
+        if (sk_center_freq != center_freq) sk_regions.clear();
+
+        // Time detection + direction finding
         auto df_start = std::chrono::high_resolution_clock::now();
 
-        // Perform direction finding (CFAR is done inside this function)
+        // Full-band CFAR, run once per frame and shared by DF, the bearing table and subspace DF.
+        // SK detections of the last block are merged in so sub-CFAR non-Gaussian emitters get bearings.
+        std::vector<SignalRegion> band_regions = detect_signals_cfar_with_floor(
+            cfar_mag1, cfar_mag2, fft_buf.size, DEFAULT_CFAR,
+            0, fft_buf.size - 1, cfar_floor1, cfar_floor2);
+        merge_signal_regions(band_regions, sk_regions);
+
+        // Perform direction finding over the detections inside the DF band
         DFResult df_result = compute_direction_finding(
             fft_ch1_tmp,
             fft_ch2_tmp,
-            fft_buf.ch1_mag.data(),
-            fft_buf.ch2_mag.data(),
-            fft_buf.size,
+            cfar_mag1,
+            cfar_mag2,
             bin_start,
             bin_end,
-            center_freq,
+            band_regions,
+            cal_phasor,
             g_last_valid_doa,
-            fft_buf.noise_floor_ch1,
-            fft_buf.noise_floor_ch2
+            cfar_floor1,
+            cfar_floor2
         );
 
         auto df_end = std::chrono::high_resolution_clock::now();
@@ -378,6 +534,33 @@ void analysis_thread_func(PipelineContext* ctx) {
         g_telemetry.df_computations.fetch_add(1);
         g_telemetry.signals_detected.fetch_add(df_result.num_signals);
 
+        // Inter-channel group delay over the DF band (skew monitor / wideband bearing)
+        update_gcc_phat(ctx->gcc_phat, fft_ch1_tmp, fft_ch2_tmp, bin_start, bin_end, center_freq,
+                        ctx->sample_rate->load(std::memory_order_relaxed), *cal_table);
+
+        // Bearing for every detected emitter and user DF band from this frame
+        update_bearing_table(bearing_table, fft_ch1_tmp, fft_ch2_tmp, band_regions,
+                             noise_power_from_floor(noise_floor_ch1, noise_floor_ch2),
+                             center_freq, cal_phasor);
+        if (bearing_table.frame_counter % BearingTableConfig::PUBLISH_INTERVAL_FRAMES == 0) {
+            publish_bearing_table(bearing_table, center_freq, ctx->sample_rate->load(std::memory_order_relaxed),
+                                  fft_buf.size);
+        }
+        update_geolocation(geolocation, bearing_table, fft_buf.timestamp_us, center_freq,
+                           ctx->sample_rate->load(std::memory_order_relaxed), fft_buf.size);
+
+        // Subspace DF uses every channel of the array
+        if (superres_df_enabled()) {
+            update_superres_df(superres, fft_tmp.data(), band_regions, center_freq,
+                               ctx->sample_rate->load(std::memory_order_relaxed), cal_phasor);
+        }
+
+        if (df_waterfall_active()) {
+            update_df_waterfall(df_waterfall, fft_ch1_tmp, fft_ch2_tmp, ch1_mag,
+                                ch2_mag,
+                                std::max(noise_floor_ch1, noise_floor_ch2), cal_phasor);
+        }
+
         // Update DoA result for web interface
         update_doa_result(df_result.azimuth, df_result.back_azimuth,
                          df_result.phase_diff_deg, df_result.phase_std_deg,
@@ -388,8 +571,10 @@ void analysis_thread_func(PipelineContext* ctx) {
     }
 
     // Cleanup
-    free(fft_ch1_tmp);
-    free(fft_ch2_tmp);
+    destroy_bearing_table(bearing_table);
+    for (auto buf : fft_tmp) {
+        free(buf);
+    }
 
     std::cout << "[Pipeline] Analysis thread stopped" << std::endl;
 }
@@ -0,0 +1,259 @@
+#include "pulse_detector.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Published pulse history (written by processing thread, read by web server)
+static std::deque<PulseDescriptor> g_pulse_history;
+static PulseReport g_pulse_summary;
+static std::mutex g_pulse_mutex;
+
+void init_pulse_detector(PulseDetectorState& state) {
+    for (auto& ch : state.channels) {
+        ch.noise_power = 1.0f;
+        ch.noise_initialized = false;
+        ch.in_pulse = false;
+        ch.pulse_start = 0;
+        ch.below_count = 0;
+        ch.peak_power = 0;
+        ch.energy = 0.0;
+        ch.last_pulse_start = UINT64_MAX;
+        ch.pri_estimate_us = 0.0f;
+        ch.pri_stable_count = 0;
+    }
+    state.block_power.assign(PulseConfig::BLOCK_SAMPLES * PulseConfig::NUM_CHANNELS, 0);
+    state.pulses_detected = 0;
+    state.samples_processed = 0;
+}
+
+// Compute interleaved per-sample power [p1(0), p2(0), p1(1), p2(1), ...] for one block,
+// the per-channel power sum, and whether any sample crossed the channel's high threshold
+// Frames hold `channels` I/Q pairs; only the first two channels are monitored
+// Note: madd of int16 overflows only for I = Q = -32768, which SC16_Q11 (+/-2048) cannot produce
+static void compute_block_power(const int16_t* iq, size_t n, size_t channels, int32_t* pw,
+                                const int32_t hi[2], float sum[2], bool any[2]) {
+    size_t i = 0;
+    const size_t stride = channels * 2;
+    sum[0] = sum[1] = 0.0f;
+    any[0] = any[1] = false;
+
+#if defined(__SSE2__)
+    if (channels == 2) {
+        // Each 128-bit load holds two sample frames [I1,Q1,I2,Q2,I1,Q1,I2,Q2];
+        // madd(v, v) yields [ch1, ch2, ch1, ch2] power lanes
+        const __m128i thr = _mm_setr_epi32(hi[0], hi[1], hi[0], hi[1]);
+        __m128i mask = _mm_setzero_si128();
+        __m128 acc = _mm_setzero_ps();
+
+        for (; i + 2 <= n; i += 2) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iq + i * 4));
+            const __m128i p = _mm_madd_epi16(v, v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pw + i * 2), p);
+            mask = _mm_or_si128(mask, _mm_cmpgt_epi32(p, thr));
+            acc = _mm_add_ps(acc, _mm_cvtepi32_ps(p));
+        }
+
+        alignas(16) float acc_lanes[4];
+        alignas(16) int32_t mask_lanes[4];
+        _mm_store_ps(acc_lanes, acc);
+        _mm_store_si128(reinterpret_cast<__m128i*>(mask_lanes), mask);
+        sum[0] = acc_lanes[0] + acc_lanes[2];
+        sum[1] = acc_lanes[1] + acc_lanes[3];
+        any[0] = (mask_lanes[0] | mask_lanes[2]) != 0;
+        any[1] = (mask_lanes[1] | mask_lanes[3]) != 0;
+    }
+#endif
+
+    // Scalar tail (and full path for other frame layouts or non-SSE2 targets)
+    for (; i < n; i++) {
+        const int16_t* s = iq + i * stride;
+        for (int ch = 0; ch < 2; ch++) {
+            const int32_t re = s[ch * 2];
+            const int32_t im = s[ch * 2 + 1];
+            const int32_t p = re * re + im * im;
+            pw[i * 2 + ch] = p;
+            sum[ch] += static_cast<float>(p);
+            any[ch] = any[ch] || (p > hi[ch]);
+        }
+    }
+}
+
+static void finish_pulse(PulseChannelState& cs, uint8_t channel, uint64_t end_sample,
+                         uint64_t first_sample, uint64_t timestamp_us, uint32_t sample_rate,
+                         std::vector<PulseDescriptor>& pulses) {
+    cs.in_pulse = false;
+
+    const uint64_t width = end_sample - cs.pulse_start;
+    if (width < PulseConfig::MIN_PULSE_SAMPLES) return;
+
+    const double us_per_sample = 1e6 / static_cast<double>(sample_rate);
+
+    PulseDescriptor pulse;
+    pulse.channel = channel;
+    pulse.start_sample = cs.pulse_start;
+    // Pulses may start in an earlier buffer, so offset can be negative
+    const double offset_us = (static_cast<double>(cs.pulse_start) - static_cast<double>(first_sample)) * us_per_sample;
+    pulse.timestamp_us = static_cast<uint64_t>(static_cast<double>(timestamp_us) + offset_us);
+    pulse.width_samples = static_cast<uint32_t>(width);
+    pulse.width_us = static_cast<float>(width * us_per_sample);
+    pulse.peak_amplitude = std::sqrt(static_cast<float>(cs.peak_power));
+
+    const double samples_in_energy = static_cast<double>(end_sample + cs.below_count - cs.pulse_start);
+    const double mean_power = cs.energy / std::max(1.0, samples_in_energy);
+    pulse.mean_power_db = 10.0f * std::log10(static_cast<float>(mean_power) / cs.noise_power);
+
+    // Pulse repetition interval and stability tracking
+    pulse.pri_us = 0.0f;
+    if (cs.last_pulse_start != UINT64_MAX && cs.pulse_start > cs.last_pulse_start) {
+        const float pri = static_cast<float>((cs.pulse_start - cs.last_pulse_start) * us_per_sample);
+        pulse.pri_us = pri;
+
+        if (cs.pri_estimate_us > 0.0f &&
+            std::fabs(pri - cs.pri_estimate_us) < PulseConfig::PRI_TOLERANCE * cs.pri_estimate_us) {
+            cs.pri_estimate_us = 0.9f * cs.pri_estimate_us + 0.1f * pri;
+            cs.pri_stable_count++;
+        } else {
+            cs.pri_estimate_us = pri;
+            cs.pri_stable_count = 0;
+        }
+    }
+    cs.last_pulse_start = cs.pulse_start;
+
+    pulses.push_back(pulse);
+}
+
+void detect_pulses(PulseDetectorState& state, const int16_t* iq_buffer, size_t count, size_t channels,
+                   uint64_t first_sample, uint64_t timestamp_us, uint32_t sample_rate,
+                   std::vector<PulseDescriptor>& pulses) {
+    constexpr size_t BLOCK = PulseConfig::BLOCK_SAMPLES;
+    int32_t* pw = state.block_power.data();
+    const size_t pulses_before = pulses.size();
+
+    for (size_t base = 0; base < count; base += BLOCK) {
+        const size_t n = std::min(BLOCK, count - base);
+
+        int32_t hi[2];
+        int32_t lo[2];
+        for (int ch = 0; ch < 2; ch++) {
+            const float noise = state.channels[ch].noise_power;
+            hi[ch] = static_cast<int32_t>(std::min(noise * PulseConfig::HIGH_THRESHOLD_FACTOR, 2.0e9f));
+            lo[ch] = static_cast<int32_t>(std::min(noise * PulseConfig::LOW_THRESHOLD_FACTOR, 2.0e9f));
+        }
+
+        float sum[2];
+        bool any[2];
+        compute_block_power(iq_buffer + base * channels * 2, n, channels, pw, hi, sum, any);
+
+        for (int ch = 0; ch < 2; ch++) {
+            PulseChannelState& cs = state.channels[ch];
+
+            // Seed the noise estimate from the first block before arming the detector
+            if (!cs.noise_initialized) {
+                cs.noise_power = std::max(1.0f, sum[ch] / n);
+                cs.noise_initialized = true;
+                continue;
+            }
+
+            // Fast path: idle channel and no crossing in this block - only track noise
+            if (!cs.in_pulse && !any[ch]) {
+                const float mean = std::max(1.0f, sum[ch] / n);
+                cs.noise_power += PulseConfig::NOISE_ALPHA * (mean - cs.noise_power);
+                continue;
+            }
+
+            // Slow path: per-sample hysteresis state machine
+            for (size_t k = 0; k < n; k++) {
+                const int32_t p = pw[k * 2 + ch];
+                const uint64_t idx = first_sample + base + k;
+
+                if (!cs.in_pulse) {
+                    if (p > hi[ch]) {
+                        cs.in_pulse = true;
+                        cs.pulse_start = idx;
+                        cs.peak_power = p;
+                        cs.energy = p;
+                        cs.below_count = 0;
+                    }
+                    continue;
+                }
+
+                cs.energy += p;
+                cs.peak_power = std::max(cs.peak_power, p);
+
+                if (p < lo[ch]) {
+                    if (++cs.below_count >= PulseConfig::HANGOVER_SAMPLES) {
+                        // Pulse ended at the first sample of the hangover run
+                        const uint64_t end = idx + 1 - cs.below_count;
+                        finish_pulse(cs, static_cast<uint8_t>(ch), end, first_sample, timestamp_us,
+                                     sample_rate, pulses);
+                    }
+                } else {
+                    cs.below_count = 0;
+                }
+
+                if (cs.in_pulse && idx - cs.pulse_start >= PulseConfig::MAX_PULSE_SAMPLES) {
+                    // Sustained carrier: absorb it into the noise estimate so the threshold adapts
+                    cs.noise_power = static_cast<float>(cs.energy / (idx + 1 - cs.pulse_start));
+                    cs.in_pulse = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    state.samples_processed += count;
+    state.pulses_detected += pulses.size() - pulses_before;
+}
+
+void publish_pulses(const PulseDetectorState& state, const std::vector<PulseDescriptor>& pulses) {
+    std::lock_guard<std::mutex> lock(g_pulse_mutex);
+
+    for (const auto& pulse : pulses) {
+        g_pulse_history.push_back(pulse);
+    }
+    while (g_pulse_history.size() > PulseConfig::HISTORY_SIZE) {
+        g_pulse_history.pop_front();
+    }
+
+    for (int ch = 0; ch < PulseConfig::NUM_CHANNELS; ch++) {
+        const PulseChannelState& cs = state.channels[ch];
+        // Only report PRI once several consecutive pulses agree
+        g_pulse_summary.pri_estimate_us[ch] = (cs.pri_stable_count >= 3) ? cs.pri_estimate_us : 0.0f;
+        g_pulse_summary.noise_power_db[ch] = 10.0f * std::log10(std::max(1.0f, cs.noise_power));
+    }
+    g_pulse_summary.pulses_detected = state.pulses_detected;
+}
+
+std::string get_pulses_json() {
+    std::lock_guard<std::mutex> lock(g_pulse_mutex);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"pulsesDetected\":" << g_pulse_summary.pulses_detected
+         << ",\"priEstimateUs\":[" << g_pulse_summary.pri_estimate_us[0] << "," << g_pulse_summary.pri_estimate_us[1] << "]"
+         << ",\"noisePowerDb\":[" << g_pulse_summary.noise_power_db[0] << "," << g_pulse_summary.noise_power_db[1] << "]"
+         << ",\"pulses\":[";
+
+    bool first = true;
+    for (const auto& p : g_pulse_history) {
+        if (!first) json << ",";
+        first = false;
+        json << "{\"ch\":" << static_cast<int>(p.channel) + 1
+             << ",\"sample\":" << p.start_sample
+             << ",\"timestampUs\":" << p.timestamp_us
+             << ",\"widthSamples\":" << p.width_samples
+             << ",\"widthUs\":" << p.width_us
+             << ",\"peak\":" << p.peak_amplitude
+             << ",\"powerDb\":" << p.mean_power_db
+             << ",\"priUs\":" << p.pri_us << "}";
+    }
+    json << "]}";
+    return json.str();
+}
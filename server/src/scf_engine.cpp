@@ -0,0 +1,481 @@
+#include "scf_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using cf32 = std::complex<float>;
+
+// Job lifecycle (capture happens on the processing thread, compute on the worker)
+enum class ScfJobState { IDLE, CAPTURING, RUNNING, DONE };
+
+// Precomputed plans and job buffers (created once at start)
+struct ScfEngine {
+    fftwf_plan channel_plan;            // BLOCKS batched CHANNEL_FFT-point transforms
+    fftwf_plan cycle_plan;              // CHANNEL_FFT batched BLOCKS-point transforms
+    fftwf_complex* frames_in;           // BLOCKS x CHANNEL_FFT
+    fftwf_complex* frames_out;
+    std::vector<cf32> capture;          // Raw samples (one channel)
+    std::vector<cf32> decimated;        // Sub-band samples
+    std::vector<cf32> channels;         // Channelizer output, transposed: CHANNEL_FFT x BLOCKS
+    std::vector<float> psd;             // Mean |X|^2 per channel
+    std::vector<float> window;
+    unsigned num_threads;
+};
+
+static ScfEngine g_engine;
+static std::thread g_scf_thread;
+static std::atomic<bool> g_scf_running{false};
+static std::mutex g_scf_mutex;                  // Guards job fields and results below
+static std::condition_variable g_scf_cv;
+
+// Tap state (written by the processing thread while capturing)
+static std::atomic<bool> g_scf_capturing{false};
+static size_t g_capture_needed = 0;
+static size_t g_capture_count = 0;
+static uint64_t g_capture_next_sample = 0;
+static int g_capture_channel = 0;
+
+// Current job and last results
+static ScfJobState g_job_state = ScfJobState::IDLE;
+static ScfRequest g_job_request;
+static uint64_t g_job_center_freq = 0;
+static uint32_t g_job_sample_rate = 0;
+static int g_job_decimation = 1;
+static double g_job_compute_ms = 0.0;
+static uint64_t g_jobs_completed = 0;
+static std::vector<ScfFeature> g_features;
+static std::vector<uint8_t> g_scf_map;
+
+// Lower the calling thread's scheduling priority (per-thread nice on Linux)
+static void lower_thread_priority() {
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), ScfConfig::WORKER_NICE);
+}
+
+// Mix the sub-band to DC and decimate by D with a windowed-sinc lowpass
+// Only the retained output samples are computed
+static void downconvert(const std::vector<cf32>& in, double offset_norm, int decimation,
+                        std::vector<cf32>& out) {
+    const size_t out_count = ScfConfig::DECIMATED_SAMPLES;
+    out.resize(out_count);
+
+    if (decimation == 1 && offset_norm == 0.0) {
+        std::copy(in.begin(), in.begin() + out_count, out.begin());
+        return;
+    }
+
+    // Mix to DC (phasor recurrence, renormalized periodically)
+    const size_t taps = (decimation > 1) ? ScfConfig::TAPS_PER_PHASE * decimation + 1 : 1;
+    const size_t in_count = (out_count - 1) * decimation + taps;
+    std::vector<cf32> mixed(in_count);
+    const std::complex<double> step = std::polar(1.0, -2.0 * M_PI * offset_norm);
+    std::complex<double> phasor(1.0, 0.0);
+    for (size_t i = 0; i < in_count; i++) {
+        mixed[i] = in[i] * cf32(static_cast<float>(phasor.real()), static_cast<float>(phasor.imag()));
+        phasor *= step;
+        if ((i & 1023) == 0) phasor /= std::abs(phasor);
+    }
+
+    if (taps == 1) {
+        std::copy(mixed.begin(), mixed.begin() + out_count, out.begin());
+        return;
+    }
+
+    // Hamming-windowed sinc, cutoff at 80% of the decimated Nyquist
+    std::vector<float> h(taps);
+    const double cutoff = 0.8 * 0.5 / decimation;
+    const double center = (taps - 1) / 2.0;
+    double gain = 0.0;
+    for (size_t t = 0; t < taps; t++) {
+        const double x = t - center;
+        const double sinc = (x == 0.0) ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        h[t] = static_cast<float>(sinc * (0.54 - 0.46 * std::cos(2.0 * M_PI * t / (taps - 1))));
+        gain += h[t];
+    }
+    for (auto& coeff : h) coeff = static_cast<float>(coeff / gain);
+
+    for (size_t n = 0; n < out_count; n++) {
+        const cf32* src = mixed.data() + n * decimation;
+        float re = 0.0f, im = 0.0f;
+        for (size_t t = 0; t < taps; t++) {
+            re += src[t].real() * h[t];
+            im += src[t].imag() * h[t];
+        }
+        out[n] = cf32(re, im);
+    }
+}
+
+// Stage 1: channelize with one batched FFT, reference every frame to time zero,
+// transpose to channel-major order and compute the per-channel PSD
+static void channelize() {
+    constexpr int NP = ScfConfig::CHANNEL_FFT;
+    constexpr int P = ScfConfig::BLOCKS;
+    constexpr int L = ScfConfig::HOP;
+
+    for (int p = 0; p < P; p++) {
+        const cf32* src = g_engine.decimated.data() + p * L;
+        fftwf_complex* dst = g_engine.frames_in + p * NP;
+        for (int n = 0; n < NP; n++) {
+            dst[n][0] = src[n].real() * g_engine.window[n];
+            dst[n][1] = src[n].imag() * g_engine.window[n];
+        }
+    }
+
+    fftwf_execute(g_engine.channel_plan);
+
+    std::fill(g_engine.psd.begin(), g_engine.psd.end(), 0.0f);
+    for (int p = 0; p < P; p++) {
+        const fftwf_complex* frame = g_engine.frames_out + p * NP;
+        for (int kc = -NP / 2; kc < NP / 2; kc++) {
+            const int k = (kc + NP) % NP;
+            // Frame p starts at sample p*L: remove the exp(j*2*pi*k*p*L/N') carrier
+            const float phase = -2.0f * static_cast<float>(M_PI) * kc * p * L / NP;
+            const cf32 x = cf32(frame[k][0], frame[k][1]) * std::polar(1.0f, phase);
+            const int row = kc + NP / 2;
+            g_engine.channels[row * P + p] = x;
+            g_engine.psd[row] += std::norm(x);
+        }
+    }
+    for (auto& s : g_engine.psd) s /= P;
+}
+
+// Per-thread output: cyclic profile (max coherence per alpha bin) and coherence map
+struct ScfPartial {
+    std::vector<float> profile;         // 2 * BLOCKS * HOP alpha bins spanning [-fs, fs)
+    std::vector<int> profile_freq;      // Half-channel frequency index of the profile maximum
+    std::vector<float> map;             // FREQ_BINS x ALPHA_BINS
+};
+
+// Stage 2: for channel rows [row_begin, row_end), form products with every other
+// channel and transform all of them with the batched cycle plan
+static void correlate_rows(int row_begin, int row_end, ScfPartial& part) {
+    constexpr int NP = ScfConfig::CHANNEL_FFT;
+    constexpr int P = ScfConfig::BLOCKS;
+    constexpr int ALPHA_PER_CHANNEL = P * ScfConfig::HOP / NP;  // Profile bins per channel spacing
+    constexpr int PROFILE_BINS = 2 * P * ScfConfig::HOP;
+    constexpr int PROFILE_CENTER = PROFILE_BINS / 2;
+
+    lower_thread_priority();
+
+    fftwf_complex* products = fftwf_alloc_complex(NP * P);
+    fftwf_complex* cycles = fftwf_alloc_complex(NP * P);
+    const float inv_p = 1.0f / P;
+
+    for (int r1 = row_begin; r1 < row_end; r1++) {
+        const cf32* x1 = g_engine.channels.data() + r1 * P;
+        for (int r2 = 0; r2 < NP; r2++) {
+            const cf32* x2 = g_engine.channels.data() + r2 * P;
+            fftwf_complex* y = products + r2 * P;
+            for (int p = 0; p < P; p++) {
+                const cf32 v = x1[p] * std::conj(x2[p]);
+                y[p][0] = v.real();
+                y[p][1] = v.imag();
+            }
+        }
+
+        fftwf_execute_dft(g_engine.cycle_plan, products, cycles);
+
+        for (int r2 = 0; r2 < NP; r2++) {
+            const float norm = std::sqrt(g_engine.psd[r1] * g_engine.psd[r2]);
+            if (norm <= 0.0f) continue;
+            const float inv_norm = inv_p / norm;
+            const fftwf_complex* c = cycles + r2 * P;
+            const int alpha_base = (r1 - r2) * ALPHA_PER_CHANNEL;
+            const int freq_half = r1 + r2;             // f = (f1 + f2) / 2 in half-channel steps
+            const int map_row = freq_half / 2;
+
+            // Keep the central half of the cycle FFT (the rest overlaps neighbouring pairs)
+            for (int q = -P / 4; q < P / 4; q++) {
+                const int bin = (q + P) % P;
+                const float coherence = std::hypot(c[bin][0], c[bin][1]) * inv_norm;
+                const int a = PROFILE_CENTER + alpha_base + q;
+                if (a < 0 || a >= PROFILE_BINS) continue;
+
+                if (coherence > part.profile[a]) {
+                    part.profile[a] = coherence;
+                    part.profile_freq[a] = freq_half;
+                }
+                const int col = a * ScfConfig::ALPHA_BINS / PROFILE_BINS;
+                float& cell = part.map[map_row * ScfConfig::ALPHA_BINS + col];
+                cell = std::max(cell, coherence);
+            }
+        }
+    }
+
+    fftwf_free(products);
+    fftwf_free(cycles);
+}
+
+// Run one complete job on the captured samples
+static void run_scf_job() {
+    constexpr int NP = ScfConfig::CHANNEL_FFT;
+    constexpr int P = ScfConfig::BLOCKS;
+    constexpr int PROFILE_BINS = 2 * P * ScfConfig::HOP;
+    constexpr int PROFILE_CENTER = PROFILE_BINS / 2;
+
+    ScfRequest request;
+    uint64_t center_freq;
+    uint32_t sample_rate;
+    int decimation;
+    {
+        std::lock_guard<std::mutex> lock(g_scf_mutex);
+        request = g_job_request;
+        center_freq = g_job_center_freq;
+        sample_rate = g_job_sample_rate;
+        decimation = g_job_decimation;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    downconvert(g_engine.capture, request.offset_hz / sample_rate, decimation, g_engine.decimated);
+    channelize();
+
+    // Split channel rows across workers
+    const unsigned threads = g_engine.num_threads;
+    std::vector<ScfPartial> parts(threads);
+    std::vector<std::thread> workers;
+    const int rows_per_thread = (NP + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++) {
+        parts[t].profile.assign(PROFILE_BINS, 0.0f);
+        parts[t].profile_freq.assign(PROFILE_BINS, 0);
+        parts[t].map.assign(ScfConfig::FREQ_BINS * ScfConfig::ALPHA_BINS, 0.0f);
+        const int begin = t * rows_per_thread;
+        const int end = std::min(NP, begin + rows_per_thread);
+        if (begin >= end) continue;
+        workers.emplace_back(correlate_rows, begin, end, std::ref(parts[t]));
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // Merge partial results
+    ScfPartial& merged = parts[0];
+    for (unsigned t = 1; t < threads; t++) {
+        for (int a = 0; a < PROFILE_BINS; a++) {
+            if (parts[t].profile[a] > merged.profile[a]) {
+                merged.profile[a] = parts[t].profile[a];
+                merged.profile_freq[a] = parts[t].profile_freq[a];
+            }
+        }
+        for (size_t i = 0; i < merged.map.size(); i++) {
+            merged.map[i] = std::max(merged.map[i], parts[t].map[i]);
+        }
+    }
+
+    // Cyclic features: local maxima of the positive-alpha profile, outside the PSD line,
+    // that stand clear of the noise peaks (features occupy far fewer bins than the top percentile)
+    std::vector<float> sorted(merged.profile.begin() + PROFILE_CENTER + ScfConfig::ALPHA_GUARD,
+                              merged.profile.end());
+    const size_t noise_rank = sorted.size() * ScfConfig::NOISE_PERCENTILE / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + noise_rank, sorted.end());
+    const float feature_threshold = sorted[noise_rank] * ScfConfig::FEATURE_THRESHOLD;
+
+    const double fs_dec = static_cast<double>(sample_rate) / decimation;
+    const double alpha_step = fs_dec / (P * ScfConfig::HOP);
+    const double half_channel_hz = fs_dec / NP / 2.0;
+    std::vector<ScfFeature> features;
+    for (int a = PROFILE_CENTER + ScfConfig::ALPHA_GUARD; a < PROFILE_BINS - 1; a++) {
+        const float v = merged.profile[a];
+        if (v < feature_threshold || v <= merged.profile[a - 1] || v < merged.profile[a + 1]) continue;
+        ScfFeature feature;
+        feature.alpha_hz = (a - PROFILE_CENTER) * alpha_step;
+        feature.freq_hz = static_cast<double>(center_freq) + request.offset_hz +
+                          (merged.profile_freq[a] - NP) * half_channel_hz;
+        feature.coherence = v;
+        features.push_back(feature);
+    }
+    std::sort(features.begin(), features.end(),
+              [](const ScfFeature& x, const ScfFeature& y) { return x.coherence > y.coherence; });
+    if (features.size() > ScfConfig::MAX_FEATURES) {
+        features.resize(ScfConfig::MAX_FEATURES);
+    }
+
+    std::vector<uint8_t> map(merged.map.size());
+    for (size_t i = 0; i < map.size(); i++) {
+        map[i] = static_cast<uint8_t>(std::clamp(merged.map[i] * 255.0f, 0.0f, 255.0f));
+    }
+
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(g_scf_mutex);
+    g_features.swap(features);
+    g_scf_map.swap(map);
+    g_job_compute_ms = elapsed_ms;
+    g_jobs_completed++;
+    g_job_state = ScfJobState::DONE;
+}
+
+static void scf_thread_func() {
+    lower_thread_priority();
+
+    while (g_scf_running.load()) {
+        {
+            std::unique_lock<std::mutex> lock(g_scf_mutex);
+            g_scf_cv.wait(lock, [] { return !g_scf_running.load() || g_job_state == ScfJobState::RUNNING; });
+            if (!g_scf_running.load()) break;
+        }
+        run_scf_job();
+    }
+}
+
+void start_scf_engine() {
+    constexpr int NP = ScfConfig::CHANNEL_FFT;
+    constexpr int P = ScfConfig::BLOCKS;
+
+    g_engine.frames_in = fftwf_alloc_complex(P * NP);
+    g_engine.frames_out = fftwf_alloc_complex(P * NP);
+    g_engine.channels.assign(NP * P, cf32(0.0f, 0.0f));
+    g_engine.psd.assign(NP, 0.0f);
+    g_engine.capture.assign(ScfConfig::MAX_CAPTURE_SAMPLES, cf32(0.0f, 0.0f));
+    generate_window(WINDOW_HAMMING, NP, g_engine.window);
+
+    // Plans are created here, on the main thread; workers only use fftwf_execute_dft
+    const int np = NP;
+    const int p = P;
+    g_engine.channel_plan = fftwf_plan_many_dft(1, &np, P, g_engine.frames_in, nullptr, 1, NP,
+                                                g_engine.frames_out, nullptr, 1, NP,
+                                                FFTW_FORWARD, FFTW_MEASURE);
+    fftwf_complex* cycle_in = fftwf_alloc_complex(NP * P);
+    fftwf_complex* cycle_out = fftwf_alloc_complex(NP * P);
+    g_engine.cycle_plan = fftwf_plan_many_dft(1, &p, NP, cycle_in, nullptr, 1, P,
+                                              cycle_out, nullptr, 1, P,
+                                              FFTW_FORWARD, FFTW_MEASURE);
+    fftwf_free(cycle_in);
+    fftwf_free(cycle_out);
+
+    const unsigned hw = std::thread::hardware_concurrency();
+    g_engine.num_threads = std::clamp(hw > 2 ? hw - 2 : 1u, 1u, ScfConfig::MAX_THREADS);
+
+    g_scf_running.store(true);
+    g_scf_thread = std::thread(scf_thread_func);
+    std::cout << "[SCF] Engine ready (" << g_engine.num_threads << " worker threads)" << std::endl;
+}
+
+void stop_scf_engine() {
+    if (!g_scf_running.load()) return;
+
+    g_scf_running.store(false);
+    g_scf_capturing.store(false);
+    g_scf_cv.notify_all();
+    if (g_scf_thread.joinable()) {
+        g_scf_thread.join();
+    }
+
+    fftwf_destroy_plan(g_engine.channel_plan);
+    fftwf_destroy_plan(g_engine.cycle_plan);
+    fftwf_free(g_engine.frames_in);
+    fftwf_free(g_engine.frames_out);
+}
+
+bool submit_scf_job(const ScfRequest& request, uint64_t center_freq, uint32_t sample_rate,
+                    std::string& error) {
+    if (!g_scf_running.load()) {
+        error = "SCF engine not running";
+        return false;
+    }
+    if (sample_rate == 0 || request.bandwidth_hz <= 0.0 ||
+        std::fabs(request.offset_hz) + request.bandwidth_hz / 2.0 > sample_rate / 2.0) {
+        error = "Sub-band outside the captured bandwidth";
+        return false;
+    }
+
+    // Largest decimation that still keeps the requested bandwidth inside the filter passband
+    int decimation = std::max(1, static_cast<int>(0.8 * sample_rate / request.bandwidth_hz));
+    const size_t max_decimation = (ScfConfig::MAX_CAPTURE_SAMPLES - 1) /
+                                  (ScfConfig::DECIMATED_SAMPLES + ScfConfig::TAPS_PER_PHASE);
+    decimation = std::min(decimation, static_cast<int>(max_decimation));
+    const size_t taps = (decimation > 1) ? ScfConfig::TAPS_PER_PHASE * decimation + 1 : 1;
+
+    std::lock_guard<std::mutex> lock(g_scf_mutex);
+    if (g_job_state == ScfJobState::CAPTURING || g_job_state == ScfJobState::RUNNING) {
+        error = "SCF job already in progress";
+        return false;
+    }
+
+    g_job_request = request;
+    g_job_center_freq = center_freq;
+    g_job_sample_rate = sample_rate;
+    g_job_decimation = decimation;
+    g_job_state = ScfJobState::CAPTURING;
+
+    g_capture_needed = (ScfConfig::DECIMATED_SAMPLES - 1) * decimation + taps;
+    g_capture_count = 0;
+    g_capture_channel = (request.channel == 2) ? 1 : 0;
+    g_scf_capturing.store(true, std::memory_order_release);
+    return true;
+}
+
+void scf_capture_tap(const IQFrontEnd& front_end, uint64_t first_sample) {
+    if (!g_scf_capturing.load(std::memory_order_acquire)) return;
+
+    // The FAM needs contiguous samples - a dropped buffer restarts the capture
+    if (g_capture_count > 0 && first_sample != g_capture_next_sample) {
+        g_capture_count = 0;
+    }
+
+    const float* src = front_end.channel(g_capture_channel == 1 ? 1 : 0);
+    const size_t n = std::min(front_end.count, g_capture_needed - g_capture_count);
+    memcpy(reinterpret_cast<float*>(g_engine.capture.data() + g_capture_count), src, n * sizeof(cf32));
+    g_capture_count += n;
+    g_capture_next_sample = first_sample + front_end.count;
+
+    if (g_capture_count >= g_capture_needed) {
+        g_scf_capturing.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(g_scf_mutex);
+            g_job_state = ScfJobState::RUNNING;
+        }
+        g_scf_cv.notify_one();
+    }
+}
+
+std::string get_scf_status_json() {
+    static const char* STATE_NAMES[] = {"idle", "capturing", "running", "done"};
+
+    std::lock_guard<std::mutex> lock(g_scf_mutex);
+    const double fs_dec = (g_job_sample_rate > 0) ? static_cast<double>(g_job_sample_rate) / g_job_decimation : 0.0;
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\"state\":\"" << STATE_NAMES[static_cast<int>(g_job_state)] << "\""
+         << ",\"jobs\":" << g_jobs_completed
+         << ",\"channel\":" << g_job_request.channel
+         << ",\"offsetHz\":" << g_job_request.offset_hz
+         << ",\"bandwidthHz\":" << g_job_request.bandwidth_hz
+         << ",\"decimation\":" << g_job_decimation
+         << ",\"sampleRateHz\":" << fs_dec
+         << ",\"alphaResolutionHz\":" << fs_dec / (ScfConfig::BLOCKS * ScfConfig::HOP)
+         << ",\"computeMs\":" << g_job_compute_ms
+         << ",\"mapFreqBins\":" << ScfConfig::FREQ_BINS
+         << ",\"mapAlphaBins\":" << ScfConfig::ALPHA_BINS
+         << ",\"features\":[";
+    for (size_t i = 0; i < g_features.size(); i++) {
+        if (i > 0) json << ",";
+        json << "{\"alphaHz\":" << g_features[i].alpha_hz
+             << ",\"freqHz\":" << g_features[i].freq_hz
+             << std::setprecision(3)
+             << ",\"coherence\":" << g_features[i].coherence << "}"
+             << std::setprecision(1);
+    }
+    json << "]}";
+    return json.str();
+}
+
+bool get_scf_map(std::vector<uint8_t>& out) {
+    std::lock_guard<std::mutex> lock(g_scf_mutex);
+    if (g_scf_map.empty()) return false;
+    out = g_scf_map;
+    return true;
+}
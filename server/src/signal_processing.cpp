@@ -1,9 +1,14 @@
 #include "signal_processing.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 void generate_window(uint32_t window_type, size_t length, std::vector<float>& window) {
     window.resize(length);
@@ -153,6 +158,85 @@ void remove_dc_offset(uint8_t *magnitude, size_t size) {
     }
 }
 
+// Output window bounds floor(i*span/width) stepped without a divide per window
+struct DecimationWindows {
+    size_t lo;                 // Start of the current window
+    size_t quotient, remainder, width, error;
+
+    DecimationWindows(size_t span, size_t out_width)
+        : lo(0), quotient(span / out_width), remainder(span % out_width), width(out_width), error(0) {}
+
+    // Advance to the next window, returning the end of the current one
+    size_t next() {
+        size_t hi = lo + quotient;
+        error += remainder;
+        if (error >= width) {
+            error -= width;
+            hi++;
+        }
+        lo = hi;
+        return hi;
+    }
+};
+
+// Elementwise max of a row and the row shifted by `step` (pmaxub when vectorized)
+static void max_shifted(const uint8_t* __restrict in, uint8_t* __restrict out, size_t n, size_t step) {
+    for (size_t k = 0; k + step < n; k++) {
+        out[k] = std::max(in[k], in[k + step]);
+    }
+}
+
+void decimate_spectrum(const uint8_t* mag, size_t start_bin, size_t end_bin,
+                       uint8_t* out, size_t out_width, uint32_t mode) {
+    const size_t span = end_bin - start_bin + 1;
+    const uint8_t* src = mag + start_bin;
+    if (out_width >= span) {
+        std::copy(src, src + span, out);
+        return;
+    }
+
+    if (mode == DECIMATE_MEAN) {
+        // Window sums from a prefix sum: every window costs two loads and a divide
+        thread_local std::vector<uint32_t> prefix;
+        prefix.resize(span + 1);
+        prefix[0] = 0;
+        for (size_t k = 0; k < span; k++) {
+            prefix[k + 1] = prefix[k] + src[k];
+        }
+        DecimationWindows windows(span, out_width);
+        for (size_t i = 0; i < out_width; i++) {
+            const size_t lo = windows.lo;
+            const uint32_t len = static_cast<uint32_t>(windows.next() - lo);
+            out[i] = static_cast<uint8_t>((prefix[lo + len] - prefix[lo] + len / 2) / len);
+        }
+        return;
+    }
+
+    // Windows are floor(span/out_width) or one bin longer. Doubling steps give the max of
+    // every P-bin run (P = largest power of two <= the short window) with contiguous,
+    // vectorizable byte-max passes; any window of length L <= 2P is then the max of two
+    // overlapping P-runs: max(run[lo], run[lo + L - P]).
+    const size_t min_len = span / out_width;
+    size_t run = 1;
+    while (run * 2 <= min_len) run *= 2;
+
+    thread_local std::vector<uint8_t> ping, pong;
+    ping.assign(src, src + span);
+    pong.resize(span);
+    for (size_t step = 1; step < run; step *= 2) {
+        max_shifted(ping.data(), pong.data(), span, step);
+        ping.swap(pong);
+    }
+    const uint8_t* runs = ping.data();
+
+    DecimationWindows windows(span, out_width);
+    for (size_t i = 0; i < out_width; i++) {
+        const size_t lo = windows.lo;
+        const size_t hi = windows.next();
+        out[i] = std::max(runs[lo], runs[hi - run]);
+    }
+}
+
 void compute_cross_correlation(fftwf_complex *fft_ch1, fftwf_complex *fft_ch2,
                               float *correlation, float *phase_diff, size_t size) {
     for (size_t i = 0; i < size; i++) {
@@ -269,18 +353,16 @@ void update_agc(AGCState& agc, const uint8_t* ch1_mag, const uint8_t* ch2_mag, s
     }
 }
 
-void init_noise_floor(NoiseFloorState& nf, size_t fft_size) {
-    nf.noise_floor_ch1 = 0.0f;
-    nf.noise_floor_ch2 = 0.0f;
-    nf.smoothed_floor_ch1 = 0.0f;
-    nf.smoothed_floor_ch2 = 0.0f;
+void init_noise_floor(NoiseFloorState& nf, size_t fft_size, size_t channels) {
+    nf.channels = std::min(channels, ChannelConfig::MAX_CHANNELS);
+    std::fill_n(nf.noise_floor, ChannelConfig::MAX_CHANNELS, 0.0f);
+    std::fill_n(nf.smoothed_floor, ChannelConfig::MAX_CHANNELS, 0.0f);
     nf.sorted_buffer.resize(fft_size);
     nf.update_counter = 0;
     nf.initialized = false;
 }
 
-void update_noise_floor(NoiseFloorState& nf, const uint8_t* ch1_mag, const uint8_t* ch2_mag,
-                       size_t len, float percentile, float alpha) {
+void update_noise_floor(NoiseFloorState& nf, const uint8_t* mag, size_t len, float percentile, float alpha) {
     // Update every 10 frames to reduce CPU load
     nf.update_counter++;
     if (nf.update_counter < 10) {
@@ -288,195 +370,353 @@ void update_noise_floor(NoiseFloorState& nf, const uint8_t* ch1_mag, const uint8
     }
     nf.update_counter = 0;
 
-    // Calculate noise floor for CH1 using percentile method with quickselect
+    // Calculate noise floor per channel using percentile method with quickselect
     // OPTIMIZED: Use std::nth_element instead of full sort - O(n) vs O(n log n)
     // This provides 60% speedup for percentile calculation
-    std::copy(ch1_mag, ch1_mag + len, nf.sorted_buffer.begin());
-
-    // Quickselect to find percentile (partially sorts, much faster than full sort)
     const size_t percentile_idx = static_cast<size_t>(len * percentile / 100.0f);
-    std::nth_element(nf.sorted_buffer.begin(),
-                     nf.sorted_buffer.begin() + percentile_idx,
-                     nf.sorted_buffer.end());
-
-    nf.noise_floor_ch1 = static_cast<float>(nf.sorted_buffer[percentile_idx]);
-
-    // Calculate noise floor for CH2
-    std::copy(ch2_mag, ch2_mag + len, nf.sorted_buffer.begin());
-    std::nth_element(nf.sorted_buffer.begin(),
-                     nf.sorted_buffer.begin() + percentile_idx,
-                     nf.sorted_buffer.end());
-    nf.noise_floor_ch2 = static_cast<float>(nf.sorted_buffer[percentile_idx]);
+    for (size_t ch = 0; ch < nf.channels; ch++) {
+        const uint8_t* plane = mag + ch * len;
+        std::copy(plane, plane + len, nf.sorted_buffer.begin());
+
+        // Quickselect to find percentile (partially sorts, much faster than full sort)
+        std::nth_element(nf.sorted_buffer.begin(),
+                         nf.sorted_buffer.begin() + percentile_idx,
+                         nf.sorted_buffer.end());
+        nf.noise_floor[ch] = static_cast<float>(nf.sorted_buffer[percentile_idx]);
+    }
 
     // Apply temporal smoothing (exponential moving average)
-    if (!nf.initialized) {
-        // First time - initialize without smoothing
-        nf.smoothed_floor_ch1 = nf.noise_floor_ch1;
-        nf.smoothed_floor_ch2 = nf.noise_floor_ch2;
-        nf.initialized = true;
-    } else {
-        // EWMA: smoothed = alpha * new + (1-alpha) * smoothed
-        nf.smoothed_floor_ch1 = alpha * nf.noise_floor_ch1 + (1.0f - alpha) * nf.smoothed_floor_ch1;
-        nf.smoothed_floor_ch2 = alpha * nf.noise_floor_ch2 + (1.0f - alpha) * nf.smoothed_floor_ch2;
+    for (size_t ch = 0; ch < nf.channels; ch++) {
+        if (!nf.initialized) {
+            // First time - initialize without smoothing
+            nf.smoothed_floor[ch] = nf.noise_floor[ch];
+        } else {
+            // EWMA: smoothed = alpha * new + (1-alpha) * smoothed
+            nf.smoothed_floor[ch] = alpha * nf.noise_floor[ch] + (1.0f - alpha) * nf.smoothed_floor[ch];
+        }
     }
+    nf.initialized = true;
 }
 
 void get_noise_floor(const NoiseFloorState& nf, float& ch1_floor, float& ch2_floor) {
-    ch1_floor = nf.smoothed_floor_ch1;
-    ch2_floor = nf.smoothed_floor_ch2;
+    ch1_floor = nf.smoothed_floor[0];
+    ch2_floor = nf.smoothed_floor[nf.channels > 1 ? 1 : 0];
+}
+
+float get_channel_noise_floor(const NoiseFloorState& nf, size_t channel) {
+    return (channel < nf.channels) ? nf.smoothed_floor[channel] : 0.0f;
 }
 
 void init_dc_offset(DCOffsetState& dc) {
-    dc.dc_i_ch1 = 0.0f;
-    dc.dc_q_ch1 = 0.0f;
-    dc.dc_i_ch2 = 0.0f;
-    dc.dc_q_ch2 = 0.0f;
+    std::fill_n(dc.dc_i, ChannelConfig::MAX_CHANNELS, 0.0f);
+    std::fill_n(dc.dc_q, ChannelConfig::MAX_CHANNELS, 0.0f);
     dc.last_freq = 0;
     dc.convergence_counter = 0;
 }
 
-void init_overlap(OverlapState& overlap, size_t fft_size) {
+void init_overlap(OverlapState& overlap, size_t fft_size, size_t channels) {
     const size_t overlap_size = fft_size / 2;
-    overlap.overlap_buf_ch1.resize(overlap_size * 2);  // * 2 for I/Q pairs
-    overlap.overlap_buf_ch2.resize(overlap_size * 2);  // * 2 for I/Q pairs
-    overlap.prev_magnitude_ch1.resize(fft_size);
-    overlap.prev_magnitude_ch2.resize(fft_size);
+    overlap.channels = channels;
+    overlap.overlap_buf.assign(channels * overlap_size * 2, 0.0f);  // * 2 for I/Q pairs
+    overlap.prev_magnitude.assign(channels * fft_size, 0);
     overlap.has_prev_fft = false;
 }
 
-IQProcessingResult process_iq_to_fft(
-    const int16_t* iq_buffer,
-    size_t buffer_size,
+// ============================================================================
+// Per-channel worker pool
+// Channels are independent from the overlap save to the magnitude, so with many
+// channels their FFT frames are spread over a few persistent threads (the calling
+// thread takes channels too). Below PARALLEL_MIN_CHANNELS everything runs inline.
+// ============================================================================
+
+struct ChannelWorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t count = 0;
+    uint64_t generation = 0;
+    unsigned busy = 0;
+    bool stop = false;
+    std::atomic<size_t> next_item{0};
+};
+
+static ChannelWorkerPool g_channel_pool;
+
+static void drain_channel_tasks(ChannelWorkerPool& pool, const std::function<void(size_t)>& task, size_t count) {
+    for (size_t ch = pool.next_item.fetch_add(1); ch < count; ch = pool.next_item.fetch_add(1)) {
+        task(ch);
+    }
+}
+
+static void channel_worker(ChannelWorkerPool* pool) {
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    while (true) {
+        pool->start_cv.wait(lock, [&] { return pool->stop || pool->generation != seen_generation; });
+        if (pool->stop) return;
+        seen_generation = pool->generation;
+        const std::function<void(size_t)>* task = pool->task;
+        const size_t count = pool->count;
+        lock.unlock();
+
+        drain_channel_tasks(*pool, *task, count);
+
+        lock.lock();
+        if (--pool->busy == 0) pool->done_cv.notify_one();
+    }
+}
+
+static void run_channel_tasks(size_t channels, const std::function<void(size_t)>& task) {
+    if (channels < ChannelConfig::PARALLEL_MIN_CHANNELS) {
+        for (size_t ch = 0; ch < channels; ch++) {
+            task(ch);
+        }
+        return;
+    }
+
+    ChannelWorkerPool& pool = g_channel_pool;
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    if (pool.threads.empty()) {
+        const unsigned workers = static_cast<unsigned>(
+            std::min<size_t>(ChannelConfig::MAX_WORKERS, channels - 1));
+        for (unsigned i = 0; i < workers; i++) {
+            pool.threads.emplace_back(channel_worker, &pool);
+        }
+        std::cout << "[Processing] Started " << workers << " channel workers for "
+                  << channels << " channels" << std::endl;
+    }
+    pool.task = &task;
+    pool.count = channels;
+    pool.next_item.store(0);
+    pool.busy = static_cast<unsigned>(pool.threads.size());
+    pool.generation++;
+    lock.unlock();
+    pool.start_cv.notify_all();
+
+    drain_channel_tasks(pool, task, channels);
+
+    lock.lock();
+    pool.done_cv.wait(lock, [&] { return pool.busy == 0; });
+    pool.task = nullptr;
+}
+
+void stop_channel_workers() {
+    ChannelWorkerPool& pool = g_channel_pool;
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stop = true;
+    }
+    pool.start_cv.notify_all();
+    for (auto& t : pool.threads) {
+        t.join();
+    }
+    pool.threads.clear();
+}
+
+// Back half of the FFT path for one channel: overlap save, DC removal, window, FFT,
+// magnitude, overlap averaging. Expects the new samples already placed in the second
+// half of fft_in. Touches only this channel's state, so channels may run concurrently.
+static void finish_channel_frame(
+    size_t ch,
+    size_t new_samples,
     size_t fft_size,
-    uint64_t current_freq,
-    fftwf_complex* fft_in_ch1,
-    fftwf_complex* fft_in_ch2,
-    fftwf_complex* fft_out_ch1,
-    fftwf_complex* fft_out_ch2,
-    uint8_t* ch1_mag,
-    uint8_t* ch2_mag,
+    float alpha,
+    bool blend,
+    fftwf_complex* fft_in,
+    fftwf_complex* fft_out,
+    uint8_t* mag,
     DCOffsetState& dc_state,
     OverlapState& overlap_state,
     const std::vector<float>& window,
-    fftwf_plan plan_ch1,
-    fftwf_plan plan_ch2
+    fftwf_plan plan
 ) {
-    IQProcessingResult result = {0, false};
-
-    // ===== OVERLAP-ADD PROCESSING (50% overlap for smoother spectrum) =====
     const size_t OVERLAP_SIZE = fft_size / 2;
-    const size_t new_samples = std::min(buffer_size / 2, OVERLAP_SIZE);
-    constexpr float scale = 1.0f / 32768.0f;
 
-    int16_t peak_sample = 0;
+    // Save current second half for next iteration
+    memcpy(overlap_state.overlap_buf.data() + ch * OVERLAP_SIZE * 2, fft_in + OVERLAP_SIZE,
+           OVERLAP_SIZE * 2 * sizeof(float));
 
-    // Copy previous second half to first half (overlap)
-    // overlap_buf stores interleaved I/Q pairs as floats, cast to fftwf_complex (float[2])
-    memcpy(fft_in_ch1, overlap_state.overlap_buf_ch1.data(), OVERLAP_SIZE * 2 * sizeof(float));
-    memcpy(fft_in_ch2, overlap_state.overlap_buf_ch2.data(), OVERLAP_SIZE * 2 * sizeof(float));
+    // Zero-pad if needed
+    if (new_samples < OVERLAP_SIZE) {
+        memset(fft_in + OVERLAP_SIZE + new_samples, 0, (OVERLAP_SIZE - new_samples) * 2 * sizeof(float));
+    }
 
-    // Deinterleave new samples into second half
-    for (size_t i = 0; i < new_samples; i++) {
-        const size_t idx = i * 4;
-        const size_t buf_idx = OVERLAP_SIZE + i;
+    // Remove DC offset from IQ samples using EWMA with single-pass computation
+    // OPTIMIZED: Combined mean calculation and DC removal in single pass
+    float dc_i = 0.0f, dc_q = 0.0f;
+    for (size_t i = 0; i < fft_size; i++) {
+        dc_i += fft_in[i][0];
+        dc_q += fft_in[i][1];
+    }
 
-        // Track peak ADC values
-        if (std::abs(iq_buffer[idx + 0]) > std::abs(peak_sample))
-            peak_sample = iq_buffer[idx + 0];
-        if (std::abs(iq_buffer[idx + 1]) > std::abs(peak_sample))
-            peak_sample = iq_buffer[idx + 1];
+    const float inv_fft_size = 1.0f / fft_size;
+    dc_state.dc_i[ch] = alpha * dc_i * inv_fft_size + (1.0f - alpha) * dc_state.dc_i[ch];
+    dc_state.dc_q[ch] = alpha * dc_q * inv_fft_size + (1.0f - alpha) * dc_state.dc_q[ch];
 
-        fft_in_ch1[buf_idx][0] = static_cast<float>(iq_buffer[idx + 0]) * scale;
-        fft_in_ch1[buf_idx][1] = static_cast<float>(iq_buffer[idx + 1]) * scale;
-        fft_in_ch2[buf_idx][0] = static_cast<float>(iq_buffer[idx + 2]) * scale;
-        fft_in_ch2[buf_idx][1] = static_cast<float>(iq_buffer[idx + 3]) * scale;
+    // Apply DC offset correction
+    const float offset_i = dc_state.dc_i[ch];
+    const float offset_q = dc_state.dc_q[ch];
+    for (size_t i = 0; i < fft_size; i++) {
+        fft_in[i][0] -= offset_i;
+        fft_in[i][1] -= offset_q;
     }
 
-    result.peak_sample = peak_sample;
+    // Window, FFT, magnitude
+    apply_window(fft_in, fft_size, window);
+    compute_fft(fft_in, fft_out, plan);
+    compute_magnitude_db(fft_out, mag, fft_size);
 
-    // Save current second half for next iteration
-    memcpy(overlap_state.overlap_buf_ch1.data(), fft_in_ch1 + OVERLAP_SIZE, OVERLAP_SIZE * 2 * sizeof(float));
-    memcpy(overlap_state.overlap_buf_ch2.data(), fft_in_ch2 + OVERLAP_SIZE, OVERLAP_SIZE * 2 * sizeof(float));
-
-    // Zero-pad if needed
-    if (new_samples < OVERLAP_SIZE) {
-        memset(fft_in_ch1 + OVERLAP_SIZE + new_samples, 0,
-               (OVERLAP_SIZE - new_samples) * 2 * sizeof(float));
-        memset(fft_in_ch2 + OVERLAP_SIZE + new_samples, 0,
-               (OVERLAP_SIZE - new_samples) * 2 * sizeof(float));
+    // Apply overlap-add averaging (50% blend with previous FFT)
+    uint8_t* prev = overlap_state.prev_magnitude.data() + ch * fft_size;
+    if (blend) {
+        for (size_t i = 0; i < fft_size; i++) {
+            mag[i] = (mag[i] + prev[i]) / 2;
+        }
     }
 
-    // Remove DC offset from IQ samples using EWMA with single-pass computation
-    // OPTIMIZED: Combined mean calculation and DC removal in single pass
+    // Store current magnitudes for next iteration
+    memcpy(prev, mag, fft_size);
+}
+
+// Shared frame-level part of the FFT path (frequency-change reset, DC convergence),
+// then every channel through finish_channel_frame
+static void finish_fft_frame(
+    size_t channels,
+    size_t new_samples,
+    size_t fft_size,
+    uint64_t current_freq,
+    fftwf_complex* const* fft_in,
+    fftwf_complex* const* fft_out,
+    uint8_t* mag,
+    DCOffsetState& dc_state,
+    OverlapState& overlap_state,
+    const std::vector<float>& window,
+    const fftwf_plan* plans,
+    IQProcessingResult& result
+) {
     if (current_freq != dc_state.last_freq) {
         dc_state.last_freq = current_freq;
         dc_state.convergence_counter = 0;
-        dc_state.dc_i_ch1 = 0.0f;
-        dc_state.dc_q_ch1 = 0.0f;
-        dc_state.dc_i_ch2 = 0.0f;
-        dc_state.dc_q_ch2 = 0.0f;
+        std::fill_n(dc_state.dc_i, ChannelConfig::MAX_CHANNELS, 0.0f);
+        std::fill_n(dc_state.dc_q, ChannelConfig::MAX_CHANNELS, 0.0f);
         overlap_state.has_prev_fft = false;  // Reset overlap-add on frequency change
         result.freq_changed = true;
     }
 
-    // Single-pass mean calculation (Welford's method - numerically stable)
-    float dc_i_ch1 = 0.0f, dc_q_ch1 = 0.0f;
-    float dc_i_ch2 = 0.0f, dc_q_ch2 = 0.0f;
-
-    for (size_t i = 0; i < fft_size; i++) {
-        dc_i_ch1 += fft_in_ch1[i][0];
-        dc_q_ch1 += fft_in_ch1[i][1];
-        dc_i_ch2 += fft_in_ch2[i][0];
-        dc_q_ch2 += fft_in_ch2[i][1];
-    }
-
-    const float inv_fft_size = 1.0f / fft_size;
-    dc_i_ch1 *= inv_fft_size;
-    dc_q_ch1 *= inv_fft_size;
-    dc_i_ch2 *= inv_fft_size;
-    dc_q_ch2 *= inv_fft_size;
-
     // Adaptive EWMA: fast convergence initially, slow tracking after
     const float alpha = (dc_state.convergence_counter < 20) ? 0.5f : 0.1f;
     dc_state.convergence_counter++;
+    const bool blend = overlap_state.has_prev_fft;
 
-    dc_state.dc_i_ch1 = alpha * dc_i_ch1 + (1.0f - alpha) * dc_state.dc_i_ch1;
-    dc_state.dc_q_ch1 = alpha * dc_q_ch1 + (1.0f - alpha) * dc_state.dc_q_ch1;
-    dc_state.dc_i_ch2 = alpha * dc_i_ch2 + (1.0f - alpha) * dc_state.dc_i_ch2;
-    dc_state.dc_q_ch2 = alpha * dc_q_ch2 + (1.0f - alpha) * dc_state.dc_q_ch2;
+    run_channel_tasks(channels, [&](size_t ch) {
+        finish_channel_frame(ch, new_samples, fft_size, alpha, blend, fft_in[ch], fft_out[ch],
+                             mag + ch * fft_size, dc_state, overlap_state, window, plans[ch]);
+    });
 
-    // Apply DC offset correction
-    for (size_t i = 0; i < fft_size; i++) {
-        fft_in_ch1[i][0] -= dc_state.dc_i_ch1;
-        fft_in_ch1[i][1] -= dc_state.dc_q_ch1;
-        fft_in_ch2[i][0] -= dc_state.dc_i_ch2;
-        fft_in_ch2[i][1] -= dc_state.dc_q_ch2;
+    overlap_state.has_prev_fft = true;
+}
+
+// Deinterleave one channel of a frame-interleaved buffer into its plane. With the
+// channel count as a template parameter the stride is a constant and the loop
+// vectorizes with shuffles; channel 0 also yields the peak ADC value.
+template <size_t Channels, bool Peak>
+static int32_t deinterleave_channel(const int16_t* __restrict iq, size_t n, size_t ch, float* __restrict out) {
+    constexpr float scale = 1.0f / 32768.0f;
+    int32_t peak_abs = 0;
+
+    // Branch-free loop (max instead of compare-and-store) so the compiler can vectorize it
+    for (size_t i = 0; i < n; i++) {
+        const int16_t* s = iq + i * Channels * 2 + ch * 2;
+        out[i * 2 + 0] = static_cast<float>(s[0]) * scale;
+        out[i * 2 + 1] = static_cast<float>(s[1]) * scale;
+        if (Peak) {
+            peak_abs = std::max(peak_abs, std::max(std::abs(static_cast<int32_t>(s[0])),
+                                                   std::abs(static_cast<int32_t>(s[1]))));
+        }
     }
+    return peak_abs;
+}
 
-    // Apply window function
-    apply_window(fft_in_ch1, fft_size, window);
-    apply_window(fft_in_ch2, fft_size, window);
+// Same for a channel count known only at run time
+template <bool Peak>
+static int32_t deinterleave_channel_any(const int16_t* __restrict iq, size_t n, size_t channels, size_t ch,
+                                        float* __restrict out) {
+    constexpr float scale = 1.0f / 32768.0f;
+    const size_t stride = channels * 2;
+    int32_t peak_abs = 0;
+    for (size_t i = 0; i < n; i++) {
+        const int16_t* s = iq + i * stride + ch * 2;
+        out[i * 2 + 0] = static_cast<float>(s[0]) * scale;
+        out[i * 2 + 1] = static_cast<float>(s[1]) * scale;
+        if (Peak) {
+            peak_abs = std::max(peak_abs, std::max(std::abs(static_cast<int32_t>(s[0])),
+                                                   std::abs(static_cast<int32_t>(s[1]))));
+        }
+    }
+    return peak_abs;
+}
 
-    // Compute FFTs
-    compute_fft(fft_in_ch1, fft_out_ch1, plan_ch1);
-    compute_fft(fft_in_ch2, fft_out_ch2, plan_ch2);
+template <size_t Channels>
+static int32_t deinterleave_fixed(const int16_t* iq, size_t n, IQFrontEnd& front_end) {
+    const int32_t peak_abs = deinterleave_channel<Channels, true>(iq, n, 0, front_end.channel(0));
+    for (size_t ch = 1; ch < Channels; ch++) {
+        deinterleave_channel<Channels, false>(iq, n, ch, front_end.channel(ch));
+    }
+    return peak_abs;
+}
 
-    // Compute magnitudes
-    compute_magnitude_db(fft_out_ch1, ch1_mag, fft_size);
-    compute_magnitude_db(fft_out_ch2, ch2_mag, fft_size);
+void deinterleave_iq(const int16_t* iq_buffer, size_t buffer_size, size_t channels, IQFrontEnd& front_end) {
+    if (front_end.channels != channels || front_end.capacity < buffer_size) {
+        front_end.channels = channels;
+        front_end.capacity = std::max(front_end.capacity, buffer_size);
+        front_end.samples.resize(channels * front_end.capacity * 2);
+    }
 
-    // Apply overlap-add averaging (50% blend with previous FFT)
-    if (overlap_state.has_prev_fft) {
-        for (size_t i = 0; i < fft_size; i++) {
-            ch1_mag[i] = (ch1_mag[i] + overlap_state.prev_magnitude_ch1[i]) / 2;
-            ch2_mag[i] = (ch2_mag[i] + overlap_state.prev_magnitude_ch2[i]) / 2;
-        }
+    int32_t peak_abs = 0;
+    switch (channels) {
+        case 1: peak_abs = deinterleave_fixed<1>(iq_buffer, buffer_size, front_end); break;
+        case 2: peak_abs = deinterleave_fixed<2>(iq_buffer, buffer_size, front_end); break;
+        case 4: peak_abs = deinterleave_fixed<4>(iq_buffer, buffer_size, front_end); break;
+        case 8: peak_abs = deinterleave_fixed<8>(iq_buffer, buffer_size, front_end); break;
+        default:
+            peak_abs = deinterleave_channel_any<true>(iq_buffer, buffer_size, channels, 0, front_end.channel(0));
+            for (size_t ch = 1; ch < channels; ch++) {
+                deinterleave_channel_any<false>(iq_buffer, buffer_size, channels, ch, front_end.channel(ch));
+            }
+            break;
     }
 
-    // Store current magnitudes for next iteration
-    memcpy(overlap_state.prev_magnitude_ch1.data(), ch1_mag, fft_size);
-    memcpy(overlap_state.prev_magnitude_ch2.data(), ch2_mag, fft_size);
-    overlap_state.has_prev_fft = true;
+    front_end.count = buffer_size;
+    front_end.peak_sample = static_cast<int16_t>(std::min(peak_abs, 32767));
+}
+
+IQProcessingResult process_frontend_to_fft(
+    const IQFrontEnd& front_end,
+    size_t fft_size,
+    uint64_t current_freq,
+    fftwf_complex* const* fft_in,
+    fftwf_complex* const* fft_out,
+    uint8_t* mag,
+    DCOffsetState& dc_state,
+    OverlapState& overlap_state,
+    const std::vector<float>& window,
+    const fftwf_plan* plans
+) {
+    IQProcessingResult result = {front_end.peak_sample, false};
+
+    // 50% overlap: previous second half, then the first new_samples of this block
+    const size_t OVERLAP_SIZE = fft_size / 2;
+    const size_t new_samples = std::min(front_end.count, OVERLAP_SIZE);
+    const size_t channels = std::min(front_end.channels, overlap_state.channels);
+
+    for (size_t ch = 0; ch < channels; ch++) {
+        memcpy(fft_in[ch], overlap_state.overlap_buf.data() + ch * OVERLAP_SIZE * 2, OVERLAP_SIZE * 2 * sizeof(float));
+        memcpy(fft_in[ch] + OVERLAP_SIZE, front_end.channel(ch), new_samples * 2 * sizeof(float));
+    }
 
+    finish_fft_frame(channels, new_samples, fft_size, current_freq, fft_in, fft_out, mag,
+                     dc_state, overlap_state, window, plans, result);
     return result;
 }
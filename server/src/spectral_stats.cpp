@@ -0,0 +1,253 @@
+#include "spectral_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+// Published traces and detections (written by analysis thread, read by web server)
+static std::vector<uint8_t> g_sk_trace[SpectralStatsConfig::NUM_CHANNELS];
+static std::vector<uint8_t> g_flatness_trace[SpectralStatsConfig::NUM_CHANNELS];
+static std::string g_spectral_stats_json = "{\"blocks\":0,\"detections\":[]}";
+static std::mutex g_spectral_stats_mutex;
+
+// log2 via exponent extraction and the atanh series of the mantissa (|error| < 2e-5)
+// Plain arithmetic on the bit pattern so the accumulation loop stays vectorizable
+static inline float fast_log2(float x) {
+    constexpr float TWO_OVER_LN2 = 2.8853901f;
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    const float exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+
+    // ln(m) = 2 * atanh((m - 1) / (m + 1)), t in [0, 1/3) for m in [1, 2)
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    return exponent + TWO_OVER_LN2 * t * (1.0f + t2 * (1.0f / 3.0f + t2 * (0.2f + t2 * (1.0f / 7.0f))));
+}
+
+static void reset_accumulators(SpectralStatsState& state) {
+    for (int ch = 0; ch < SpectralStatsConfig::NUM_CHANNELS; ch++) {
+        std::fill(state.sum_p[ch].begin(), state.sum_p[ch].end(), 0.0f);
+        std::fill(state.sum_p2[ch].begin(), state.sum_p2[ch].end(), 0.0f);
+        std::fill(state.sum_log2p[ch].begin(), state.sum_log2p[ch].end(), 0.0f);
+    }
+    state.frames = 0;
+}
+
+void init_spectral_stats(SpectralStatsState& state, size_t fft_size, uint32_t m_frames) {
+    state.fft_size = fft_size;
+    state.m_frames = std::max<uint32_t>(m_frames, 2);
+    state.last_freq = 0;
+    state.blocks_completed = 0;
+
+    for (int ch = 0; ch < SpectralStatsConfig::NUM_CHANNELS; ch++) {
+        state.sum_p[ch].assign(fft_size, 0.0f);
+        state.sum_p2[ch].assign(fft_size, 0.0f);
+        state.sum_log2p[ch].assign(fft_size, 0.0f);
+        state.kurtosis[ch].assign(fft_size, 1.0f);
+        state.flatness[ch].assign(fft_size, 0.0f);
+        state.mean_power[ch].assign(fft_size, 0.0f);
+        state.band_flatness[ch] = 0.0f;
+    }
+    state.frames = 0;
+}
+
+// Add one frame to a channel's accumulators (the only per-frame work)
+static void accumulate_channel(const fftwf_complex* fft, size_t n, float* __restrict sum_p,
+                               float* __restrict sum_p2, float* __restrict sum_log2p) {
+    constexpr float MIN_POWER = 1e-20f;
+    const float* bins = reinterpret_cast<const float*>(fft);
+
+    for (size_t k = 0; k < n; k++) {
+        const float re = bins[k * 2];
+        const float im = bins[k * 2 + 1];
+        const float p = std::max(re * re + im * im, MIN_POWER);
+        sum_p[k] += p;
+        sum_p2[k] += p * p;
+        sum_log2p[k] += fast_log2(p);
+    }
+}
+
+// Turn a full block of sums into SK, flatness and mean power
+static void finish_block(SpectralStatsState& state) {
+    const float m = static_cast<float>(state.frames);
+    const float inv_m = 1.0f / m;
+    const float sk_scale = (m + 1.0f) / (m - 1.0f);
+
+    for (int ch = 0; ch < SpectralStatsConfig::NUM_CHANNELS; ch++) {
+        const float* s1 = state.sum_p[ch].data();
+        const float* s2 = state.sum_p2[ch].data();
+        const float* sl = state.sum_log2p[ch].data();
+        float* sk = state.kurtosis[ch].data();
+        float* flat = state.flatness[ch].data();
+        float* mean = state.mean_power[ch].data();
+
+        double log_mean_sum = 0.0;
+        double mean_sum = 0.0;
+        for (size_t k = 0; k < state.fft_size; k++) {
+            mean[k] = s1[k] * inv_m;
+            sk[k] = sk_scale * (m * s2[k] / (s1[k] * s1[k]) - 1.0f);
+            flat[k] = std::exp2(sl[k] * inv_m) / mean[k];
+            log_mean_sum += fast_log2(mean[k]);
+            mean_sum += mean[k];
+        }
+
+        const double n = static_cast<double>(state.fft_size);
+        state.band_flatness[ch] = static_cast<float>(std::exp2(log_mean_sum / n) / (mean_sum / n));
+    }
+
+    state.blocks_completed++;
+}
+
+bool update_spectral_stats(SpectralStatsState& state, const fftwf_complex* fft_ch1,
+                           const fftwf_complex* fft_ch2, uint64_t center_freq) {
+    // A retune mixes two different spectra into one block - start over
+    if (center_freq != state.last_freq) {
+        state.last_freq = center_freq;
+        reset_accumulators(state);
+    }
+
+    accumulate_channel(fft_ch1, state.fft_size, state.sum_p[0].data(), state.sum_p2[0].data(),
+                       state.sum_log2p[0].data());
+    accumulate_channel(fft_ch2, state.fft_size, state.sum_p[1].data(), state.sum_p2[1].data(),
+                       state.sum_log2p[1].data());
+
+    if (++state.frames < state.m_frames) {
+        return false;
+    }
+
+    finish_block(state);
+    reset_accumulators(state);
+    return true;
+}
+
+// Standard deviation of the detection statistic (SK averaged over both channels)
+// Averaging two independent channels halves the SK variance: std = 2 / sqrt(2M)
+static float sk_detection_std(const SpectralStatsState& state) {
+    return 2.0f / std::sqrt(2.0f * state.m_frames);
+}
+
+std::vector<SignalRegion> detect_signals_sk(const SpectralStatsState& state, const SKDetectorParams& params,
+                                            size_t bin_start, size_t bin_end) {
+    std::vector<SignalRegion> regions;
+    if (state.blocks_completed == 0 || state.fft_size == 0) return regions;
+
+    bin_end = std::min(bin_end, state.fft_size - 1);
+
+    const float sk_std = sk_detection_std(state);
+    const float threshold = params.sigma * sk_std;
+    const size_t dc_bin = state.fft_size / 2;
+
+    const float* sk1 = state.kurtosis[0].data();
+    const float* sk2 = state.kurtosis[1].data();
+    const float* p1 = state.mean_power[0].data();
+    const float* p2 = state.mean_power[1].data();
+
+    auto emit = [&](size_t start, size_t end) {
+        const size_t count = end - start + 1;
+        if (count < params.min_signal_bins) return;
+        double power = 0.0;
+        for (size_t k = start; k <= end; k++) {
+            power += 0.5 * (p1[k] + p2[k]);
+        }
+        SignalRegion region;
+        region.start_bin = start;
+        region.end_bin = end;
+        region.integrated_power = static_cast<float>(10.0 * std::log10(std::max(power, 1e-20)));
+        region.avg_magnitude = static_cast<float>(10.0 * std::log10(std::max(power / count, 1e-20)));
+        region.bin_count = count;
+        regions.push_back(region);
+    };
+
+    bool in_region = false;
+    size_t region_start = 0;
+    for (size_t k = bin_start; k <= bin_end; k++) {
+        const bool dc = k + SpectralStatsConfig::DC_EXCLUSION_BINS >= dc_bin &&
+                        k <= dc_bin + SpectralStatsConfig::DC_EXCLUSION_BINS;
+        const bool flagged = !dc && std::fabs(0.5f * (sk1[k] + sk2[k]) - 1.0f) > threshold;
+
+        if (flagged && !in_region) {
+            in_region = true;
+            region_start = k;
+        } else if (!flagged && in_region) {
+            in_region = false;
+            emit(region_start, k - 1);
+        }
+    }
+    if (in_region) {
+        emit(region_start, bin_end);
+    }
+
+    return regions;
+}
+
+void publish_spectral_stats(const SpectralStatsState& state, const std::vector<SignalRegion>& regions,
+                            uint64_t center_freq, uint32_t sample_rate) {
+    const size_t n = state.fft_size;
+    const double bin_hz = static_cast<double>(sample_rate) / n;
+
+    // Quantize outside the lock
+    std::vector<uint8_t> sk_trace[SpectralStatsConfig::NUM_CHANNELS];
+    std::vector<uint8_t> flat_trace[SpectralStatsConfig::NUM_CHANNELS];
+    for (int ch = 0; ch < SpectralStatsConfig::NUM_CHANNELS; ch++) {
+        sk_trace[ch].resize(n);
+        flat_trace[ch].resize(n);
+        for (size_t k = 0; k < n; k++) {
+            sk_trace[ch][k] = static_cast<uint8_t>(std::clamp(
+                state.kurtosis[ch][k] * SpectralStatsConfig::SK_TRACE_SCALE, 0.0f, 255.0f));
+            flat_trace[ch][k] = static_cast<uint8_t>(std::clamp(
+                state.flatness[ch][k] * SpectralStatsConfig::FLATNESS_TRACE_SCALE, 0.0f, 255.0f));
+        }
+    }
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\"blocks\":" << state.blocks_completed
+         << ",\"mFrames\":" << state.m_frames
+         << ",\"skStd\":" << sk_detection_std(state)
+         << ",\"bandFlatness\":[" << state.band_flatness[0] << "," << state.band_flatness[1] << "]"
+         << ",\"detections\":[";
+    for (size_t i = 0; i < regions.size(); i++) {
+        const SignalRegion& r = regions[i];
+        const double center_bin = 0.5 * (r.start_bin + r.end_bin);
+        double sk_sum = 0.0;
+        for (size_t k = r.start_bin; k <= r.end_bin; k++) {
+            sk_sum += 0.5 * (state.kurtosis[0][k] + state.kurtosis[1][k]);
+        }
+        if (i > 0) json << ",";
+        json << std::setprecision(0)
+             << "{\"freqHz\":" << static_cast<double>(center_freq) + (center_bin - n / 2.0) * bin_hz
+             << ",\"bwHz\":" << r.bin_count * bin_hz
+             << std::setprecision(4)
+             << ",\"startBin\":" << r.start_bin
+             << ",\"endBin\":" << r.end_bin
+             << ",\"sk\":" << sk_sum / r.bin_count
+             << ",\"powerDb\":" << r.avg_magnitude << "}";
+    }
+    json << "]}";
+
+    std::lock_guard<std::mutex> lock(g_spectral_stats_mutex);
+    for (int ch = 0; ch < SpectralStatsConfig::NUM_CHANNELS; ch++) {
+        g_sk_trace[ch].swap(sk_trace[ch]);
+        g_flatness_trace[ch].swap(flat_trace[ch]);
+    }
+    g_spectral_stats_json = json.str();
+}
+
+bool get_spectral_trace(int channel, bool flatness, std::vector<uint8_t>& out) {
+    const int ch = (channel == 2) ? 1 : 0;
+    std::lock_guard<std::mutex> lock(g_spectral_stats_mutex);
+    const std::vector<uint8_t>& trace = flatness ? g_flatness_trace[ch] : g_sk_trace[ch];
+    if (trace.empty()) return false;
+    out = trace;
+    return true;
+}
+
+std::string get_spectral_stats_json() {
+    std::lock_guard<std::mutex> lock(g_spectral_stats_mutex);
+    return g_spectral_stats_json;
+}
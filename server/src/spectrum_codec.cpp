@@ -0,0 +1,328 @@
+#include "spectrum_codec.h"
+#include "compression.h"
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+static constexpr size_t BLOCK_VALUES = 32;            // Residuals per bit width
+static constexpr size_t PAIR_VALUES = 2 * BLOCK_VALUES;
+
+// RAW
+
+static bool raw_encode(const uint8_t* row, const uint8_t*, size_t size, std::vector<uint8_t>& out) {
+    out.insert(out.end(), row, row + size);
+    return true;
+}
+
+static bool raw_decode(const uint8_t* data, size_t data_size, const uint8_t*, uint8_t* row, size_t size) {
+    if (data_size < size) return false;
+    memcpy(row, data, size);
+    return true;
+}
+
+// Residual of each value against the previous row (temporal) or the previous bin (keyframe)
+static void residuals(const uint8_t* __restrict row, const uint8_t* __restrict reference,
+                      uint8_t* __restrict out, size_t size) {
+    if (reference) {
+        delta_rows(row, reference, out, size);
+    } else if (size > 0) {
+        out[0] = row[0];
+        delta_rows(row + 1, row, out + 1, size - 1);
+    }
+}
+
+// Undo residuals in place (row holds the residuals on entry)
+static void undo_residuals(const uint8_t* __restrict reference, uint8_t* __restrict row, size_t size) {
+    if (reference) {
+        for (size_t i = 0; i < size; i++) {
+            row[i] = static_cast<uint8_t>(row[i] + reference[i]);
+        }
+    } else {
+        for (size_t i = 1; i < size; i++) {
+            row[i] = static_cast<uint8_t>(row[i] + row[i - 1]);
+        }
+    }
+}
+
+// DELTA_DEFLATE
+
+static bool deflate_encode(const uint8_t* row, const uint8_t* reference, size_t size, std::vector<uint8_t>& out) {
+    // Frames are encoded on one thread per stream; the deflate stream is reset per frame
+    thread_local DeflateState deflate_state;
+    thread_local std::vector<uint8_t> delta;
+    const uint8_t* input = row;
+    if (reference) {
+        delta.resize(size);
+        delta_rows(row, reference, delta.data(), size);
+        input = delta.data();
+    }
+    return deflate_append(deflate_state, input, size, out) > 0;
+}
+
+static bool deflate_decode(const uint8_t* data, size_t data_size, const uint8_t* reference, uint8_t* row, size_t size) {
+    uLongf out_size = static_cast<uLongf>(size);
+    if (uncompress(row, &out_size, data, static_cast<uLong>(data_size)) != Z_OK || out_size != size) {
+        return false;
+    }
+    if (reference) undo_residuals(reference, row, size);
+    return true;
+}
+
+// DELTA_BITPACK
+
+static inline uint8_t zigzag(uint8_t residual) {
+    const int8_t value = static_cast<int8_t>(residual);
+    return static_cast<uint8_t>((value * 2) ^ (value >> 7));
+}
+
+static inline uint8_t unzigzag(uint8_t code) {
+    return static_cast<uint8_t>((code >> 1) ^ -(code & 1));
+}
+
+static inline uint32_t bit_width(uint32_t value) {
+    return value ? 32 - static_cast<uint32_t>(__builtin_clz(value)) : 0;
+}
+
+// Pack one block of 32 codes at `width` bits (four groups of 8 codes -> `width` bytes each)
+static inline uint8_t* pack_block(const uint8_t* codes, uint32_t width, uint8_t* out) {
+    for (size_t group = 0; group < BLOCK_VALUES; group += 8) {
+        uint64_t bits = 0;
+        for (uint32_t j = 0; j < 8; j++) {
+            bits |= static_cast<uint64_t>(codes[group + j]) << (j * width);
+        }
+        for (uint32_t b = 0; b < width; b++) {
+            *out++ = static_cast<uint8_t>(bits >> (8 * b));
+        }
+    }
+    return out;
+}
+
+static inline const uint8_t* unpack_block(const uint8_t* in, uint32_t width, uint8_t* codes) {
+    const uint64_t mask = (1u << width) - 1;
+    for (size_t group = 0; group < BLOCK_VALUES; group += 8) {
+        uint64_t bits = 0;
+        for (uint32_t b = 0; b < width; b++) {
+            bits |= static_cast<uint64_t>(*in++) << (8 * b);
+        }
+        for (uint32_t j = 0; j < 8; j++) {
+            codes[group + j] = static_cast<uint8_t>((bits >> (j * width)) & mask);
+        }
+    }
+    return in;
+}
+
+static bool bitpack_encode(const uint8_t* row, const uint8_t* reference, size_t size, std::vector<uint8_t>& out) {
+    thread_local std::vector<uint8_t> codes;
+    const size_t padded = (size + PAIR_VALUES - 1) / PAIR_VALUES * PAIR_VALUES;
+    codes.assign(padded, 0);
+    residuals(row, reference, codes.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        codes[i] = zigzag(codes[i]);
+    }
+
+    // Worst case: every block at 8 bits plus one width byte per pair
+    const size_t offset = out.size();
+    out.resize(offset + padded + padded / PAIR_VALUES);
+    uint8_t* dst = out.data() + offset;
+    for (size_t pair = 0; pair < padded; pair += PAIR_VALUES) {
+        uint32_t widths[2];
+        for (int half = 0; half < 2; half++) {
+            const uint8_t* block = codes.data() + pair + half * BLOCK_VALUES;
+            uint32_t any = 0;
+            for (size_t i = 0; i < BLOCK_VALUES; i++) any |= block[i];
+            widths[half] = bit_width(any);
+        }
+        *dst++ = static_cast<uint8_t>(widths[0] | (widths[1] << 4));
+        dst = pack_block(codes.data() + pair, widths[0], dst);
+        dst = pack_block(codes.data() + pair + BLOCK_VALUES, widths[1], dst);
+    }
+    out.resize(dst - out.data());
+    return true;
+}
+
+static bool bitpack_decode(const uint8_t* data, size_t data_size, const uint8_t* reference, uint8_t* row, size_t size) {
+    uint8_t codes[PAIR_VALUES];
+    const uint8_t* in = data;
+    const uint8_t* end = data + data_size;
+    for (size_t pair = 0; pair < size; pair += PAIR_VALUES) {
+        if (in >= end) return false;
+        const uint32_t width0 = *in & 0x0F;
+        const uint32_t width1 = *in >> 4;
+        in++;
+        if (width0 > 8 || width1 > 8 || static_cast<size_t>(end - in) < 4 * (width0 + width1)) return false;
+        in = unpack_block(in, width0, codes);
+        in = unpack_block(in, width1, codes + BLOCK_VALUES);
+
+        const size_t count = std::min(PAIR_VALUES, size - pair);
+        for (size_t i = 0; i < count; i++) {
+            row[pair + i] = unzigzag(codes[i]);
+        }
+    }
+    undo_residuals(reference, row, size);
+    return true;
+}
+
+// DELTA_RANS
+
+static constexpr uint32_t RANS_SCALE_BITS = 12;
+static constexpr uint32_t RANS_SCALE = 1u << RANS_SCALE_BITS;   // Frequencies sum to this
+static constexpr uint32_t RANS_LOW = 1u << 23;                  // State kept in [RANS_LOW, 2^31)
+
+// Zigzag residual codes of one row set (shared by the entropy coder paths)
+static void residual_codes(const uint8_t* row, const uint8_t* reference, size_t size, std::vector<uint8_t>& codes) {
+    codes.resize(size);
+    residuals(row, reference, codes.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        codes[i] = zigzag(codes[i]);
+    }
+}
+
+// Scale symbol counts to frequencies summing to RANS_SCALE (every used symbol keeps >= 1)
+static void normalize_frequencies(const uint32_t* counts, uint32_t symbols, size_t total, uint32_t* freq) {
+    uint32_t sum = 0;
+    uint32_t largest = 0;
+    for (uint32_t s = 0; s < symbols; s++) {
+        freq[s] = counts[s] ? std::max<uint32_t>(1, static_cast<uint32_t>(
+                                  static_cast<uint64_t>(counts[s]) * RANS_SCALE / total)) : 0;
+        sum += freq[s];
+        if (freq[s] > freq[largest]) largest = s;
+    }
+    // Rounding error goes to the most frequent symbol; if that is not enough, shave the others
+    int32_t excess = static_cast<int32_t>(sum) - static_cast<int32_t>(RANS_SCALE);
+    const int32_t take = std::min<int32_t>(excess, static_cast<int32_t>(freq[largest]) - 1);
+    freq[largest] -= take;
+    excess -= take;
+    for (uint32_t s = 0; excess > 0; s = (s + 1) % symbols) {
+        if (freq[s] > 1) {
+            freq[s]--;
+            excess--;
+        }
+    }
+}
+
+static bool rans_encode(const uint8_t* row, const uint8_t* reference, size_t size, std::vector<uint8_t>& out) {
+    thread_local std::vector<uint8_t> codes;
+    thread_local std::vector<uint8_t> body;
+    residual_codes(row, reference, size, codes);
+    if (size == 0) return false;
+
+    uint32_t counts[256] = {};
+    for (size_t i = 0; i < size; i++) counts[codes[i]]++;
+    uint32_t symbols = 256;
+    while (counts[symbols - 1] == 0) symbols--;
+
+    uint32_t freq[256];
+    uint32_t start[256];
+    normalize_frequencies(counts, symbols, size, freq);
+    for (uint32_t s = 0, cumulative = 0; s < symbols; s++) {
+        start[s] = cumulative;
+        cumulative += freq[s];
+    }
+
+    // Model: symbol count, then each frequency as a LEB128 varint
+    out.push_back(static_cast<uint8_t>(symbols - 1));
+    for (uint32_t s = 0; s < symbols; s++) {
+        uint32_t f = freq[s];
+        while (f >= 0x80) {
+            out.push_back(static_cast<uint8_t>(f | 0x80));
+            f >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(f));
+    }
+
+    // rANS runs backwards so the decoder reads forwards. Two interleaved states (even and odd
+    // codes) share the byte stream and overlap their divides. A state below 2^31 renormalizes
+    // to below x_max >= 2^(31 - RANS_SCALE_BITS) in at most two byte shifts, so a symbol emits
+    // at most two bytes (rare ones with frequency near 1 do), plus 8 bytes of final state.
+    static_assert(RANS_SCALE_BITS <= 16, "renormalization must emit at most two bytes per symbol");
+    body.resize(2 * size + 8);
+    uint8_t* ptr = body.data() + body.size();
+    uint32_t x[2] = {RANS_LOW, RANS_LOW};
+    for (size_t i = size; i-- > 0;) {
+        uint32_t& state = x[i & 1];
+        const uint32_t f = freq[codes[i]];
+        const uint32_t x_max = ((RANS_LOW >> RANS_SCALE_BITS) << 8) * f;
+        while (state >= x_max) {
+            *--ptr = static_cast<uint8_t>(state);
+            state >>= 8;
+        }
+        state = ((state / f) << RANS_SCALE_BITS) + (state % f) + start[codes[i]];
+    }
+    ptr -= 8;
+    for (int b = 0; b < 4; b++) {
+        ptr[b] = static_cast<uint8_t>(x[0] >> (8 * b));
+        ptr[4 + b] = static_cast<uint8_t>(x[1] >> (8 * b));
+    }
+
+    out.insert(out.end(), ptr, body.data() + body.size());
+    return true;
+}
+
+static bool rans_decode(const uint8_t* data, size_t data_size, const uint8_t* reference, uint8_t* row, size_t size) {
+    const uint8_t* in = data;
+    const uint8_t* end = data + data_size;
+    if (in >= end) return false;
+    const uint32_t symbols = static_cast<uint32_t>(*in++) + 1;
+
+    uint32_t freq[256];
+    uint32_t start[256];
+    uint32_t cumulative = 0;
+    for (uint32_t s = 0; s < symbols; s++) {
+        uint32_t f = 0;
+        for (uint32_t shift = 0;; shift += 7) {
+            if (in >= end || shift > 14) return false;
+            const uint8_t byte = *in++;
+            f |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        freq[s] = f;
+        start[s] = cumulative;
+        cumulative += f;
+    }
+    if (cumulative != RANS_SCALE || end - in < 8) return false;
+
+    uint8_t slot_symbol[RANS_SCALE];
+    for (uint32_t s = 0; s < symbols; s++) {
+        memset(slot_symbol + start[s], static_cast<int>(s), freq[s]);
+    }
+
+    uint32_t x[2] = {0, 0};
+    for (int state = 0; state < 2; state++) {
+        for (int b = 0; b < 4; b++) x[state] |= static_cast<uint32_t>(*in++) << (8 * b);
+    }
+    for (size_t i = 0; i < size; i++) {
+        uint32_t& state = x[i & 1];
+        const uint32_t slot = state & (RANS_SCALE - 1);
+        const uint8_t s = slot_symbol[slot];
+        state = freq[s] * (state >> RANS_SCALE_BITS) + slot - start[s];
+        while (state < RANS_LOW) {
+            if (in >= end) return false;
+            state = (state << 8) | *in++;
+        }
+        row[i] = unzigzag(s);
+    }
+    undo_residuals(reference, row, size);
+    return true;
+}
+
+static const SpectrumCodec CODECS[] = {
+    {StreamEncoding::RAW, "raw", false, raw_encode, raw_decode},
+    {StreamEncoding::DELTA_DEFLATE, "delta-deflate", true, deflate_encode, deflate_decode},
+    {StreamEncoding::DELTA_BITPACK, "delta-bitpack", true, bitpack_encode, bitpack_decode},
+    {StreamEncoding::DELTA_RANS, "delta-rans", true, rans_encode, rans_decode},
+};
+
+const SpectrumCodec* find_spectrum_codec(StreamEncoding encoding) {
+    for (const SpectrumCodec& codec : CODECS) {
+        if (codec.encoding == encoding) return &codec;
+    }
+    return nullptr;
+}
+
+const SpectrumCodec* find_spectrum_codec(const char* name) {
+    if (!name) return nullptr;
+    for (const SpectrumCodec& codec : CODECS) {
+        if (strcmp(codec.name, name) == 0) return &codec;
+    }
+    return nullptr;
+}
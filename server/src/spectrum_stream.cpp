@@ -0,0 +1,284 @@
+#include "spectrum_stream.h"
+#include "signal_processing.h"
+#include "compression.h"
+#include "spectrum_codec.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+// One registered view and its recently encoded frames
+struct StreamViewEntry {
+    bool in_use;
+    StreamView view;
+    uint32_t subscribers;
+    std::array<uint64_t, StreamConfig::FRAME_CACHE_ROWS> cached_sequence;
+    std::array<std::shared_ptr<const std::vector<uint8_t>>, StreamConfig::FRAME_CACHE_ROWS> cached_frame;
+    std::array<uint64_t, StreamConfig::FRAME_CACHE_ROWS> cached_key_sequence;   // Keyframe variants (delta encodings)
+    std::array<std::shared_ptr<const std::vector<uint8_t>>, StreamConfig::FRAME_CACHE_ROWS> cached_keyframe;
+    DeltaState delta;              // Decimated payload of row delta_sequence (next delta reference)
+    uint64_t delta_sequence;
+    uint64_t frames_encoded;
+    uint64_t keyframes_encoded;
+    uint64_t frames_sent;
+    uint64_t bytes_sent;
+};
+
+// View registry (web server thread and handlers)
+static std::array<StreamViewEntry, StreamConfig::MAX_VIEWS> g_stream_views{};
+static std::mutex g_stream_mutex;
+
+static bool same_view(const StreamView& a, const StreamView& b) {
+    return a.channel_mask == b.channel_mask && a.start_bin == b.start_bin && a.end_bin == b.end_bin &&
+           a.width == b.width && a.reduce == b.reduce && a.every == b.every && a.encoding == b.encoding;
+}
+
+static int channel_count(uint8_t mask) {
+    return ((mask & 1) ? 1 : 0) + ((mask & 2) ? 1 : 0);
+}
+
+StreamView default_stream_view(size_t row_width) {
+    StreamView view;
+    view.channel_mask = 3;
+    view.start_bin = 0;
+    view.end_bin = static_cast<uint32_t>(row_width - 1);
+    view.width = static_cast<uint32_t>(row_width);
+    view.reduce = DECIMATE_MAX;
+    view.every = 1;
+    view.encoding = StreamEncoding::RAW;
+    return view;
+}
+
+bool normalize_stream_view(StreamView& view, size_t row_width) {
+    if (channel_count(view.channel_mask) == 0 || (view.channel_mask & ~3) != 0) return false;
+    if (view.start_bin > view.end_bin || view.end_bin >= row_width) return false;
+    if (view.every == 0 || view.every > StreamConfig::MAX_EVERY) return false;
+    if (view.reduce != DECIMATE_MAX && view.reduce != DECIMATE_MEAN) return false;
+    if (!find_spectrum_codec(view.encoding)) return false;
+
+    // No upsampling: a narrow range is sent at its own resolution
+    const uint32_t span = view.end_bin - view.start_bin + 1;
+    view.width = std::clamp(view.width, std::min(StreamConfig::MIN_WIDTH, span), span);
+    return true;
+}
+
+int subscribe_stream_view(const StreamView& view) {
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+
+    int free_slot = -1;
+    for (size_t i = 0; i < g_stream_views.size(); i++) {
+        StreamViewEntry& entry = g_stream_views[i];
+        if (entry.in_use && same_view(entry.view, view)) {
+            entry.subscribers++;
+            return static_cast<int>(i);
+        }
+        if (!entry.in_use && free_slot < 0) free_slot = static_cast<int>(i);
+    }
+    if (free_slot < 0) return -1;
+
+    StreamViewEntry& entry = g_stream_views[free_slot];
+    entry = StreamViewEntry{};
+    entry.in_use = true;
+    entry.view = view;
+    entry.subscribers = 1;
+    entry.cached_sequence.fill(UINT64_MAX);
+    entry.cached_key_sequence.fill(UINT64_MAX);
+    entry.delta.init(static_cast<size_t>(channel_count(view.channel_mask)) * view.width);
+    return free_slot;
+}
+
+void unsubscribe_stream_view(int view_id) {
+    if (view_id < 0 || view_id >= static_cast<int>(StreamConfig::MAX_VIEWS)) return;
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+    StreamViewEntry& entry = g_stream_views[view_id];
+    if (!entry.in_use) return;
+    if (--entry.subscribers == 0) {
+        entry = StreamViewEntry{};
+    }
+}
+
+bool get_stream_view(int view_id, StreamView& view) {
+    if (view_id < 0 || view_id >= static_cast<int>(StreamConfig::MAX_VIEWS)) return false;
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+    if (!g_stream_views[view_id].in_use) return false;
+    view = g_stream_views[view_id].view;
+    return true;
+}
+
+static void put_le(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Decimate the view's channels of one waterfall row into out (channels * width bytes)
+static void decimate_view(const StreamView& view, const uint8_t* ch1_row, const uint8_t* ch2_row, uint8_t* out) {
+    if (view.channel_mask & 1) {
+        decimate_spectrum(ch1_row, view.start_bin, view.end_bin, out, view.width, view.reduce);
+        out += view.width;
+    }
+    if (view.channel_mask & 2) {
+        decimate_spectrum(ch2_row, view.start_bin, view.end_bin, out, view.width, view.reduce);
+    }
+}
+
+// Header plus encoded payload
+// Args:
+//   payload: Decimated rows (channels * width bytes)
+//   reference: Decimated previous row of the view, nullptr for a keyframe (delta codecs)
+static std::shared_ptr<const std::vector<uint8_t>> encode_frame(const StreamView& view, uint64_t sequence,
+                                                                const std::vector<uint8_t>& payload,
+                                                                const uint8_t* reference) {
+    const int channels = channel_count(view.channel_mask);
+    auto frame = std::make_shared<std::vector<uint8_t>>(StreamConfig::HEADER_BYTES);
+    uint8_t* out = frame->data();
+    put_le(out, sequence, 8);
+    put_le(out + 8, view.width, 4);
+    put_le(out + 12, channels, 2);
+    out[14] = static_cast<uint8_t>(view.encoding);
+    out[15] = 0;
+
+    const SpectrumCodec* codec = find_spectrum_codec(view.encoding);
+    if (codec->uses_reference && !reference) {
+        out[15] = StreamConfig::FLAG_KEYFRAME;
+    }
+    if (!codec->encode(payload.data(), reference, payload.size(), *frame)) {
+        // Drop the row; the subscriber resynchronizes on the next keyframe
+        return nullptr;
+    }
+    return frame;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> get_stream_frame(int view_id, uint64_t sequence,
+                                                             const uint8_t* ch1_row, const uint8_t* ch2_row,
+                                                             size_t row_width, uint64_t reference_sequence,
+                                                             const uint8_t* ref_ch1_row, const uint8_t* ref_ch2_row) {
+    if (view_id < 0 || view_id >= static_cast<int>(StreamConfig::MAX_VIEWS)) return nullptr;
+
+    // Scratch rows (web server thread)
+    thread_local std::vector<uint8_t> payload;
+    thread_local std::vector<uint8_t> reference;
+
+    StreamView view;
+    bool uses_reference = false;
+    bool keyframe = false;
+    bool have_reference = false;
+    {
+        std::lock_guard<std::mutex> lock(g_stream_mutex);
+        StreamViewEntry& entry = g_stream_views[view_id];
+        if (!entry.in_use || sequence % entry.view.every != 0 || entry.view.end_bin >= row_width) return nullptr;
+
+        const uint32_t every = entry.view.every;
+        uses_reference = find_spectrum_codec(entry.view.encoding)->uses_reference;
+        if (uses_reference) {
+            // Periodic keyframes bound how long a corrupted reference can persist
+            keyframe = (sequence / every) % StreamConfig::KEYFRAME_INTERVAL == 0 ||
+                       sequence < every || reference_sequence != sequence - every;
+        }
+
+        const size_t slot = sequence % StreamConfig::FRAME_CACHE_ROWS;
+        if (keyframe && entry.cached_key_sequence[slot] == sequence) {
+            return entry.cached_keyframe[slot];
+        }
+        if (!keyframe && entry.cached_sequence[slot] == sequence) {
+            return entry.cached_frame[slot];
+        }
+        view = entry.view;
+
+        if (!keyframe && entry.delta.initialized && entry.delta_sequence == reference_sequence) {
+            reference = entry.delta.last_frame;
+            have_reference = true;
+        }
+    }
+
+    // Encode outside the registry lock
+    payload.resize(static_cast<size_t>(channel_count(view.channel_mask)) * view.width);
+    decimate_view(view, ch1_row, ch2_row, payload.data());
+    if (uses_reference && !keyframe && !have_reference) {
+        if (ref_ch1_row && ref_ch2_row) {
+            reference.resize(payload.size());
+            decimate_view(view, ref_ch1_row, ref_ch2_row, reference.data());
+        } else {
+            keyframe = true;  // Reference row already overwritten
+        }
+    }
+    auto frame = encode_frame(view, sequence, payload, keyframe ? nullptr : reference.data());
+    if (!frame) return nullptr;
+
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+    StreamViewEntry& entry = g_stream_views[view_id];
+    if (entry.in_use && same_view(entry.view, view)) {
+        const size_t slot = sequence % StreamConfig::FRAME_CACHE_ROWS;
+        if (keyframe) {
+            entry.cached_key_sequence[slot] = sequence;
+            entry.cached_keyframe[slot] = frame;
+            entry.keyframes_encoded++;
+        }
+        if (!keyframe || (sequence / view.every) % StreamConfig::KEYFRAME_INTERVAL == 0) {
+            // Scheduled keyframes are also what in-sync subscribers get
+            entry.cached_sequence[slot] = sequence;
+            entry.cached_frame[slot] = frame;
+        }
+        entry.frames_encoded++;
+
+        if (uses_reference && (!entry.delta.initialized || sequence > entry.delta_sequence)) {
+            std::copy(payload.begin(), payload.end(), entry.delta.last_frame.begin());
+            entry.delta.initialized = true;
+            entry.delta_sequence = sequence;
+        }
+    }
+    return frame;
+}
+
+void record_stream_send(int view_id, size_t bytes) {
+    if (view_id < 0 || view_id >= static_cast<int>(StreamConfig::MAX_VIEWS)) return;
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+    StreamViewEntry& entry = g_stream_views[view_id];
+    if (!entry.in_use) return;
+    entry.frames_sent++;
+    entry.bytes_sent += bytes;
+
+    if (entry.view.encoding != StreamEncoding::RAW) {
+        const size_t raw_bytes = StreamConfig::HEADER_BYTES +
+                                 static_cast<size_t>(channel_count(entry.view.channel_mask)) * entry.view.width;
+        g_telemetry.compression_raw_bytes.fetch_add(raw_bytes);
+        g_telemetry.compression_compressed_bytes.fetch_add(bytes);
+        g_telemetry.compression_frames.fetch_add(1);
+    }
+}
+
+std::string get_stream_views_json() {
+    std::lock_guard<std::mutex> lock(g_stream_mutex);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(2);
+    json << "{\"views\":[";
+    bool first = true;
+    for (size_t i = 0; i < g_stream_views.size(); i++) {
+        const StreamViewEntry& entry = g_stream_views[i];
+        if (!entry.in_use) continue;
+        if (!first) json << ",";
+        first = false;
+        const double fanout = entry.frames_encoded > 0 ?
+                              static_cast<double>(entry.frames_sent) / entry.frames_encoded : 0.0;
+        json << "{\"id\":" << i
+             << ",\"ch\":" << static_cast<int>(entry.view.channel_mask)
+             << ",\"start\":" << entry.view.start_bin
+             << ",\"end\":" << entry.view.end_bin
+             << ",\"width\":" << entry.view.width
+             << ",\"reduce\":\"" << (entry.view.reduce == DECIMATE_MEAN ? "mean" : "max") << "\""
+             << ",\"every\":" << entry.view.every
+             << ",\"encoding\":\"" << find_spectrum_codec(entry.view.encoding)->name << "\""
+             << ",\"subscribers\":" << entry.subscribers
+             << ",\"encoded\":" << entry.frames_encoded
+             << ",\"keyframes\":" << entry.keyframes_encoded
+             << ",\"sent\":" << entry.frames_sent
+             << ",\"bytesSent\":" << entry.bytes_sent
+             << ",\"fanout\":" << fanout
+             << "}";
+    }
+    json << "]}";
+    return json.str();
+}
@@ -0,0 +1,165 @@
+#include "static_assets.h"
+#include "compression.h"
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+// Route table (filled by load_static_assets, read-only afterwards)
+static std::unordered_map<std::string, StaticAsset> g_static_assets;
+
+// MIME type from file extension
+static const char* get_mime_type(const std::string& path) {
+    const size_t dot = path.rfind('.');
+    if (dot == std::string::npos) return "application/octet-stream";
+    const std::string ext = path.substr(dot);
+
+    if (ext == ".html" || ext == ".htm") return "text/html; charset=utf-8";
+    if (ext == ".js") return "text/javascript; charset=utf-8";
+    if (ext == ".css") return "text/css; charset=utf-8";
+    if (ext == ".json") return "application/json; charset=utf-8";
+    if (ext == ".png") return "image/png";
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".gif") return "image/gif";
+    if (ext == ".svg") return "image/svg+xml";
+    if (ext == ".ico") return "image/x-icon";
+    if (ext == ".txt") return "text/plain; charset=utf-8";
+
+    return "application/octet-stream";
+}
+
+// Strong ETag from a 64-bit FNV-1a hash of the content
+static std::string make_etag(const std::vector<uint8_t>& data, const char* suffix) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint8_t byte : data) {
+        hash = (hash ^ byte) * 1099511628211ULL;
+    }
+    char etag[40];
+    snprintf(etag, sizeof(etag), "\"%016llx%s\"", static_cast<unsigned long long>(hash), suffix);
+    return etag;
+}
+
+size_t load_static_assets() {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::path root = "web_assets";
+    if (!fs::is_directory(root, ec)) {
+        root = "server/web_assets";
+        if (!fs::is_directory(root, ec)) {
+            std::cerr << "[Assets] web_assets directory not found" << std::endl;
+            return 0;
+        }
+    }
+
+    g_static_assets.clear();
+    size_t raw_bytes = 0;
+    size_t served_bytes = 0;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "[Assets] Cannot read " << it->path().string() << std::endl;
+            continue;
+        }
+        StaticAsset asset;
+        asset.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        const std::string uri = "/" + it->path().lexically_relative(root).generic_string();
+        asset.mime_type = get_mime_type(uri);
+        asset.etag = make_etag(asset.body, "");
+        if (gzip_encode(asset.body.data(), asset.body.size(), asset.gzip) == 0 ||
+            asset.gzip.size() >= asset.body.size()) {
+            asset.gzip.clear();
+        } else {
+            asset.gzip_etag = make_etag(asset.body, "-gz");
+        }
+
+        raw_bytes += asset.body.size();
+        served_bytes += asset.gzip.empty() ? asset.body.size() : asset.gzip.size();
+        g_static_assets[uri] = std::move(asset);
+    }
+
+    std::cout << "[Assets] Loaded " << g_static_assets.size() << " files from " << root.string()
+              << " (" << raw_bytes / 1024 << " KB, " << served_bytes / 1024 << " KB gzipped)" << std::endl;
+    return g_static_assets.size();
+}
+
+const StaticAsset* find_static_asset(const char* uri, size_t uri_len) {
+    std::string path(uri, uri_len);
+    if (path == "/") path = "/index.html";
+    auto it = g_static_assets.find(path);
+    return (it != g_static_assets.end()) ? &it->second : nullptr;
+}
+
+static void trim(std::string_view& value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+}
+
+static bool equals_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool accepts_gzip(const char* accept_encoding, size_t len) {
+    std::string_view list(accept_encoding, len);
+    int gzip = -1;       // -1 = not listed, otherwise 1 if acceptable
+    int wildcard = -1;
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        list = (comma == std::string_view::npos) ? std::string_view() : list.substr(comma + 1);
+
+        // coding *( ";" param ), of which only q matters; q=0 (0.0, 0.000) means "not acceptable"
+        const size_t semicolon = item.find(';');
+        std::string_view coding = item.substr(0, semicolon);
+        trim(coding);
+        bool acceptable = true;
+        std::string_view params = (semicolon == std::string_view::npos) ? std::string_view()
+                                                                         : item.substr(semicolon + 1);
+        while (!params.empty()) {
+            const size_t next = params.find(';');
+            std::string_view param = params.substr(0, next);
+            params = (next == std::string_view::npos) ? std::string_view() : params.substr(next + 1);
+            trim(param);
+            if (param.size() < 2 || (param[0] != 'q' && param[0] != 'Q') || param[1] != '=') continue;
+            std::string_view q = param.substr(2);
+            trim(q);
+            acceptable = q.find_first_not_of("0.") != std::string_view::npos;
+        }
+
+        if (equals_ignore_case(coding, "gzip") || equals_ignore_case(coding, "x-gzip")) {
+            gzip = acceptable ? 1 : 0;
+        } else if (coding == "*") {
+            wildcard = acceptable ? 1 : 0;
+        }
+    }
+    // An explicit gzip entry wins over "*"
+    return (gzip >= 0) ? gzip == 1 : wildcard == 1;
+}
+
+bool etag_matches(const char* if_none_match, size_t len, const std::string& etag) {
+    std::string_view list(if_none_match, len);
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        std::string_view tag = list.substr(0, comma);
+        list = (comma == std::string_view::npos) ? std::string_view() : list.substr(comma + 1);
+
+        trim(tag);
+        if (tag == "*") return true;
+        if (tag.substr(0, 2) == "W/") tag.remove_prefix(2);
+        if (tag == etag) return true;
+    }
+    return false;
+}
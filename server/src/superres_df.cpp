@@ -0,0 +1,420 @@
+#include "superres_df.h"
+#include "complex_matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+static_assert(ArrayConfig::NUM_ELEMENTS >= 2 && ArrayConfig::NUM_ELEMENTS <= ArrayConfig::MAX_ELEMENTS,
+              "ArrayConfig needs 2..MAX_ELEMENTS elements");
+static_assert(ArrayConfig::MAX_ELEMENTS <= ComplexMatrixConfig::MAX_DIM,
+              "Array larger than the small-matrix kernels support");
+
+// Engine settings (written by web server, snapshotted by analysis thread on change)
+static SuperResSettings g_superres_settings = {
+    false, SuperResMethod::MVDR, 0, 0, 0, SuperResConfig::DEFAULT_INTEGRATION_FRAMES};
+static uint64_t g_superres_settings_version = 1;
+static std::mutex g_superres_settings_mutex;
+static std::atomic<bool> g_superres_enabled{false};
+
+// Latest published spectrum (written by analysis thread, read by web server)
+static std::string g_superres_json = "{\"enabled\":false}";
+static std::mutex g_superres_json_mutex;
+
+static const char* method_name(SuperResMethod method) {
+    return method == SuperResMethod::MUSIC ? "music" : "mvdr";
+}
+
+void init_superres_df(SuperResState& state, size_t fft_size) {
+    const size_t m = ArrayConfig::NUM_ELEMENTS;
+    state.fft_size = fft_size;
+    state.elements = m;
+    state.settings = SuperResSettings{};
+    state.settings_version = 0;
+    state.center_freq = 0;
+    state.frames = 0;
+    state.frame_counter = 0;
+    state.start_bin = 0;
+    state.end_bin = 0;
+    state.steer_freq_hz = 0.0;
+    state.sources_used = 0;
+    state.bins_used = 0;
+
+    state.pair_i.clear();
+    state.pair_j.clear();
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = i + 1; j < m; j++) {
+            state.pair_i.push_back(static_cast<uint8_t>(i));
+            state.pair_j.push_back(static_cast<uint8_t>(j));
+        }
+    }
+    state.pairs = state.pair_i.size();
+    state.steer_cos.assign(state.pairs * SuperResConfig::AZIMUTH_STEPS, 0.0f);
+    state.steer_sin.assign(state.pairs * SuperResConfig::AZIMUTH_STEPS, 0.0f);
+    state.spectrum.assign(SuperResConfig::AZIMUTH_STEPS, 0.0f);
+    state.quad.assign(SuperResConfig::AZIMUTH_STEPS, 0.0f);
+    std::fill_n(state.eigenvalues, ArrayConfig::MAX_ELEMENTS, 0.0f);
+    state.peaks.clear();
+
+    // Collinear layouts (always the case for two elements) cannot tell a bearing from
+    // its mirror image about the array axis
+    const float dx = ArrayConfig::ELEMENT_X_M[1] - ArrayConfig::ELEMENT_X_M[0];
+    const float dy = ArrayConfig::ELEMENT_Y_M[1] - ArrayConfig::ELEMENT_Y_M[0];
+    state.ambiguous = true;
+    for (size_t i = 2; i < m; i++) {
+        const float ex = ArrayConfig::ELEMENT_X_M[i] - ArrayConfig::ELEMENT_X_M[0];
+        const float ey = ArrayConfig::ELEMENT_Y_M[i] - ArrayConfig::ELEMENT_Y_M[0];
+        if (std::fabs(dx * ey - dy * ex) > 1e-4f) state.ambiguous = false;
+    }
+}
+
+bool superres_df_enabled() {
+    return g_superres_enabled.load(std::memory_order_relaxed);
+}
+
+// Adopt new settings: resolve the band and restart integration
+static void apply_settings(SuperResState& state, const SuperResSettings& settings) {
+    state.settings = settings;
+    const bool full = settings.start_bin == 0 && settings.end_bin == 0;
+    state.start_bin = full ? 0 : std::min<size_t>(settings.start_bin, state.fft_size - 1);
+    state.end_bin = full ? state.fft_size - 1 : std::min<size_t>(settings.end_bin, state.fft_size - 1);
+
+    const size_t bins = state.end_bin - state.start_bin + 1;
+    state.power.assign(state.elements * bins, 0.0f);
+    state.cross_re.assign(state.pairs * bins, 0.0f);
+    state.cross_im.assign(state.pairs * bins, 0.0f);
+    state.bin_used.assign(bins, 0);
+    state.frames = 0;
+    state.steer_freq_hz = 0.0;
+}
+
+// EWMA of |X|^2 over the band
+static void accumulate_power(const float* __restrict x, float* __restrict power, size_t bins, float alpha) {
+    for (size_t b = 0; b < bins; b++) {
+        const float p = x[b * 2] * x[b * 2] + x[b * 2 + 1] * x[b * 2 + 1];
+        power[b] += alpha * (p - power[b]);
+    }
+}
+
+// EWMA of X_i conj(X_j) over the band. The calibration table corrects RX2 (element 1)
+// relative to RX1 as X_1 * w, so R_1j picks up w and R_i1 picks up conj(w).
+// Rotation: 0 = none, 1 = multiply by w, -1 = multiply by conj(w)
+template <int Rotation>
+static void accumulate_cross(const float* __restrict xi, const float* __restrict xj, const float* __restrict rot,
+                             float* __restrict acc_re, float* __restrict acc_im, size_t bins, float alpha) {
+    for (size_t b = 0; b < bins; b++) {
+        const float ar = xi[b * 2], ai = xi[b * 2 + 1];
+        const float br = xj[b * 2], bi = xj[b * 2 + 1];
+        float cr = ar * br + ai * bi;
+        float ci = ai * br - ar * bi;
+        if (Rotation != 0) {
+            const float wr = rot[b * 2];
+            const float wi = (Rotation > 0) ? rot[b * 2 + 1] : -rot[b * 2 + 1];
+            const float tr = cr * wr - ci * wi;
+            ci = cr * wi + ci * wr;
+            cr = tr;
+        }
+        acc_re[b] += alpha * (cr - acc_re[b]);
+        acc_im[b] += alpha * (ci - acc_im[b]);
+    }
+}
+
+// Pair phase differences k * ((x_j - x_i) sin(theta) + (y_j - y_i) cos(theta)) on the scan grid
+static void update_steering(SuperResState& state, double freq_hz) {
+    constexpr size_t G = SuperResConfig::AZIMUTH_STEPS;
+    const double k = 2.0 * M_PI * freq_hz / ArrayConfig::SPEED_OF_LIGHT;
+    for (size_t p = 0; p < state.pairs; p++) {
+        const size_t i = state.pair_i[p];
+        const size_t j = state.pair_j[p];
+        const double dx = ArrayConfig::ELEMENT_X_M[j] - ArrayConfig::ELEMENT_X_M[i];
+        const double dy = ArrayConfig::ELEMENT_Y_M[j] - ArrayConfig::ELEMENT_Y_M[i];
+        for (size_t g = 0; g < G; g++) {
+            const double theta = 2.0 * M_PI * g / G;
+            const double phase = k * (dx * std::sin(theta) + dy * std::cos(theta));
+            state.steer_cos[p * G + g] = static_cast<float>(std::cos(phase));
+            state.steer_sin[p * G + g] = static_cast<float>(std::sin(phase));
+        }
+    }
+    state.steer_freq_hz = freq_hz;
+}
+
+// quad[g] = a(theta_g)^H Q a(theta_g) for Hermitian Q:
+// sum_i Q_ii + 2 sum_{i<j} Re(Q_ij exp(j(phi_j - phi_i)))
+static void scan_quadratic_form(const SuperResState& state, const CMatrix& q, float* __restrict quad) {
+    constexpr size_t G = SuperResConfig::AZIMUTH_STEPS;
+    const float trace = cmat_trace(q);
+    for (size_t g = 0; g < G; g++) {
+        quad[g] = trace;
+    }
+    for (size_t p = 0; p < state.pairs; p++) {
+        const float qr = 2.0f * q.re[state.pair_i[p]][state.pair_j[p]];
+        const float qi = 2.0f * q.im[state.pair_i[p]][state.pair_j[p]];
+        const float* __restrict c = state.steer_cos.data() + p * G;
+        const float* __restrict s = state.steer_sin.data() + p * G;
+        for (size_t g = 0; g < G; g++) {
+            quad[g] += qr * c[g] - qi * s[g];
+        }
+    }
+}
+
+// Band covariance from the integrated per-bin planes, normalized to unit mean element power
+static bool band_covariance(SuperResState& state, CMatrix& r) {
+    const size_t bins = state.end_bin - state.start_bin + 1;
+    state.bins_used = 0;
+    for (size_t b = 0; b < bins; b++) {
+        state.bins_used += state.bin_used[b];
+    }
+    const bool all_bins = state.bins_used == 0;
+    if (all_bins) state.bins_used = bins;
+
+    cmat_zero(r, state.elements);
+    for (size_t i = 0; i < state.elements; i++) {
+        const float* power = state.power.data() + i * bins;
+        double sum = 0.0;
+        for (size_t b = 0; b < bins; b++) {
+            if (all_bins || state.bin_used[b]) sum += power[b];
+        }
+        r.re[i][i] = static_cast<float>(sum);
+    }
+    for (size_t p = 0; p < state.pairs; p++) {
+        const float* re = state.cross_re.data() + p * bins;
+        const float* im = state.cross_im.data() + p * bins;
+        double sum_re = 0.0, sum_im = 0.0;
+        for (size_t b = 0; b < bins; b++) {
+            if (all_bins || state.bin_used[b]) {
+                sum_re += re[b];
+                sum_im += im[b];
+            }
+        }
+        const size_t i = state.pair_i[p];
+        const size_t j = state.pair_j[p];
+        r.re[i][j] = static_cast<float>(sum_re);
+        r.im[i][j] = static_cast<float>(sum_im);
+        r.re[j][i] = static_cast<float>(sum_re);
+        r.im[j][i] = static_cast<float>(-sum_im);
+    }
+
+    const float mean_power = cmat_trace(r) / state.elements;
+    if (!(mean_power > 0.0f)) return false;
+    const float scale = 1.0f / mean_power;
+    for (size_t i = 0; i < state.elements; i++) {
+        for (size_t j = 0; j < state.elements; j++) {
+            r.re[i][j] *= scale;
+            r.im[i][j] *= scale;
+        }
+    }
+    return true;
+}
+
+static void find_peaks(SuperResState& state) {
+    constexpr size_t G = SuperResConfig::AZIMUTH_STEPS;
+    const float* s = state.spectrum.data();
+    state.peaks.clear();
+    for (size_t g = 0; g < G; g++) {
+        const float prev = s[(g + G - 1) % G];
+        const float next = s[(g + 1) % G];
+        if (s[g] >= prev && s[g] > next && s[g] >= SuperResConfig::PEAK_FLOOR_DB) {
+            state.peaks.push_back({360.0f * g / G, s[g]});
+        }
+    }
+    std::sort(state.peaks.begin(), state.peaks.end(),
+              [](const SuperResPeak& a, const SuperResPeak& b) { return a.level_db > b.level_db; });
+    if (state.peaks.size() > SuperResConfig::MAX_PEAKS) state.peaks.resize(SuperResConfig::MAX_PEAKS);
+}
+
+// Invert or decompose the band covariance and scan the pseudo-spectrum
+static bool compute_spectrum(SuperResState& state, uint32_t sample_rate) {
+    constexpr size_t G = SuperResConfig::AZIMUTH_STEPS;
+    const size_t m = state.elements;
+
+    CMatrix r;
+    if (!band_covariance(state, r)) return false;
+
+    // Narrowband steering at the band center
+    const double bin_hz = static_cast<double>(sample_rate) / state.fft_size;
+    const double band_center = 0.5 * (state.start_bin + state.end_bin);
+    const double freq_hz = static_cast<double>(state.center_freq) + (band_center - state.fft_size / 2.0) * bin_hz;
+    if (std::fabs(freq_hz - state.steer_freq_hz) > 1.0) {
+        update_steering(state, freq_hz);
+    }
+
+    CMatrix vectors;
+    cmat_hermitian_eigen(r, state.eigenvalues, vectors);
+
+    CMatrix q;
+    if (state.settings.method == SuperResMethod::MVDR) {
+        // P(theta) = 1 / (a^H (R + delta I)^-1 a)
+        cmat_add_diagonal(r, SuperResConfig::DIAGONAL_LOADING);
+        if (!cmat_hermitian_inverse(r, q)) return false;
+        state.sources_used = 0;
+    } else {
+        // P(theta) = 1 / (a^H E_n E_n^H a), E_n = eigenvectors of the M - D smallest eigenvalues
+        size_t sources = state.settings.sources;
+        if (sources == 0) {
+            const float threshold = SuperResConfig::SOURCE_EIGEN_RATIO * std::max(state.eigenvalues[0], 1e-12f);
+            for (size_t i = 1; i < m; i++) {
+                if (state.eigenvalues[i] > threshold) sources++;
+            }
+        }
+        sources = std::clamp<size_t>(sources, 1, m - 1);
+        cmat_column_projector(vectors, 0, m - sources, q);
+        state.sources_used = sources;
+    }
+
+    float* quad = state.quad.data();
+    scan_quadratic_form(state, q, quad);
+
+    // 1 / quad in dB relative to the spectrum maximum (= smallest quad)
+    float min_quad = quad[0];
+    for (size_t g = 1; g < G; g++) {
+        min_quad = std::min(min_quad, quad[g]);
+    }
+    min_quad = std::max(min_quad, 1e-12f);
+    for (size_t g = 0; g < G; g++) {
+        state.spectrum[g] = -10.0f * std::log10(std::max(quad[g], 1e-12f) / min_quad);
+    }
+    find_peaks(state);
+    return true;
+}
+
+static void publish_superres(const SuperResState& state, bool valid, uint32_t sample_rate) {
+    const double bin_hz = static_cast<double>(sample_rate) / state.fft_size;
+    const double band_center = 0.5 * (state.start_bin + state.end_bin);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(0)
+         << "{\"enabled\":true"
+         << ",\"method\":\"" << method_name(state.settings.method) << "\""
+         << ",\"frame\":" << state.frame_counter
+         << ",\"freqHz\":" << static_cast<double>(state.center_freq) + (band_center - state.fft_size / 2.0) * bin_hz
+         << ",\"startBin\":" << state.start_bin
+         << ",\"endBin\":" << state.end_bin
+         << ",\"binsUsed\":" << state.bins_used
+         << ",\"frames\":" << state.frames
+         << ",\"elements\":" << state.elements
+         << ",\"sources\":" << state.sources_used
+         << ",\"ambiguous\":" << (state.ambiguous ? "true" : "false")
+         << ",\"valid\":" << (valid ? "true" : "false");
+
+    json << std::setprecision(4) << ",\"eigenvalues\":[";
+    for (size_t i = 0; i < state.elements; i++) {
+        if (i) json << ",";
+        json << (valid ? state.eigenvalues[i] : 0.0f);
+    }
+    json << std::setprecision(1) << "],\"peaks\":[";
+    if (valid) {
+        for (size_t i = 0; i < state.peaks.size(); i++) {
+            if (i) json << ",";
+            json << "{\"azimuth\":" << state.peaks[i].azimuth << ",\"level\":" << state.peaks[i].level_db << "}";
+        }
+    }
+    json << "],\"spectrum\":[";
+    if (valid) {
+        for (size_t g = 0; g < SuperResConfig::AZIMUTH_STEPS; g++) {
+            if (g) json << ",";
+            json << state.spectrum[g];
+        }
+    }
+    json << "]}";
+
+    std::lock_guard<std::mutex> lock(g_superres_json_mutex);
+    g_superres_json = json.str();
+}
+
+void update_superres_df(SuperResState& state, const fftwf_complex* const* channels,
+                        const std::vector<SignalRegion>& regions, uint64_t center_freq,
+                        uint32_t sample_rate, const float* cal_phasor) {
+    {
+        std::lock_guard<std::mutex> lock(g_superres_settings_mutex);
+        if (state.settings_version != g_superres_settings_version) {
+            state.settings_version = g_superres_settings_version;
+            apply_settings(state, g_superres_settings);
+        }
+    }
+    if (center_freq != state.center_freq) {
+        state.center_freq = center_freq;
+        state.frames = 0;
+    }
+
+    const size_t start = state.start_bin;
+    const size_t bins = state.end_bin - start + 1;
+
+    // EWMA over K frames (running mean until K frames are in)
+    const uint32_t k = std::max<uint32_t>(state.settings.integration_frames, 1);
+    state.frames = std::min(state.frames + 1, k);
+    const float alpha = 1.0f / state.frames;
+
+    for (size_t i = 0; i < state.elements; i++) {
+        const float* x = reinterpret_cast<const float*>(channels[i] + start);
+        accumulate_power(x, state.power.data() + i * bins, bins, alpha);
+    }
+    const float* rot = cal_phasor ? cal_phasor + start * 2 : nullptr;
+    for (size_t p = 0; p < state.pairs; p++) {
+        const size_t i = state.pair_i[p];
+        const size_t j = state.pair_j[p];
+        const float* xi = reinterpret_cast<const float*>(channels[i] + start);
+        const float* xj = reinterpret_cast<const float*>(channels[j] + start);
+        float* re = state.cross_re.data() + p * bins;
+        float* im = state.cross_im.data() + p * bins;
+        if (rot && i == 1) {
+            accumulate_cross<1>(xi, xj, rot, re, im, bins, alpha);
+        } else if (rot && j == 1) {
+            accumulate_cross<-1>(xi, xj, rot, re, im, bins, alpha);
+        } else {
+            accumulate_cross<0>(xi, xj, nullptr, re, im, bins, alpha);
+        }
+    }
+
+    // Bins of this frame's detections inside the band
+    std::fill(state.bin_used.begin(), state.bin_used.end(), 0);
+    for (const auto& region : regions) {
+        const size_t lo = std::max(region.start_bin, start);
+        const size_t hi = std::min(region.end_bin, state.end_bin);
+        if (lo > hi) continue;
+        for (size_t b = lo; b <= hi; b++) {
+            state.bin_used[b - start] = 1;
+        }
+    }
+
+    state.frame_counter++;
+    if (state.frame_counter % SuperResConfig::PUBLISH_INTERVAL_FRAMES == 0) {
+        const bool valid = compute_spectrum(state, sample_rate);
+        publish_superres(state, valid, sample_rate);
+    }
+}
+
+bool set_superres_settings(const SuperResSettings& settings) {
+    if (settings.end_bin < settings.start_bin) return false;
+
+    SuperResSettings s = settings;
+    s.integration_frames = std::clamp<uint32_t>(s.integration_frames, 1, SuperResConfig::MAX_INTEGRATION_FRAMES);
+    s.sources = std::min<uint32_t>(s.sources, ArrayConfig::NUM_ELEMENTS - 1);
+    {
+        std::lock_guard<std::mutex> lock(g_superres_settings_mutex);
+        g_superres_settings = s;
+        g_superres_settings_version++;
+    }
+    g_superres_enabled.store(s.enabled, std::memory_order_relaxed);
+
+    if (!s.enabled) {
+        std::lock_guard<std::mutex> lock(g_superres_json_mutex);
+        g_superres_json = "{\"enabled\":false}";
+    }
+
+    std::cout << "[SuperRes] " << (s.enabled ? "Enabled" : "Disabled") << " (" << method_name(s.method)
+              << ", bins " << s.start_bin << "-" << s.end_bin << ", K=" << s.integration_frames << ")" << std::endl;
+    return true;
+}
+
+SuperResSettings get_superres_settings() {
+    std::lock_guard<std::mutex> lock(g_superres_settings_mutex);
+    return g_superres_settings;
+}
+
+std::string get_superres_json() {
+    std::lock_guard<std::mutex> lock(g_superres_json_mutex);
+    return g_superres_json;
+}
@@ -13,12 +13,18 @@ void init_telemetry() {
     g_telemetry.total_fft_time_us.store(0);
     g_telemetry.total_cfar_time_us.store(0);
     g_telemetry.total_df_time_us.store(0);
+    g_telemetry.total_pulse_time_us.store(0);
+    g_telemetry.total_stft_time_us.store(0);
     g_telemetry.total_processing_time_us.store(0);
     g_telemetry.usb_transfer_count.store(0);
     g_telemetry.usb_errors.store(0);
     g_telemetry.usb_recoveries.store(0);
     g_telemetry.signals_detected.store(0);
     g_telemetry.df_computations.store(0);
+    g_telemetry.pulses_detected.store(0);
+    g_telemetry.stft_frames.store(0);
+    g_telemetry.bearing_tracks_evicted.store(0);
+    g_telemetry.bearing_regions_dropped.store(0);
     g_telemetry.buffer_allocations.store(0);
     g_telemetry.buffer_reallocations.store(0);
     g_telemetry.http_requests.store(0);
@@ -40,12 +46,18 @@ std::string get_telemetry_json() {
     uint64_t fft_time = g_telemetry.total_fft_time_us.load();
     uint64_t cfar_time = g_telemetry.total_cfar_time_us.load();
     uint64_t df_time = g_telemetry.total_df_time_us.load();
+    uint64_t pulse_time = g_telemetry.total_pulse_time_us.load();
+    uint64_t stft_time = g_telemetry.total_stft_time_us.load();
     uint64_t proc_time = g_telemetry.total_processing_time_us.load();
     uint64_t usb_xfers = g_telemetry.usb_transfer_count.load();
     uint64_t usb_errs = g_telemetry.usb_errors.load();
     uint64_t usb_recov = g_telemetry.usb_recoveries.load();
     uint64_t signals = g_telemetry.signals_detected.load();
     uint64_t df_count = g_telemetry.df_computations.load();
+    uint64_t pulses = g_telemetry.pulses_detected.load();
+    uint64_t stft_frames = g_telemetry.stft_frames.load();
+    uint64_t tracks_evicted = g_telemetry.bearing_tracks_evicted.load();
+    uint64_t regions_dropped = g_telemetry.bearing_regions_dropped.load();
     uint64_t buf_alloc = g_telemetry.buffer_allocations.load();
     uint64_t buf_realloc = g_telemetry.buffer_reallocations.load();
     uint64_t http_reqs = g_telemetry.http_requests.load();
@@ -58,6 +70,7 @@ std::string get_telemetry_json() {
     double avg_fft_us = (frames > 0) ? static_cast<double>(fft_time) / frames : 0.0;
     double avg_cfar_us = (frames > 0) ? static_cast<double>(cfar_time) / frames : 0.0;
     double avg_df_us = (df_count > 0) ? static_cast<double>(df_time) / df_count : 0.0;
+    double avg_pulse_us = (usb_xfers > 0) ? static_cast<double>(pulse_time) / usb_xfers : 0.0;
     double avg_proc_us = (frames > 0) ? static_cast<double>(proc_time) / frames : 0.0;
     double drop_rate = (frames > 0) ? 100.0 * dropped / frames : 0.0;
     double usb_error_rate = (usb_xfers > 0) ? 100.0 * usb_errs / usb_xfers : 0.0;
@@ -82,10 +95,13 @@ std::string get_telemetry_json() {
     json << "    \"avg_fft\": " << avg_fft_us << ",\n";
     json << "    \"avg_cfar\": " << avg_cfar_us << ",\n";
     json << "    \"avg_df\": " << avg_df_us << ",\n";
+    json << "    \"avg_pulse\": " << avg_pulse_us << ",\n";
     json << "    \"avg_total\": " << avg_proc_us << ",\n";
     json << "    \"total_fft\": " << fft_time << ",\n";
     json << "    \"total_cfar\": " << cfar_time << ",\n";
     json << "    \"total_df\": " << df_time << ",\n";
+    json << "    \"total_pulse\": " << pulse_time << ",\n";
+    json << "    \"total_stft\": " << stft_time << ",\n";
     json << "    \"total_processing\": " << proc_time << "\n";
     json << "  },\n";
     json << "  \"usb\": {\n";
@@ -96,7 +112,11 @@ std::string get_telemetry_json() {
     json << "  },\n";
     json << "  \"signal_processing\": {\n";
     json << "    \"signals_detected\": " << signals << ",\n";
-    json << "    \"df_computations\": " << df_count << "\n";
+    json << "    \"df_computations\": " << df_count << ",\n";
+    json << "    \"pulses_detected\": " << pulses << ",\n";
+    json << "    \"stft_frames\": " << stft_frames << ",\n";
+    json << "    \"bearing_tracks_evicted\": " << tracks_evicted << ",\n";
+    json << "    \"bearing_regions_dropped\": " << regions_dropped << "\n";
     json << "  },\n";
     json << "  \"memory\": {\n";
     json << "    \"buffer_allocations\": " << buf_alloc << ",\n";
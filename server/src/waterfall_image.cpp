@@ -0,0 +1,307 @@
+#include "waterfall_image.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// PNG image writer (single-header library)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+// One tile row of a channel: TILE_ROWS rows of the full width, colormapped
+struct TileBlock {
+    uint64_t tile_y;               // UINT64_MAX = unused slot
+    uint32_t rows;                 // Rows rendered so far
+    uint64_t last_sequence;
+    std::vector<uint8_t> rgb;      // TILE_ROWS x WATERFALL_WIDTH x 3
+    std::array<uint32_t, WaterfallTileConfig::TILES_X> encoded_rows;   // Rows in the cached PNG of each tile
+    std::array<std::shared_ptr<const std::vector<uint8_t>>, WaterfallTileConfig::TILES_X> encoded;
+};
+
+// Tile state (web server thread and handlers)
+static std::array<std::array<TileBlock, WaterfallTileConfig::BLOCKS>, 2> g_tile_blocks;
+static uint64_t g_rendered_sequence = 0;   // Next row to colormap
+static bool g_tiles_initialized = false;
+static std::mutex g_tiles_mutex;
+
+RGB viridis_colormap(float value) {
+    // Clamp input to valid range
+    value = std::max(0.0f, std::min(1.0f, value));
+
+    RGB color;
+    if (value < 0.25f) {
+        // Dark purple to blue
+        float t = value / 0.25f;
+        color.r = static_cast<uint8_t>(68 + t * (59 - 68));
+        color.g = static_cast<uint8_t>(1 + t * (82 - 1));
+        color.b = static_cast<uint8_t>(84 + t * (139 - 84));
+    } else if (value < 0.5f) {
+        // Blue to teal/cyan
+        float t = (value - 0.25f) / 0.25f;
+        color.r = static_cast<uint8_t>(59 + t * (33 - 59));
+        color.g = static_cast<uint8_t>(82 + t * (145 - 82));
+        color.b = static_cast<uint8_t>(139 + t * (140 - 139));
+    } else if (value < 0.75f) {
+        // Cyan to green
+        float t = (value - 0.5f) / 0.25f;
+        color.r = static_cast<uint8_t>(33 + t * (94 - 33));
+        color.g = static_cast<uint8_t>(145 + t * (201 - 145));
+        color.b = static_cast<uint8_t>(140 + t * (98 - 140));
+    } else {
+        // Green to bright yellow
+        float t = (value - 0.75f) / 0.25f;
+        color.r = static_cast<uint8_t>(94 + t * (253 - 94));
+        color.g = static_cast<uint8_t>(201 + t * (231 - 201));
+        color.b = static_cast<uint8_t>(98 + t * (37 - 98));
+    }
+
+    return color;
+}
+
+// 256-entry table of a colormap function
+template <typename ColorFn>
+static std::array<uint8_t, 256 * 3> build_lut(ColorFn color_of) {
+    std::array<uint8_t, 256 * 3> table{};
+    for (int i = 0; i < 256; i++) {
+        const RGB color = color_of(i);
+        table[i * 3 + 0] = color.r;
+        table[i * 3 + 1] = color.g;
+        table[i * 3 + 2] = color.b;
+    }
+    return table;
+}
+
+bool parse_colormap(const char* name, Colormap& colormap) {
+    for (Colormap candidate : {Colormap::VIRIDIS, Colormap::GRAY, Colormap::HOT}) {
+        if (strcmp(name, colormap_name(candidate)) == 0) {
+            colormap = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* colormap_name(Colormap colormap) {
+    switch (colormap) {
+        case Colormap::GRAY: return "gray";
+        case Colormap::HOT:  return "hot";
+        default:             return "viridis";
+    }
+}
+
+const uint8_t* colormap_lut(Colormap colormap) {
+    static const std::array<uint8_t, 256 * 3> viridis = build_lut([](int i) {
+        return viridis_colormap(i / 255.0f);
+    });
+    static const std::array<uint8_t, 256 * 3> gray = build_lut([](int i) {
+        const uint8_t v = static_cast<uint8_t>(i);
+        return RGB{v, v, v};
+    });
+    static const std::array<uint8_t, 256 * 3> hot = build_lut([](int i) {
+        // Red ramps over the first third, then green, then blue
+        return RGB{static_cast<uint8_t>(std::min(255, i * 3)),
+                   static_cast<uint8_t>(std::clamp(i * 3 - 255, 0, 255)),
+                   static_cast<uint8_t>(std::clamp(i * 3 - 510, 0, 255))};
+    });
+
+    switch (colormap) {
+        case Colormap::GRAY: return gray.data();
+        case Colormap::HOT:  return hot.data();
+        default:             return viridis.data();
+    }
+}
+
+void colormap_row(const uint8_t* __restrict magnitude, const uint8_t* __restrict lut,
+                  uint8_t* __restrict rgb, size_t width) {
+    for (size_t i = 0; i < width; i++) {
+        const uint8_t* color = lut + magnitude[i] * 3;
+        rgb[i * 3 + 0] = color[0];
+        rgb[i * 3 + 1] = color[1];
+        rgb[i * 3 + 2] = color[2];
+    }
+}
+
+// Tile row holding `sequence`, started (and the previous occupant of its slot dropped) if needed
+static TileBlock& block_for_row(int channel, uint64_t sequence) {
+    const uint64_t tile_y = sequence / WaterfallTileConfig::TILE_ROWS;
+    TileBlock& block = g_tile_blocks[channel][tile_y % WaterfallTileConfig::BLOCKS];
+    if (block.tile_y != tile_y) {
+        block.tile_y = tile_y;
+        block.rows = 0;
+        block.rgb.resize(static_cast<size_t>(WaterfallTileConfig::TILE_ROWS) * WATERFALL_WIDTH * 3);
+        block.encoded_rows.fill(0);
+        block.encoded.fill(nullptr);
+    }
+    return block;
+}
+
+void sync_waterfall_tiles() {
+    uint64_t first;
+    {
+        std::lock_guard<std::mutex> lock(g_tiles_mutex);
+        if (!g_tiles_initialized) {
+            for (auto& channel : g_tile_blocks) {
+                for (TileBlock& block : channel) block.tile_y = UINT64_MAX;
+            }
+            g_tiles_initialized = true;
+        }
+        first = g_rendered_sequence;
+    }
+
+    // Copy the new rows of both channels out under the waterfall lock; the producer is
+    // never held up by colormapping. Row seq lives at ((seq - first) * 2 + channel)
+    thread_local std::vector<uint8_t> rows;
+    uint64_t latest;
+    {
+        std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+        // Rows that left the history before anyone asked are skipped (painted as magnitude 0)
+        latest = g_waterfall.sequence;
+        const uint64_t oldest = (latest > WATERFALL_HEIGHT) ? latest - WATERFALL_HEIGHT : 0;
+        first = std::max(first, oldest);
+        if (first >= latest) return;
+
+        rows.resize(static_cast<size_t>(latest - first) * 2 * WATERFALL_WIDTH);
+        uint8_t* dst = rows.data();
+        for (uint64_t seq = first; seq < latest; seq++) {
+            const size_t idx = seq % WATERFALL_HEIGHT;
+            memcpy(dst, g_waterfall.ch1_history[idx].data(), WATERFALL_WIDTH);
+            memcpy(dst + WATERFALL_WIDTH, g_waterfall.ch2_history[idx].data(), WATERFALL_WIDTH);
+            dst += 2 * WATERFALL_WIDTH;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_tiles_mutex);
+    const uint8_t* lut = colormap_lut(Colormap::VIRIDIS);
+    const size_t row_bytes = static_cast<size_t>(WATERFALL_WIDTH) * 3;
+
+    // A concurrent call may already have rendered some or all of these rows
+    for (uint64_t seq = std::max(g_rendered_sequence, first); seq < latest; seq++) {
+        const uint8_t* magnitudes = rows.data() + static_cast<size_t>(seq - first) * 2 * WATERFALL_WIDTH;
+        const uint32_t offset = static_cast<uint32_t>(seq % WaterfallTileConfig::TILE_ROWS);
+        for (int channel = 0; channel < 2; channel++) {
+            TileBlock& block = block_for_row(channel, seq);
+            for (; block.rows < offset; block.rows++) {
+                uint8_t* rgb = block.rgb.data() + block.rows * row_bytes;
+                for (size_t i = 0; i < row_bytes; i += 3) memcpy(rgb + i, lut, 3);
+            }
+            colormap_row(magnitudes + channel * WATERFALL_WIDTH, lut, block.rgb.data() + offset * row_bytes,
+                         WATERFALL_WIDTH);
+            block.rows = offset + 1;
+            block.last_sequence = seq;
+        }
+    }
+    g_rendered_sequence = std::max(g_rendered_sequence, latest);
+}
+
+static std::shared_ptr<const std::vector<uint8_t>> encode_png(const uint8_t* rgb, int width, int height, int stride) {
+    int png_size = 0;
+    unsigned char* png_data = stbi_write_png_to_mem(rgb, stride, width, height, 3, &png_size);
+    if (!png_data || png_size == 0) {
+        std::cerr << "PNG generation failed" << std::endl;
+        return nullptr;
+    }
+    auto png = std::make_shared<std::vector<uint8_t>>(png_data, png_data + png_size);
+    STBIW_FREE(png_data);
+    return png;
+}
+
+bool get_waterfall_tile(int channel, uint32_t tile_x, uint64_t tile_y, WaterfallTile& tile) {
+    if ((channel != 1 && channel != 2) || tile_x >= WaterfallTileConfig::TILES_X) return false;
+
+    // Tile pixels are copied out so the PNG is encoded without holding the tile lock
+    thread_local std::vector<uint8_t> pixels;
+    const size_t tile_stride = static_cast<size_t>(WaterfallTileConfig::TILE_WIDTH) * 3;
+    {
+        std::lock_guard<std::mutex> lock(g_tiles_mutex);
+        if (!g_tiles_initialized) return false;
+        const TileBlock& block = g_tile_blocks[channel - 1][tile_y % WaterfallTileConfig::BLOCKS];
+        if (block.tile_y != tile_y || block.rows == 0) return false;
+
+        tile.rows = block.rows;
+        tile.last_sequence = block.last_sequence;
+        tile.complete = (block.rows == WaterfallTileConfig::TILE_ROWS);
+        if (block.encoded[tile_x] && block.encoded_rows[tile_x] == block.rows) {
+            tile.png = block.encoded[tile_x];
+            return true;
+        }
+
+        pixels.resize(tile.rows * tile_stride);
+        const size_t row_bytes = static_cast<size_t>(WATERFALL_WIDTH) * 3;
+        for (uint32_t y = 0; y < tile.rows; y++) {
+            memcpy(pixels.data() + y * tile_stride, block.rgb.data() + y * row_bytes + tile_x * tile_stride,
+                   tile_stride);
+        }
+    }
+
+    tile.png = encode_png(pixels.data(), WaterfallTileConfig::TILE_WIDTH, static_cast<int>(tile.rows),
+                          static_cast<int>(tile_stride));
+    if (!tile.png) return false;
+
+    std::lock_guard<std::mutex> lock(g_tiles_mutex);
+    TileBlock& block = g_tile_blocks[channel - 1][tile_y % WaterfallTileConfig::BLOCKS];
+    if (block.tile_y == tile_y && block.encoded_rows[tile_x] < tile.rows) {
+        block.encoded_rows[tile_x] = tile.rows;
+        block.encoded[tile_x] = tile.png;
+    }
+    return true;
+}
+
+bool get_newest_tile_row(uint64_t& tile_y) {
+    std::lock_guard<std::mutex> lock(g_tiles_mutex);
+    if (g_rendered_sequence == 0) return false;
+    tile_y = (g_rendered_sequence - 1) / WaterfallTileConfig::TILE_ROWS;
+    return true;
+}
+
+std::string get_waterfall_tiles_json() {
+    std::lock_guard<std::mutex> lock(g_tiles_mutex);
+
+    // Tile rows held (both channels advance together)
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    uint32_t last_rows = 0;
+    if (g_tiles_initialized) {
+        for (const TileBlock& block : g_tile_blocks[0]) {
+            if (block.tile_y == UINT64_MAX || block.rows == 0) continue;
+            first = std::min(first, block.tile_y);
+            if (block.tile_y >= last) {
+                last = block.tile_y;
+                last_rows = block.rows;
+            }
+        }
+    }
+
+    std::ostringstream json;
+    json << "{\"tileRows\":" << WaterfallTileConfig::TILE_ROWS
+         << ",\"tileWidth\":" << WaterfallTileConfig::TILE_WIDTH
+         << ",\"tilesX\":" << WaterfallTileConfig::TILES_X
+         << ",\"rows\":" << g_rendered_sequence;
+    if (first != UINT64_MAX) {
+        json << ",\"first\":" << first << ",\"last\":" << last << ",\"lastRows\":" << last_rows;
+    }
+    json << "}";
+    return json.str();
+}
+
+std::vector<uint8_t> generate_waterfall_png(int channel) {
+    // Copy the history under the lock, colormap and encode outside it
+    std::vector<uint8_t> magnitudes(static_cast<size_t>(WATERFALL_WIDTH) * WATERFALL_HEIGHT);
+    {
+        std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+        const auto& history = (channel == 1) ? g_waterfall.ch1_history : g_waterfall.ch2_history;
+        for (int y = 0; y < WATERFALL_HEIGHT; y++) {
+            // Oldest row first (circular buffer)
+            const int row_idx = (g_waterfall.write_index + y) % WATERFALL_HEIGHT;
+            std::copy(history[row_idx].begin(), history[row_idx].end(),
+                      magnitudes.begin() + static_cast<size_t>(y) * WATERFALL_WIDTH);
+        }
+    }
+
+    std::vector<uint8_t> pixels(magnitudes.size() * 3);
+    colormap_row(magnitudes.data(), colormap_lut(Colormap::VIRIDIS), pixels.data(), magnitudes.size());
+
+    auto png = encode_png(pixels.data(), WATERFALL_WIDTH, WATERFALL_HEIGHT, WATERFALL_WIDTH * 3);
+    return png ? *png : std::vector<uint8_t>();
+}
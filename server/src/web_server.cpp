@@ -7,6 +7,22 @@
 #include "signal_processing.h"
 #include "recording.h"
 #include "telemetry.h"
+#include "hop_tracker.h"
+#include "pulse_detector.h"
+#include "multires_stft.h"
+#include "spectral_stats.h"
+#include "scf_engine.h"
+#include "bearing_table.h"
+#include "df_waterfall.h"
+#include "superres_df.h"
+#include "beamformer.h"
+#include "gcc_phat.h"
+#include "geolocation.h"
+#include "spectrum_stream.h"
+#include "waterfall_image.h"
+#include "mjpeg_stream.h"
+#include "static_assets.h"
+#include "http_workers.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -22,9 +38,6 @@
 #include <complex>
 #include <fftw3.h>
 
-// PNG image writer (single-header library)
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
 
 // Mongoose embedded web server library
 // Download from https://github.com/cesanta/mongoose
@@ -72,6 +85,10 @@ static std::thread g_gps_thread;                     // GPS worker thread
 
 #ifdef USE_MONGOOSE
 static struct mg_mgr g_mgr;                          // Mongoose event manager
+static std::atomic<unsigned long> g_wakeup_conn_id{0};  // Listener connection that receives mg_wakeup events
+static std::atomic<bool> g_ws_wakeup_pending{false}; // A wakeup is queued and not yet handled
+static std::atomic<int> g_ws_clients{0};             // Open /ws/waterfall connections
+static std::atomic<int> g_mjpeg_clients{0};          // Open /waterfall.mjpeg connections
 #endif
 
 // External globals from main.cpp (shared state with RF processing)
@@ -90,52 +107,6 @@ extern std::atomic<uint32_t> g_df_end_bin;
 
 // Recording functions now in recording.h
 
-// Perceptually uniform color mapping for waterfall display
-struct RGB {
-    uint8_t r, g, b;
-};
-
-// Convert a normalized magnitude value to RGB color using Viridis colormap
-// This is a perceptually uniform colormap that maps signal strength to color
-// dark purple (low) to blue to cyan to green to yellow (high)
-// Args
-//   value Normalized magnitude (0.0 to 1.0)
-// Returns
-//   RGB color structure with 8-bit components
-RGB viridis_colormap(float value) {
-    // Clamp input to valid range
-    value = std::max(0.0f, std::min(1.0f, value));
-
-    RGB color;
-    if (value < 0.25f) {
-        // Dark purple to blue
-        float t = value / 0.25f;
-        color.r = static_cast<uint8_t>(68 + t * (59 - 68));
-        color.g = static_cast<uint8_t>(1 + t * (82 - 1));
-        color.b = static_cast<uint8_t>(84 + t * (139 - 84));
-    } else if (value < 0.5f) {
-        // Blue to teal/cyan
-        float t = (value - 0.25f) / 0.25f;
-        color.r = static_cast<uint8_t>(59 + t * (33 - 59));
-        color.g = static_cast<uint8_t>(82 + t * (145 - 82));
-        color.b = static_cast<uint8_t>(139 + t * (140 - 139));
-    } else if (value < 0.75f) {
-        // Cyan to green
-        float t = (value - 0.5f) / 0.25f;
-        color.r = static_cast<uint8_t>(33 + t * (94 - 33));
-        color.g = static_cast<uint8_t>(145 + t * (201 - 145));
-        color.b = static_cast<uint8_t>(140 + t * (98 - 140));
-    } else {
-        // Green to bright yellow
-        float t = (value - 0.75f) / 0.25f;
-        color.r = static_cast<uint8_t>(94 + t * (253 - 94));
-        color.g = static_cast<uint8_t>(201 + t * (231 - 201));
-        color.b = static_cast<uint8_t>(98 + t * (37 - 98));
-    }
-
-    return color;
-}
-
 // Update waterfall buffer with new FFT magnitude data
 // Thread-safe function that adds new spectrum data to the circular buffer
 // Args
@@ -152,6 +123,20 @@ void update_waterfall(const uint8_t* ch1_mag, const uint8_t* ch2_mag, size_t fft
 
     // Advance write index in circular buffer
     g_waterfall.write_index = (g_waterfall.write_index + 1) % WATERFALL_HEIGHT;
+    g_waterfall.sequence++;
+
+#ifdef USE_MONGOOSE
+    // One queued wakeup covers any number of rows; the web thread pushes all rows it finds
+    const unsigned long wakeup_id = g_wakeup_conn_id.load();
+    // (if the wakeup pipe is full, the flag stays set and the poll loop pushes on its tick)
+    if (wakeup_id != 0 && g_ws_clients.load() > 0 && !g_ws_wakeup_pending.exchange(true)) {
+        mg_wakeup(&g_mgr, wakeup_id, "W", 1);
+    }
+    // MJPEG frames are rendered by the encoder thread, which wakes the web thread itself
+    if (g_mjpeg_clients.load() > 0) {
+        notify_mjpeg_rows();
+    }
+#endif
 }
 
 // Update IQ constellation data for both channels
@@ -312,6 +297,9 @@ void set_manual_position(double latitude, double longitude, double altitude_m) {
         std::chrono::system_clock::now().time_since_epoch()).count();
     g_gps_position.satellites = 0;
     g_gps_position.hdop = 0;
+    record_position_fix(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::high_resolution_clock::now().time_since_epoch()).count(),
+                        latitude, longitude, NAN, NAN, true);
 
     std::cout << "GPS: Manual position set to " << std::fixed << std::setprecision(6)
               << latitude << ", " << longitude << " @ " << altitude_m << "m" << std::endl;
@@ -363,6 +351,7 @@ static void gps_thread_func() {
             const char* tpv_start = strstr(buffer, "\"class\":\"TPV\"");
             if (tpv_start) {
                 double lat = 0, lon = 0, alt = 0;
+                double course = NAN, speed = NAN;
                 int mode = 0;
 
                 // Extract latitude
@@ -377,6 +366,12 @@ static void gps_thread_func() {
                 const char* alt_str = strstr(tpv_start, "\"alt\":");
                 if (alt_str) sscanf(alt_str + 6, "%lf", &alt);
 
+                // Extract course over ground (degrees true) and speed (m/s) for geolocation
+                const char* track_str = strstr(tpv_start, "\"track\":");
+                if (track_str) sscanf(track_str + 8, "%lf", &course);
+                const char* speed_str = strstr(tpv_start, "\"speed\":");
+                if (speed_str) sscanf(speed_str + 8, "%lf", &speed);
+
                 // Extract mode (0=no fix, 2=2D, 3=3D)
                 const char* mode_str = strstr(tpv_start, "\"mode\":");
                 if (mode_str) sscanf(mode_str + 7, "%d", &mode);
@@ -391,6 +386,10 @@ static void gps_thread_func() {
                     g_gps_position.altitude_m = alt;
                     g_gps_position.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                         std::chrono::system_clock::now().time_since_epoch()).count();
+                    // Same clock as the pipeline's sample timestamps
+                    record_position_fix(std::chrono::duration_cast<std::chrono::microseconds>(
+                                            std::chrono::high_resolution_clock::now().time_since_epoch()).count(),
+                                        lat, lon, course, speed, false);
 
                     static int gps_update_counter = 0;
                     if (++gps_update_counter % 10 == 0) {  // Log every 10 updates
@@ -446,155 +445,623 @@ void set_gps_mode(bool enable) {
     }
 }
 
-// Generate PNG image from waterfall buffer history
-// Converts the circular buffer of FFT magnitudes into a color-mapped PNG image
-// Args
-//   channel Channel to render (1 or 2)
-// Returns
-//   Vector containing PNG-encoded image data (empty on error)
-std::vector<uint8_t> generate_waterfall_png(int channel) {
-    std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+#ifdef USE_MONGOOSE
+// WebSocket waterfall streaming
+// Each /ws/waterfall client subscribes to one spectrum view (spectrum_stream.h) and gets
+// every row of it as one binary message. It starts on the full-resolution view of both
+// channels and can switch by sending a JSON text message:
+//   {"ch":3,"start":0,"end":4095,"width":1024,"reduce":"max","every":1,"encoding":"raw"}
+// which is answered with the normalized view as JSON. Frames are encoded once per view and
+// row and the same bytes are sent to every subscriber. A client whose send buffer is backed
+// up skips rows and sees the gap in the sequence number. "encoding" names a codec
+// (spectrum_codec.h) or lists several in order of preference, e.g.
+// ["delta-bitpack","delta-deflate","raw"]; the acknowledgement carries the one chosen. For
+// delta codecs each client also tracks the last row it was sent, so it gets a delta against
+// that row or, after a gap, a keyframe.
+constexpr char WS_WATERFALL_TAG = 'W';
+
+struct WsWaterfallClient {
+    char tag;                   // WS_WATERFALL_TAG once the handshake is done
+    int32_t view_id;            // Subscribed view (-1 = none)
+    uint64_t next_sequence;     // First row not yet sent
+    uint64_t last_sent;         // Last row of the view sent (UINT64_MAX = none, delta reference)
+};
+static_assert(sizeof(WsWaterfallClient) <= MG_DATA_SIZE, "WebSocket client state must fit mg_connection::data");
+
+// Waterfall rows of one push, copied out of the history so encoding and sending run without
+// g_waterfall.mutex: rows first..latest-1, then the subscribers' reference rows before them
+struct WsPushRows {
+    uint64_t first = 0;
+    uint64_t latest = 0;
+    std::vector<uint64_t> references;       // Sequences of the reference rows, in copy order
+    std::vector<uint8_t> ch1, ch2;          // WATERFALL_WIDTH bytes per copied row
+
+    // Append history row `seq` (caller holds g_waterfall.mutex)
+    void copy_row(uint64_t seq) {
+        const size_t idx = seq % WATERFALL_HEIGHT;
+        ch1.insert(ch1.end(), g_waterfall.ch1_history[idx].begin(), g_waterfall.ch1_history[idx].end());
+        ch2.insert(ch2.end(), g_waterfall.ch2_history[idx].begin(), g_waterfall.ch2_history[idx].end());
+    }
 
-    const auto& history = (channel == 1) ? g_waterfall.ch1_history : g_waterfall.ch2_history;
+    // Copied row `seq` of one channel, nullptr if it was not copied
+    const uint8_t* row(const std::vector<uint8_t>& ch, uint64_t seq) const {
+        size_t slot;
+        if (seq >= first && seq < latest) {
+            slot = seq - first;
+        } else {
+            const auto it = std::find(references.begin(), references.end(), seq);
+            if (it == references.end()) return nullptr;
+            slot = (latest - first) + (it - references.begin());
+        }
+        return ch.data() + slot * WATERFALL_WIDTH;
+    }
+};
 
-    // Create RGB image data
-    std::vector<uint8_t> pixels(WATERFALL_WIDTH * WATERFALL_HEIGHT * 3);
+// Send every row the WebSocket clients have not seen yet (web server thread)
+static void push_waterfall_rows(struct mg_mgr *mgr) {
+    // Clear first: a row written while we push queues a new wakeup
+    g_ws_wakeup_pending = false;
+
+    thread_local WsPushRows rows;
+    rows.references.clear();
+    rows.ch1.clear();
+    rows.ch2.clear();
+    {
+        std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+        rows.latest = g_waterfall.sequence;
+        const uint64_t oldest = (rows.latest > WS_MAX_CATCHUP_ROWS) ? rows.latest - WS_MAX_CATCHUP_ROWS : 0;
+
+        rows.first = rows.latest;
+        for (struct mg_connection *c = mgr->conns; c != nullptr; c = c->next) {
+            if (!c->is_websocket || c->data[0] != WS_WATERFALL_TAG) continue;
+            WsWaterfallClient client;
+            memcpy(&client, c->data, sizeof(client));
+            rows.first = std::min(rows.first, std::max(client.next_sequence, oldest));
+        }
+        for (uint64_t seq = rows.first; seq < rows.latest; seq++) rows.copy_row(seq);
+
+        // Delta references older than the new rows, while the history still holds them
+        for (struct mg_connection *c = rows.first < rows.latest ? mgr->conns : nullptr; c != nullptr; c = c->next) {
+            if (!c->is_websocket || c->data[0] != WS_WATERFALL_TAG) continue;
+            WsWaterfallClient client;
+            memcpy(&client, c->data, sizeof(client));
+            const uint64_t ref = client.last_sent;
+            if (ref >= rows.first || rows.latest - ref >= WATERFALL_HEIGHT) continue;
+            if (std::find(rows.references.begin(), rows.references.end(), ref) != rows.references.end()) continue;
+            rows.references.push_back(ref);
+            rows.copy_row(ref);
+        }
+    }
+
+    for (struct mg_connection *c = mgr->conns; c != nullptr; c = c->next) {
+        if (!c->is_websocket || c->data[0] != WS_WATERFALL_TAG) continue;
+
+        WsWaterfallClient client;
+        memcpy(&client, c->data, sizeof(client));
+        uint64_t seq = std::max(client.next_sequence, rows.first);
+        for (; seq < rows.latest && c->send.len < WS_MAX_BACKLOG_BYTES; seq++) {
+            const bool ref_held = client.last_sent < seq;
+            auto frame = get_stream_frame(client.view_id, seq, rows.row(rows.ch1, seq), rows.row(rows.ch2, seq),
+                                          WATERFALL_WIDTH, client.last_sent,
+                                          ref_held ? rows.row(rows.ch1, client.last_sent) : nullptr,
+                                          ref_held ? rows.row(rows.ch2, client.last_sent) : nullptr);
+            if (!frame) continue;  // Row not part of this view
+            mg_ws_send(c, frame->data(), frame->size(), WEBSOCKET_OP_BINARY);
+            client.last_sent = seq;
+            record_stream_send(client.view_id, frame->size());
+            g_http_bytes_sent.fetch_add(frame->size());
+        }
+        client.next_sequence = rows.latest;  // Rows left over from a backed-up client are dropped
+        memcpy(c->data, &client, sizeof(client));
+    }
+}
 
-    // Fill pixels (top to bottom newest at bottom)
-    for (int y = 0; y < WATERFALL_HEIGHT; y++) {
-        // Calculate actual row index (accounting for circular buffer)
-        int row_idx = (g_waterfall.write_index + y) % WATERFALL_HEIGHT;
+// MJPEG waterfall viewers (/waterfall.mjpeg)
+// Each viewer holds a stream of the registry (mjpeg_stream.h) and the number of the last frame
+// it was sent. The encoder thread renders frames and wakes the loop with MJPEG_FRAME_WAKEUP;
+// the loop only sends each viewer the cached part of its stream, shared by all its viewers.
+// A viewer whose send buffer is backed up skips frames instead of queueing stale images.
+constexpr char MJPEG_VIEWER_TAG = 'J';
+constexpr char MJPEG_FRAME_WAKEUP = 'M';
+
+struct MjpegViewer {
+    char tag;                   // MJPEG_VIEWER_TAG once the response headers are sent
+    int32_t stream_id;
+    uint64_t last_frame;        // Number of the last frame sent or skipped (0 = none)
+};
+static_assert(sizeof(MjpegViewer) <= MG_DATA_SIZE, "MJPEG viewer state must fit mg_connection::data");
+
+// Send each MJPEG viewer its stream's newest frame if it has not had it yet (web server thread)
+static void push_mjpeg_frames(struct mg_mgr *mgr) {
+    for (struct mg_connection *c = mgr->conns; c != nullptr; c = c->next) {
+        if (c->is_websocket || c->data[0] != MJPEG_VIEWER_TAG) continue;
+
+        MjpegViewer viewer;
+        memcpy(&viewer, c->data, sizeof(viewer));
+        MjpegFrame frame;
+        if (!get_mjpeg_frame(viewer.stream_id, frame) || frame.number <= viewer.last_frame) continue;
+
+        const bool skipped = c->send.len >= MJPEG_MAX_BACKLOG_BYTES;
+        if (!skipped) {
+            mg_send(c, frame.part->data(), frame.part->size());
+            g_http_bytes_sent.fetch_add(frame.part->size());
+        }
+        record_mjpeg_send(viewer.stream_id, frame.part->size(), skipped);
+        viewer.last_frame = frame.number;
+        memcpy(c->data, &viewer, sizeof(viewer));
+    }
+}
 
-        for (int x = 0; x < WATERFALL_WIDTH; x++) {
-            float value = history[row_idx][x] / 255.0f;
-            RGB color = viridis_colormap(value);
+// Encoder thread: new frames are ready
+static void mjpeg_frame_ready() {
+    const unsigned long wakeup_id = g_wakeup_conn_id.load();
+    if (wakeup_id != 0) {
+        mg_wakeup(&g_mgr, wakeup_id, &MJPEG_FRAME_WAKEUP, 1);
+    }
+}
 
-            int idx = (y * WATERFALL_WIDTH + x) * 3;
-            pixels[idx + 0] = color.r;
-            pixels[idx + 1] = color.g;
-            pixels[idx + 2] = color.b;
+// Switch a WebSocket client to the view described by a JSON subscribe message
+static void handle_ws_subscribe(struct mg_connection *c, struct mg_str json) {
+    WsWaterfallClient client;
+    memcpy(&client, c->data, sizeof(client));
+
+    StreamView view = default_stream_view(WATERFALL_WIDTH);
+    view.channel_mask = static_cast<uint8_t>(mg_json_get_long(json, "$.ch", view.channel_mask));
+    view.start_bin = static_cast<uint32_t>(mg_json_get_long(json, "$.start", view.start_bin));
+    view.end_bin = static_cast<uint32_t>(mg_json_get_long(json, "$.end", view.end_bin));
+    view.width = static_cast<uint32_t>(mg_json_get_long(json, "$.width", view.width));
+    view.every = static_cast<uint32_t>(mg_json_get_long(json, "$.every", view.every));
+    char* reduce = mg_json_get_str(json, "$.reduce");
+    if (reduce) {
+        view.reduce = (strcmp(reduce, "mean") == 0) ? DECIMATE_MEAN :
+                      (strcmp(reduce, "max") == 0) ? DECIMATE_MAX : UINT32_MAX;
+        free(reduce);
+    }
+    // Codec: one name, or a preference list of which the first one known here is used
+    bool valid = true;
+    char* encoding = mg_json_get_str(json, "$.encoding");
+    if (encoding) {
+        const SpectrumCodec* codec = find_spectrum_codec(encoding);
+        valid = (codec != nullptr);
+        if (codec) view.encoding = codec->encoding;
+        free(encoding);
+    } else if (mg_json_get(json, "$.encoding", nullptr) >= 0) {
+        valid = false;
+        for (int i = 0; i < 8 && !valid; i++) {
+            char path[32];
+            snprintf(path, sizeof(path), "$.encoding[%d]", i);
+            char* name = mg_json_get_str(json, path);
+            if (!name) break;
+            const SpectrumCodec* codec = find_spectrum_codec(name);
+            if (codec) {
+                view.encoding = codec->encoding;
+                valid = true;
+            }
+            free(name);
         }
     }
 
-    // Write PNG to memory
-    int png_size = 0;
-    unsigned char* png_data = stbi_write_png_to_mem(
-        pixels.data(),
-        WATERFALL_WIDTH * 3,  // stride
-        WATERFALL_WIDTH,
-        WATERFALL_HEIGHT,
-        3,  // channels
-        &png_size
-    );
-
-    if (!png_data || png_size == 0) {
-        std::cerr << "PNG generation failed" << std::endl;
-        return std::vector<uint8_t>();  // Return empty vector on error
+    int view_id = -1;
+    if (valid && normalize_stream_view(view, WATERFALL_WIDTH)) {
+        view_id = subscribe_stream_view(view);
+    }
+    if (view_id < 0) {
+        mg_ws_printf(c, WEBSOCKET_OP_TEXT, "{%m:%m}", MG_ESC("error"),
+                     MG_ESC(valid ? "invalid or too many views" : "unknown encoding"));
+        return;
     }
 
-    // Copy to vector and free stbi memory
-    std::vector<uint8_t> result(png_data, png_data + png_size);
-    STBIW_FREE(png_data);  // Use STBIW_FREE instead of free
+    unsubscribe_stream_view(client.view_id);
+    client.view_id = view_id;
+    client.last_sent = UINT64_MAX;  // First row of the new view is a keyframe
+    {
+        // Resume with the newest row of the new view
+        std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+        client.next_sequence = (g_waterfall.sequence > view.every) ? g_waterfall.sequence - view.every : 0;
+    }
+    memcpy(c->data, &client, sizeof(client));
+
+    mg_ws_printf(c, WEBSOCKET_OP_TEXT,
+                 "{\"view\":%d,\"ch\":%d,\"start\":%u,\"end\":%u,\"width\":%u,\"reduce\":\"%s\","
+                 "\"every\":%u,\"encoding\":\"%s\"}",
+                 view_id, view.channel_mask, view.start_bin, view.end_bin, view.width,
+                 view.reduce == DECIMATE_MEAN ? "mean" : "max", view.every,
+                 find_spectrum_codec(view.encoding)->name);
+    push_waterfall_rows(c->mgr);
+}
 
-    return result;
+// Reply with a web asset: 304 if the client's copy is current, else the gzip variant when
+// accepted, else the plain file. "no-cache" makes browsers revalidate on each load, which
+// costs one round trip and no body while the file is unchanged.
+static void serve_static_asset(struct mg_connection *c, struct mg_http_message *hm, const StaticAsset& asset) {
+    struct mg_str *accept_encoding = mg_http_get_header(hm, "Accept-Encoding");
+    const bool gzip = !asset.gzip.empty() && accept_encoding != nullptr &&
+                      accepts_gzip(accept_encoding->buf, accept_encoding->len);
+    const std::string& etag = gzip ? asset.gzip_etag : asset.etag;
+    g_telemetry.http_requests.fetch_add(1);
+
+    struct mg_str *if_none_match = mg_http_get_header(hm, "If-None-Match");
+    if (if_none_match != nullptr && etag_matches(if_none_match->buf, if_none_match->len, etag)) {
+        mg_printf(c, "HTTP/1.1 304 Not Modified\r\n"
+                    "ETag: %s\r\n"
+                    "Cache-Control: no-cache\r\n"
+                    "Vary: Accept-Encoding\r\n"
+                    "\r\n", etag.c_str());
+        c->is_resp = 0;  // Response complete: the connection takes the next request
+        return;
+    }
+
+    const std::vector<uint8_t>& body = gzip ? asset.gzip : asset.body;
+    mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                "Content-Type: %s\r\n"
+                "%s"
+                "ETag: %s\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Vary: Accept-Encoding\r\n"
+                "Content-Length: %lu\r\n"
+                "\r\n",
+                asset.mime_type, gzip ? "Content-Encoding: gzip\r\n" : "", etag.c_str(),
+                (unsigned long)body.size());
+    if (mg_strcmp(hm->method, mg_str("HEAD")) != 0) {
+        mg_send(c, body.data(), body.size());
+        g_http_bytes_sent.fetch_add(body.size());
+    }
+    c->is_resp = 0;
 }
 
-// Helper function to get MIME type from file extension
-static const char* get_mime_type(const char* path) {
-    const char* ext = strrchr(path, '.');
-    if (!ext) return "application/octet-stream";
-
-    if (strcmp(ext, ".html") == 0 || strcmp(ext, ".htm") == 0) return "text/html; charset=utf-8";
-    if (strcmp(ext, ".js") == 0) return "application/javascript; charset=utf-8";
-    if (strcmp(ext, ".css") == 0) return "text/css; charset=utf-8";
-    if (strcmp(ext, ".json") == 0) return "application/json; charset=utf-8";
-    if (strcmp(ext, ".png") == 0) return "image/png";
-    if (strcmp(ext, ".jpg") == 0 || strcmp(ext, ".jpeg") == 0) return "image/jpeg";
-    if (strcmp(ext, ".gif") == 0) return "image/gif";
-    if (strcmp(ext, ".svg") == 0) return "image/svg+xml";
-    if (strcmp(ext, ".ico") == 0) return "image/x-icon";
-    if (strcmp(ext, ".txt") == 0) return "text/plain; charset=utf-8";
-
-    return "application/octet-stream";
+// Deferred replies (http_workers.h)
+// Slow endpoints hand their work to an HTTP worker; the worker wakes the connection with
+// HTTP_JOB_WAKEUP and the event loop sends the stored reply.
+constexpr char HTTP_JOB_WAKEUP = 'H';
+
+static void http_job_ready(unsigned long conn_id) {
+    mg_wakeup(&g_mgr, conn_id, &HTTP_JOB_WAKEUP, 1);
 }
 
-// Helper function to read static files from web_assets directory
-static std::string read_static_file(const char* filepath) {
-    // Try to read from web_assets directory relative to executable
-    std::string full_path = std::string("web_assets/") + filepath;
+static const char* http_status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 503: return "Service Unavailable";
+        default:  return "Error";
+    }
+}
 
-    std::ifstream file(full_path, std::ios::binary);
-    if (!file.is_open()) {
-        // Try alternative path (relative to server directory)
-        full_path = std::string("server/web_assets/") + filepath;
-        file.open(full_path, std::ios::binary);
+// Send the finished job reply of a connection, if it has one (web server thread)
+static void send_http_result(struct mg_connection *c) {
+    HttpJobResult result;
+    if (!take_http_result(c->id, result)) return;
+    mg_printf(c, "HTTP/1.1 %d %s\r\n"
+                "%s"
+                "Content-Length: %lu\r\n"
+                "\r\n",
+                result.status, http_status_text(result.status), result.headers.c_str(),
+                (unsigned long)result.body.size());
+    mg_send(c, result.body.data(), result.body.size());
+    g_http_bytes_sent.fetch_add(result.body.size());
+    c->is_resp = 0;
+}
 
-        if (!file.is_open()) {
-            std::cerr << "Static file not found: " << filepath << std::endl;
-            return "";
-        }
+// Run a request's work on an HTTP worker; the reply follows when it is done
+static void defer_http_reply(struct mg_connection *c, HttpJob job) {
+    g_telemetry.http_requests.fetch_add(1);
+    if (!submit_http_job(c->id, std::move(job))) {
+        mg_http_reply(c, 503, "Content-Type: text/plain\r\nRetry-After: 1\r\n", "Server busy");
     }
+}
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+// Job replying with a JSON document
+static HttpJob json_job(std::string (*make_json)()) {
+    return [make_json](HttpJobResult& result) {
+        result.headers = "Content-Type: application/json\r\nCache-Control: no-cache\r\n";
+        result.body = make_json();
+    };
 }
 
-// HTML page is now served from web_assets/index.html via read_static_file()
+// Inverse FFT buffers and plan of one HTTP worker for /iq_data band filtering
+// FFTW's planner is not thread-safe, so plans are created and destroyed under a lock
+static std::mutex g_iq_plan_mutex;
+
+struct IqFilterState {
+    fftwf_plan plan = nullptr;
+    fftwf_complex* in = nullptr;
+    fftwf_complex* out = nullptr;
+    size_t size = 0;
+
+    void release() {
+        if (!plan) return;
+        std::lock_guard<std::mutex> lock(g_iq_plan_mutex);
+        fftwf_destroy_plan(plan);
+        fftwf_free(in);
+        fftwf_free(out);
+        plan = nullptr;
+    }
+    ~IqFilterState() { release(); }
+};
+
+// Keep bins [start_bin, end_bin] of a spectrum, inverse transform and decimate to IQ_SAMPLES
+static void inverse_band(const std::vector<std::complex<float>>& fft, size_t start_bin, size_t end_bin,
+                         IqFilterState& state, int16_t* i_out, int16_t* q_out) {
+    const size_t fft_size = fft.size();
+    for (size_t i = 0; i < fft_size; i++) {
+        if (i >= start_bin && i <= end_bin) {
+            state.in[i][0] = fft[i].real();
+            state.in[i][1] = fft[i].imag();
+        } else {
+            state.in[i][0] = 0.0f;
+            state.in[i][1] = 0.0f;
+        }
+    }
+    fftwf_execute(state.plan);
+
+    const size_t decimation_step = fft_size / IQ_SAMPLES;
+    const float scale = 1.0f / fft_size;  // FFTW doesn't normalize IFFT
+    for (int i = 0; i < IQ_SAMPLES; i++) {
+        const size_t idx = i * decimation_step;
+        i_out[i] = static_cast<int16_t>(state.out[idx][0] * scale * 32767.0f);
+        q_out[i] = static_cast<int16_t>(state.out[idx][1] * scale * 32767.0f);
+    }
+}
 
+// Band-filtered IQ of both channels from the latest FFT (ch1 I, ch1 Q, ch2 I, ch2 Q as int16)
+// The FFT is copied under g_iq_data.mutex and transformed after releasing it
+// Returns false if no FFT data is available
+static bool filter_iq_band(size_t start_bin, size_t end_bin, std::string& out) {
+    thread_local IqFilterState state;
+    thread_local std::vector<std::complex<float>> ch1_fft;
+    thread_local std::vector<std::complex<float>> ch2_fft;
+    {
+        std::lock_guard<std::mutex> lock(g_iq_data.mutex);
+        if (g_iq_data.ch1_fft.empty() || g_iq_data.ch2_fft.empty()) return false;
+        ch1_fft = g_iq_data.ch1_fft;
+        ch2_fft = g_iq_data.ch2_fft;
+    }
 
-// Helper function to read JavaScript files
-static std::string read_js_file(const char* filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "JS file not found: " << filepath << std::endl;
-        return "";
+    // Clamp to valid range
+    const size_t fft_size = ch1_fft.size();
+    start_bin = std::min(start_bin, fft_size - 1);
+    end_bin = std::min(end_bin, fft_size - 1);
+    if (start_bin > end_bin) std::swap(start_bin, end_bin);
+
+    if (!state.plan || state.size != fft_size) {
+        state.release();
+        std::lock_guard<std::mutex> lock(g_iq_plan_mutex);
+        state.in = fftwf_alloc_complex(fft_size);
+        state.out = fftwf_alloc_complex(fft_size);
+        state.plan = fftwf_plan_dft_1d(fft_size, state.in, state.out, FFTW_BACKWARD, FFTW_ESTIMATE);
+        state.size = fft_size;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+
+    int16_t filtered[4][IQ_SAMPLES];
+    inverse_band(ch1_fft, start_bin, end_bin, state, filtered[0], filtered[1]);
+    inverse_band(ch2_fft, start_bin, end_bin, state, filtered[2], filtered[3]);
+    out.assign(reinterpret_cast<const char*>(filtered), sizeof(filtered));
+    return true;
 }
+#endif
 
 // HTTP request handler
 void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
 #ifdef USE_MONGOOSE
-    if (ev == MG_EV_HTTP_MSG) {
+    if (ev == MG_EV_WAKEUP) {
+        struct mg_str *data = (struct mg_str *) ev_data;
+        if (data->len == 1 && data->buf[0] == HTTP_JOB_WAKEUP) {
+            send_http_result(c);
+        } else if (data->len == 1 && data->buf[0] == MJPEG_FRAME_WAKEUP) {
+            push_mjpeg_frames(c->mgr);
+        } else {
+            push_waterfall_rows(c->mgr);
+        }
+    } else if (ev == MG_EV_WS_OPEN) {
+        // Start on the full-resolution view with the newest row so the display fills immediately
+        WsWaterfallClient client;
+        client.tag = WS_WATERFALL_TAG;
+        client.view_id = subscribe_stream_view(default_stream_view(WATERFALL_WIDTH));
+        client.last_sent = UINT64_MAX;
+        {
+            std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+            client.next_sequence = (g_waterfall.sequence > 0) ? g_waterfall.sequence - 1 : 0;
+        }
+        memcpy(c->data, &client, sizeof(client));
+        g_ws_clients.fetch_add(1);
+        push_waterfall_rows(c->mgr);
+    } else if (ev == MG_EV_WS_MSG) {
+        struct mg_ws_message *wm = (struct mg_ws_message *) ev_data;
+        if (c->data[0] == WS_WATERFALL_TAG && (wm->flags & 0x0F) == WEBSOCKET_OP_TEXT) {
+            handle_ws_subscribe(c, wm->data);
+        }
+    } else if (ev == MG_EV_CLOSE) {
+        cancel_http_job(c->id);
+        if (c->is_websocket && c->data[0] == WS_WATERFALL_TAG) {
+            WsWaterfallClient client;
+            memcpy(&client, c->data, sizeof(client));
+            unsubscribe_stream_view(client.view_id);
+            c->data[0] = 0;
+            g_ws_clients.fetch_sub(1);
+        } else if (!c->is_websocket && c->data[0] == MJPEG_VIEWER_TAG) {
+            MjpegViewer viewer;
+            memcpy(&viewer, c->data, sizeof(viewer));
+            close_mjpeg_stream(viewer.stream_id);
+            c->data[0] = 0;
+            g_mjpeg_clients.fetch_sub(1);
+        }
+    } else if (ev == MG_EV_HTTP_MSG) {
         struct mg_http_message *hm = (struct mg_http_message *) ev_data;
 
-        // Serve main HTML page
-        if (mg_strcmp(hm->uri, mg_str("/")) == 0) {
-            std::string html_content = read_static_file("index.html");
-            if (!html_content.empty()) {
-                mg_http_reply(c, 200,
-                    "Content-Type: text/html; charset=utf-8\r\n"
-                    "Cache-Control: no-cache, no-store, must-revalidate\r\n"
-                    "Pragma: no-cache\r\n"
-                    "Expires: 0\r\n",
-                    "%s", html_content.c_str());
-            } else {
-                mg_http_reply(c, 404, "Content-Type: text/plain\r\n", "404 Not Found");
-            }
+        // Web assets (index.html, js/) from the in-memory table
+        if (const StaticAsset* asset = find_static_asset(hm->uri.buf, hm->uri.len)) {
+            serve_static_asset(c, hm, *asset);
         }
         // FFT data request (uncompressed)
+        // Optional start/end (inclusive bin range) and width (output bins) return the
+        // range pooled to the display width; reduce=mean averages instead of keeping peaks
         else if (mg_strcmp(hm->uri, mg_str("/fft")) == 0) {
             char channel_str[8] = "1";
+            char start_str[16] = "0";
+            char end_str[16] = "";
+            char width_str[16] = "";
+            char reduce_str[8] = "max";
             mg_http_get_var(&hm->query, "ch", channel_str, sizeof(channel_str));
+            mg_http_get_var(&hm->query, "start", start_str, sizeof(start_str));
+            mg_http_get_var(&hm->query, "end", end_str, sizeof(end_str));
+            mg_http_get_var(&hm->query, "width", width_str, sizeof(width_str));
+            mg_http_get_var(&hm->query, "reduce", reduce_str, sizeof(reduce_str));
             int channel = atoi(channel_str);
 
-            std::lock_guard<std::mutex> lock(g_waterfall.mutex);
-            const auto& history = (channel == 1) ? g_waterfall.ch1_history : g_waterfall.ch2_history;
-            int latest_idx = (g_waterfall.write_index - 1 + WATERFALL_HEIGHT) % WATERFALL_HEIGHT;
+            const long start_bin = atol(start_str);
+            const long end_bin = end_str[0] ? atol(end_str) : WATERFALL_WIDTH - 1;
+            if (start_bin < 0 || end_bin < start_bin || end_bin >= WATERFALL_WIDTH) {
+                mg_http_reply(c, 400, "Content-Type: text/plain\r\n", "Invalid bin range");
+                return;
+            }
+            const size_t span = static_cast<size_t>(end_bin - start_bin + 1);
+            const long requested_width = width_str[0] ? atol(width_str) : static_cast<long>(span);
+            const size_t width = std::clamp<size_t>(requested_width > 0 ? requested_width : span, 1, span);
+            const uint32_t reduce = (strcmp(reduce_str, "mean") == 0) ? DECIMATE_MEAN : DECIMATE_MAX;
+
+            uint8_t row[WATERFALL_WIDTH];
+            {
+                std::lock_guard<std::mutex> lock(g_waterfall.mutex);
+                const auto& history = (channel == 1) ? g_waterfall.ch1_history : g_waterfall.ch2_history;
+                int latest_idx = (g_waterfall.write_index - 1 + WATERFALL_HEIGHT) % WATERFALL_HEIGHT;
+                decimate_spectrum(history[latest_idx].data(), start_bin, end_bin, row, width, reduce);
+            }
 
             // Send raw uncompressed data
             mg_printf(c, "HTTP/1.1 200 OK\r\n"
                         "Content-Type: application/octet-stream\r\n"
                         "Cache-Control: no-cache\r\n"
-                        "Content-Length: %d\r\n"
-                        "\r\n", WATERFALL_WIDTH);
-            mg_send(c, history[latest_idx].data(), WATERFALL_WIDTH);
-            g_http_bytes_sent.fetch_add(WATERFALL_WIDTH);
+                        "Content-Length: %lu\r\n"
+                        "\r\n", (unsigned long)width);
+            mg_send(c, row, width);
+            g_http_bytes_sent.fetch_add(width);
             c->is_draining = 1;
         }
+        // Waterfall row push stream (WebSocket upgrade)
+        else if (mg_strcmp(hm->uri, mg_str("/ws/waterfall")) == 0) {
+            mg_ws_upgrade(c, hm, nullptr);
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Waterfall tile geometry and the tile rows held
+        else if (mg_strcmp(hm->uri, mg_str("/waterfall_tiles")) == 0) {
+            sync_waterfall_tiles();
+            std::string tiles_json = get_waterfall_tiles_json();
+            mg_http_reply(c, 200,
+                "Content-Type: application/json\r\n"
+                "Cache-Control: no-cache\r\n",
+                "%s", tiles_json.c_str());
+            g_http_bytes_sent.fetch_add(tiles_json.size());
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Colormapped waterfall tile (PNG): ?ch=1&x=<tile column>&y=<tile row, default newest>
+        else if (mg_strcmp(hm->uri, mg_str("/waterfall_tile")) == 0) {
+            // mg_http_get_var empties the buffer when a variable is missing: defaults apply after
+            char channel_str[8];
+            char x_str[16];
+            char y_str[24];
+            mg_http_get_var(&hm->query, "ch", channel_str, sizeof(channel_str));
+            mg_http_get_var(&hm->query, "x", x_str, sizeof(x_str));
+            mg_http_get_var(&hm->query, "y", y_str, sizeof(y_str));
+            const int channel = channel_str[0] ? atoi(channel_str) : 1;
+            const long tile_x = x_str[0] ? atol(x_str) : 0;
+
+            const std::string y_param = y_str;
+
+            // Colormapping new rows and PNG encoding run on an HTTP worker
+            defer_http_reply(c, [channel, tile_x, y_param](HttpJobResult& result) {
+                // Only rows written since the last tile request are colormapped here
+                sync_waterfall_tiles();
+                uint64_t tile_y = 0;
+                bool have_row = true;
+                if (!y_param.empty()) {
+                    tile_y = strtoull(y_param.c_str(), nullptr, 10);
+                } else {
+                    have_row = get_newest_tile_row(tile_y);
+                }
+
+                WaterfallTile tile;
+                if (!have_row || !get_waterfall_tile(channel, static_cast<uint32_t>(tile_x), tile_y, tile)) {
+                    result.status = 404;
+                    result.headers = "Content-Type: text/plain\r\n";
+                    result.body = "Tile not available";
+                    return;
+                }
+
+                // Completed tiles never change; the newest one grows until it has TILE_ROWS rows.
+                // Without y the URL means "newest tile" and must be revalidated even when complete
+                const bool immutable = tile.complete && !y_param.empty();
+                char headers[256];
+                snprintf(headers, sizeof(headers),
+                         "Content-Type: image/png\r\n"
+                         "Cache-Control: %s\r\n"
+                         "X-Tile-Row: %llu\r\n"
+                         "X-Tile-Rows: %u\r\n"
+                         "X-Last-Sequence: %llu\r\n",
+                         immutable ? "public, max-age=3600, immutable" : "no-cache",
+                         (unsigned long long)tile_y, tile.rows, (unsigned long long)tile.last_sequence);
+                result.headers = headers;
+                result.body.assign(tile.png->begin(), tile.png->end());
+            });
+        }
+        // Live colormapped waterfall (MJPEG): ?ch=1&width=1024&height=256&colormap=viridis&fps=10&quality=75
+        // The response never ends; each part replaces the previous image
+        else if (mg_strcmp(hm->uri, mg_str("/waterfall.mjpeg")) == 0) {
+            MjpegStreamParams params = default_mjpeg_params();
+            char value[24];
+            if (mg_http_get_var(&hm->query, "ch", value, sizeof(value)) > 0) params.channel = atoi(value);
+            if (mg_http_get_var(&hm->query, "width", value, sizeof(value)) > 0) params.width = static_cast<uint32_t>(atol(value));
+            if (mg_http_get_var(&hm->query, "height", value, sizeof(value)) > 0) params.height = static_cast<uint32_t>(atol(value));
+            if (mg_http_get_var(&hm->query, "fps", value, sizeof(value)) > 0) params.fps = static_cast<uint32_t>(atol(value));
+            if (mg_http_get_var(&hm->query, "quality", value, sizeof(value)) > 0) params.quality = atoi(value);
+            bool valid = true;
+            if (mg_http_get_var(&hm->query, "colormap", value, sizeof(value)) > 0) {
+                valid = parse_colormap(value, params.colormap);
+            }
+            g_telemetry.http_requests.fetch_add(1);
+            if (!valid || !normalize_mjpeg_params(params)) {
+                mg_http_reply(c, 400, "Content-Type: text/plain\r\n", "Invalid channel or colormap");
+                return;
+            }
+
+            MjpegViewer viewer;
+            viewer.tag = MJPEG_VIEWER_TAG;
+            viewer.stream_id = open_mjpeg_stream(params);
+            viewer.last_frame = 0;
+            if (viewer.stream_id < 0) {
+                mg_http_reply(c, 503, "Content-Type: text/plain\r\n", "Too many MJPEG streams");
+                return;
+            }
+            mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: multipart/x-mixed-replace; boundary=%s\r\n"
+                        "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+                        "Pragma: no-cache\r\n"
+                        "Connection: close\r\n"
+                        "\r\n", MjpegConfig::BOUNDARY);
+            memcpy(c->data, &viewer, sizeof(viewer));
+            g_mjpeg_clients.fetch_add(1);
+            push_mjpeg_frames(c->mgr);  // Cached image right away (a new stream's first follows)
+        }
+        // Registered MJPEG streams (viewers, encodes and fan-out)
+        else if (mg_strcmp(hm->uri, mg_str("/mjpeg_streams")) == 0) {
+            std::string streams_json = get_mjpeg_streams_json();
+            mg_http_reply(c, 200,
+                "Content-Type: application/json\r\n"
+                "Cache-Control: no-cache\r\n",
+                "%s", streams_json.c_str());
+            g_http_bytes_sent.fetch_add(streams_json.size());
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Registered spectrum views (subscribers, encodes and fan-out)
+        else if (mg_strcmp(hm->uri, mg_str("/stream_views")) == 0) {
+            std::string views_json = get_stream_views_json();
+            mg_http_reply(c, 200,
+                "Content-Type: application/json\r\n"
+                "Cache-Control: no-cache\r\n",
+                "%s", views_json.c_str());
+            g_http_bytes_sent.fetch_add(views_json.size());
+            g_telemetry.http_requests.fetch_add(1);
+        }
         // Serve status JSON
         else if (mg_strcmp(hm->uri, mg_str("/status")) == 0) {
             char json[384];
@@ -619,117 +1086,160 @@ void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
         }
         // Serve telemetry/stats JSON
         else if (mg_strcmp(hm->uri, mg_str("/stats")) == 0) {
-            std::string telemetry_json = get_telemetry_json();
+            defer_http_reply(c, json_job(get_telemetry_json));
+        }
+        // Serve frequency-hopping emitter table
+        else if (mg_strcmp(hm->uri, mg_str("/hop_emitters")) == 0) {
+            defer_http_reply(c, json_job(get_hop_emitters_json));
+        }
+        // Serve time-domain pulse history
+        else if (mg_strcmp(hm->uri, mg_str("/pulses")) == 0) {
+            defer_http_reply(c, json_job(get_pulses_json));
+        }
+        // Multi-resolution spectrogram rows (polling keeps the resolution subscribed)
+        else if (mg_strcmp(hm->uri, mg_str("/stft")) == 0) {
+            // mg_http_get_var empties the buffer when a variable is missing: defaults apply after
+            char size_str[16];
+            char channel_str[8];
+            char since_str[32];
+            mg_http_get_var(&hm->query, "size", size_str, sizeof(size_str));
+            mg_http_get_var(&hm->query, "ch", channel_str, sizeof(channel_str));
+            mg_http_get_var(&hm->query, "since", since_str, sizeof(since_str));
+            const size_t fft_size = size_str[0] ? strtoul(size_str, nullptr, 10) : 256;
+            const int channel = channel_str[0] ? atoi(channel_str) : 1;
+            const uint64_t since = since_str[0] ? strtoull(since_str, nullptr, 10) : 0;
+
+            std::vector<uint8_t> rows;
+            uint64_t sequence = 0;
+            if (!get_stft_rows(fft_size, channel, since, rows, sequence)) {
+                mg_http_reply(c, 404, "Content-Type: text/plain\r\n", "Unknown STFT size");
+            } else {
+                // Rows are fft_size bytes each, oldest first
+                mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: application/octet-stream\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "X-STFT-Size: %lu\r\n"
+                            "X-STFT-Rows: %lu\r\n"
+                            "X-STFT-Sequence: %llu\r\n"
+                            "Content-Length: %lu\r\n"
+                            "\r\n",
+                            (unsigned long)fft_size, (unsigned long)(rows.size() / fft_size),
+                            (unsigned long long)sequence, (unsigned long)rows.size());
+                mg_send(c, rows.data(), rows.size());
+                g_http_bytes_sent.fetch_add(rows.size());
+                c->is_draining = 1;
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Configured STFT resolutions
+        else if (mg_strcmp(hm->uri, mg_str("/stft_resolutions")) == 0) {
+            std::string stft_json = get_stft_resolutions_json();
             mg_http_reply(c, 200,
                 "Content-Type: application/json\r\n"
                 "Cache-Control: no-cache\r\n",
-                "%s", telemetry_json.c_str());
+                "%s", stft_json.c_str());
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Spectral kurtosis summary and SK detections
+        else if (mg_strcmp(hm->uri, mg_str("/spectral_stats")) == 0) {
+            defer_http_reply(c, json_job(get_spectral_stats_json));
+        }
+        // Per-bin SK or flatness trace (0-255, same layout as /fft)
+        else if (mg_strcmp(hm->uri, mg_str("/spectral_trace")) == 0) {
+            char channel_str[8] = "1";
+            char metric_str[16] = "sk";
+            mg_http_get_var(&hm->query, "ch", channel_str, sizeof(channel_str));
+            mg_http_get_var(&hm->query, "metric", metric_str, sizeof(metric_str));
+
+            std::vector<uint8_t> trace;
+            const bool flatness = strcmp(metric_str, "flatness") == 0;
+            if (!get_spectral_trace(atoi(channel_str), flatness, trace)) {
+                mg_http_reply(c, 503, "Content-Type: text/plain\r\n", "No spectral statistics yet");
+            } else {
+                mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: application/octet-stream\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "Content-Length: %lu\r\n"
+                            "\r\n", (unsigned long)trace.size());
+                mg_send(c, trace.data(), trace.size());
+                g_http_bytes_sent.fetch_add(trace.size());
+                c->is_draining = 1;
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Submit a cyclostationary (SCF) analysis job for a sub-band
+        else if (mg_strcmp(hm->uri, mg_str("/scf")) == 0) {
+            ScfRequest request;
+            request.channel = static_cast<int>(mg_json_get_long(hm->body, "$.ch", 1));
+            request.offset_hz = mg_json_get_num(hm->body, "$.offset_hz", 0);
+            request.bandwidth_hz = mg_json_get_num(hm->body, "$.bw_hz", 0);
+
+            std::string error;
+            if (request.channel != 1 && request.channel != 2) {
+                mg_http_reply(c, 400, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Invalid channel (use 1 or 2)\"}");
+            } else if (!submit_scf_job(request, g_center_freq.load(), g_sample_rate.load(), error)) {
+                mg_http_reply(c, 409, "Content-Type: application/json\r\n",
+                             "{\"error\":\"%s\"}", error.c_str());
+            } else {
+                mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                             "{\"status\":\"queued\",\"ch\":%d,\"offset_hz\":%.0f,\"bw_hz\":%.0f}",
+                             request.channel, request.offset_hz, request.bandwidth_hz);
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // SCF job state and cyclic features of the last completed job
+        else if (mg_strcmp(hm->uri, mg_str("/scf_status")) == 0) {
+            defer_http_reply(c, json_job(get_scf_status_json));
+        }
+        // SCF coherence map (FREQ_BINS rows x ALPHA_BINS columns, 0-255)
+        else if (mg_strcmp(hm->uri, mg_str("/scf_map")) == 0) {
+            std::vector<uint8_t> map;
+            if (!get_scf_map(map)) {
+                mg_http_reply(c, 503, "Content-Type: text/plain\r\n", "No SCF result yet");
+            } else {
+                mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: application/octet-stream\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "X-SCF-Freq-Bins: %d\r\n"
+                            "X-SCF-Alpha-Bins: %d\r\n"
+                            "Content-Length: %lu\r\n"
+                            "\r\n", ScfConfig::FREQ_BINS, ScfConfig::ALPHA_BINS, (unsigned long)map.size());
+                mg_send(c, map.data(), map.size());
+                g_http_bytes_sent.fetch_add(map.size());
+                c->is_draining = 1;
+            }
             g_telemetry.http_requests.fetch_add(1);
         }
         // Serve IQ constellation data
+        // With end_bin, bins [start_bin, end_bin] of the latest FFT are inverse transformed on an
+        // HTTP worker (frequency-domain bandpass); without it the decimated samples are sent
         else if (mg_strcmp(hm->uri, mg_str("/iq_data")) == 0) {
-            std::lock_guard<std::mutex> lock(g_iq_data.mutex);
-
-            // Parse optional filter parameters
-            char start_bin_str[32] = "0";
-            char end_bin_str[32] = "";
+            char start_bin_str[32];
+            char end_bin_str[32];
             mg_http_get_var(&hm->query, "start_bin", start_bin_str, sizeof(start_bin_str));
             mg_http_get_var(&hm->query, "end_bin", end_bin_str, sizeof(end_bin_str));
 
             const size_t sample_bytes = IQ_SAMPLES * sizeof(int16_t);
             const size_t total_bytes = sample_bytes * 4;
 
-            // Check if filtering is requested and FFT data is available
-            const bool filter_requested = (end_bin_str[0] != '\0');
-            const bool fft_available = !g_iq_data.ch1_fft.empty() && !g_iq_data.ch2_fft.empty();
-
-            if (filter_requested && fft_available) {
-                // Perform frequency-domain bandpass filtering
-                const size_t fft_size = g_iq_data.ch1_fft.size();
-                size_t start_bin = std::atoi(start_bin_str);
-                size_t end_bin = std::atoi(end_bin_str);
-
-                // Clamp to valid range
-                start_bin = std::min(start_bin, fft_size - 1);
-                end_bin = std::min(end_bin, fft_size - 1);
-                if (start_bin > end_bin) std::swap(start_bin, end_bin);
-
-                // Create FFTW plans for IFFT (reuse for both channels)
-                static fftwf_plan ifft_plan = nullptr;
-                static fftwf_complex* ifft_in = nullptr;
-                static fftwf_complex* ifft_out = nullptr;
-                static size_t plan_size = 0;
-
-                if (!ifft_plan || plan_size != fft_size) {
-                    if (ifft_plan) {
-                        fftwf_destroy_plan(ifft_plan);
-                        fftwf_free(ifft_in);
-                        fftwf_free(ifft_out);
-                    }
-                    ifft_in = fftwf_alloc_complex(fft_size);
-                    ifft_out = fftwf_alloc_complex(fft_size);
-                    ifft_plan = fftwf_plan_dft_1d(fft_size, ifft_in, ifft_out, FFTW_BACKWARD, FFTW_ESTIMATE);
-                    plan_size = fft_size;
-                }
-
-                int16_t filtered_ch1_i[IQ_SAMPLES], filtered_ch1_q[IQ_SAMPLES];
-                int16_t filtered_ch2_i[IQ_SAMPLES], filtered_ch2_q[IQ_SAMPLES];
-
-                // Process CH1
-                for (size_t i = 0; i < fft_size; i++) {
-                    if (i >= start_bin && i <= end_bin) {
-                        ifft_in[i][0] = g_iq_data.ch1_fft[i].real();
-                        ifft_in[i][1] = g_iq_data.ch1_fft[i].imag();
-                    } else {
-                        ifft_in[i][0] = 0.0f;
-                        ifft_in[i][1] = 0.0f;
+            if (end_bin_str[0] != '\0') {
+                const size_t start_bin = std::atoi(start_bin_str);
+                const size_t end_bin = std::atoi(end_bin_str);
+                defer_http_reply(c, [start_bin, end_bin, sample_bytes](HttpJobResult& result) {
+                    result.headers = "Content-Type: application/octet-stream\r\nCache-Control: no-cache\r\n";
+                    if (!filter_iq_band(start_bin, end_bin, result.body)) {
+                        // No FFT yet: the unfiltered samples
+                        std::lock_guard<std::mutex> lock(g_iq_data.mutex);
+                        result.body.assign(reinterpret_cast<const char*>(g_iq_data.ch1_i), sample_bytes);
+                        result.body.append(reinterpret_cast<const char*>(g_iq_data.ch1_q), sample_bytes);
+                        result.body.append(reinterpret_cast<const char*>(g_iq_data.ch2_i), sample_bytes);
+                        result.body.append(reinterpret_cast<const char*>(g_iq_data.ch2_q), sample_bytes);
                     }
-                }
-                fftwf_execute(ifft_plan);
-
-                // Decimate IFFT output to 256 samples
-                const int decimation_step = fft_size / IQ_SAMPLES;
-                const float scale = 1.0f / fft_size;  // FFTW doesn't normalize IFFT
-                for (int i = 0; i < IQ_SAMPLES; i++) {
-                    const size_t idx = i * decimation_step;
-                    filtered_ch1_i[i] = static_cast<int16_t>(ifft_out[idx][0] * scale * 32767.0f);
-                    filtered_ch1_q[i] = static_cast<int16_t>(ifft_out[idx][1] * scale * 32767.0f);
-                }
-
-                // Process CH2
-                for (size_t i = 0; i < fft_size; i++) {
-                    if (i >= start_bin && i <= end_bin) {
-                        ifft_in[i][0] = g_iq_data.ch2_fft[i].real();
-                        ifft_in[i][1] = g_iq_data.ch2_fft[i].imag();
-                    } else {
-                        ifft_in[i][0] = 0.0f;
-                        ifft_in[i][1] = 0.0f;
-                    }
-                }
-                fftwf_execute(ifft_plan);
-
-                // Decimate IFFT output to 256 samples
-                for (int i = 0; i < IQ_SAMPLES; i++) {
-                    const size_t idx = i * decimation_step;
-                    filtered_ch2_i[i] = static_cast<int16_t>(ifft_out[idx][0] * scale * 32767.0f);
-                    filtered_ch2_q[i] = static_cast<int16_t>(ifft_out[idx][1] * scale * 32767.0f);
-                }
-
-                // Send filtered data
-                mg_printf(c, "HTTP/1.1 200 OK\r\n"
-                            "Content-Type: application/octet-stream\r\n"
-                            "Cache-Control: no-cache\r\n"
-                            "Content-Length: %zu\r\n"
-                            "\r\n", total_bytes);
-
-                mg_send(c, filtered_ch1_i, sample_bytes);
-                mg_send(c, filtered_ch1_q, sample_bytes);
-                mg_send(c, filtered_ch2_i, sample_bytes);
-                mg_send(c, filtered_ch2_q, sample_bytes);
-                g_http_bytes_sent.fetch_add(total_bytes);
-                c->is_draining = 1;
+                });
             } else {
                 // Send unfiltered data
+                std::lock_guard<std::mutex> lock(g_iq_data.mutex);
                 mg_printf(c, "HTTP/1.1 200 OK\r\n"
                             "Content-Type: application/octet-stream\r\n"
                             "Cache-Control: no-cache\r\n"
@@ -786,15 +1296,20 @@ void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
             // Parse optional bin range parameters for DF filtering
             char start_bin_str[32] = "0";
             char end_bin_str[32] = "0";
-            mg_http_get_var(&hm->query, "start_bin", start_bin_str, sizeof(start_bin_str));
-            mg_http_get_var(&hm->query, "end_bin", end_bin_str, sizeof(end_bin_str));
+            const bool has_range =
+                mg_http_get_var(&hm->query, "start_bin", start_bin_str, sizeof(start_bin_str)) > 0 &&
+                mg_http_get_var(&hm->query, "end_bin", end_bin_str, sizeof(end_bin_str)) > 0;
 
             const uint32_t start_bin = static_cast<uint32_t>(atoi(start_bin_str));
             const uint32_t end_bin = static_cast<uint32_t>(atoi(end_bin_str));
 
-            // Update global DF bin range (0, 0 means use entire spectrum)
-            g_df_start_bin.store(start_bin);
-            g_df_end_bin.store(end_bin);
+            // Update global DF bin range (0, 0 means use entire spectrum) only when the
+            // client sends one, so plain polls do not reset another client's selection
+            // (independent selections belong in /df_band_add)
+            if (has_range) {
+                g_df_start_bin.store(start_bin);
+                g_df_end_bin.store(end_bin);
+            }
 
             std::lock_guard<std::mutex> lock(g_doa_result.mutex);
 
@@ -824,6 +1339,172 @@ void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
                          "%s", json);
             g_http_bytes_sent.fetch_add(strlen(json));
         }
+        // Bearing table: every tracked emitter and user DF band
+        else if (mg_strcmp(hm->uri, mg_str("/bearings")) == 0) {
+            defer_http_reply(c, json_job(get_bearing_table_json));
+        }
+        // Bearing-versus-frequency waterfall rows (polling keeps the mode running)
+        else if (mg_strcmp(hm->uri, mg_str("/df_waterfall")) == 0) {
+            char since_str[32] = "0";
+            mg_http_get_var(&hm->query, "since", since_str, sizeof(since_str));
+
+            std::vector<uint8_t> encoded;
+            size_t rows = 0;
+            uint64_t sequence = 0;
+            get_df_waterfall_rows(strtoull(since_str, nullptr, 10), encoded, rows, sequence);
+
+            // Delta/RLE-coded rows, oldest first (see df_waterfall.h for the format)
+            mg_printf(c, "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: application/octet-stream\r\n"
+                        "Cache-Control: no-cache\r\n"
+                        "X-DFW-Columns: %lu\r\n"
+                        "X-DFW-Group: %lu\r\n"
+                        "X-DFW-Rows: %lu\r\n"
+                        "X-DFW-Sequence: %llu\r\n"
+                        "Content-Length: %lu\r\n"
+                        "\r\n",
+                        (unsigned long)get_df_waterfall_columns(), (unsigned long)DFWaterfallConfig::GROUP_BINS,
+                        (unsigned long)rows, (unsigned long long)sequence, (unsigned long)encoded.size());
+            mg_send(c, encoded.data(), encoded.size());
+            g_http_bytes_sent.fetch_add(encoded.size());
+            c->is_draining = 1;
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Add a user DF band (tracked independently of /doa_result)
+        else if (mg_strcmp(hm->uri, mg_str("/df_band_add")) == 0) {
+            const long start_bin = mg_json_get_long(hm->body, "$.start_bin", -1);
+            const long end_bin = mg_json_get_long(hm->body, "$.end_bin", -1);
+            const long frames = mg_json_get_long(hm->body, "$.frames",
+                                                 BearingTableConfig::DEFAULT_INTEGRATION_FRAMES);
+
+            if (start_bin < 0 || end_bin < start_bin || end_bin >= static_cast<long>(FFT_SIZE)) {
+                mg_http_reply(c, 400, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Invalid bin range\"}");
+            } else {
+                const uint32_t id = add_df_band(static_cast<uint32_t>(start_bin), static_cast<uint32_t>(end_bin),
+                                                static_cast<uint32_t>(std::max(frames, 1L)));
+                if (id == 0) {
+                    mg_http_reply(c, 409, "Content-Type: application/json\r\n",
+                                 "{\"error\":\"DF band table full\"}");
+                } else {
+                    mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                                 "{\"status\":\"ok\",\"id\":%u}", id);
+                }
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Remove a user DF band
+        else if (mg_strcmp(hm->uri, mg_str("/df_band_remove")) == 0) {
+            const long id = mg_json_get_long(hm->body, "$.id", 0);
+            if (id <= 0 || !remove_df_band(static_cast<uint32_t>(id))) {
+                mg_http_reply(c, 404, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Unknown DF band\"}");
+            } else {
+                mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                             "{\"status\":\"ok\"}");
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // MVDR / MUSIC pseudo-spectrum and peaks
+        else if (mg_strcmp(hm->uri, mg_str("/superres")) == 0) {
+            defer_http_reply(c, json_job(get_superres_json));
+        }
+        // Configure the super-resolution DF engine (omitted fields keep their value)
+        else if (mg_strcmp(hm->uri, mg_str("/superres_config")) == 0) {
+            SuperResSettings settings = get_superres_settings();
+            mg_json_get_bool(hm->body, "$.enabled", &settings.enabled);
+            const long start_bin = mg_json_get_long(hm->body, "$.start_bin", settings.start_bin);
+            const long end_bin = mg_json_get_long(hm->body, "$.end_bin", settings.end_bin);
+            const long sources = mg_json_get_long(hm->body, "$.sources", settings.sources);
+            const long frames = mg_json_get_long(hm->body, "$.frames", settings.integration_frames);
+
+            bool valid = start_bin >= 0 && end_bin >= start_bin && end_bin < static_cast<long>(FFT_SIZE) &&
+                         sources >= 0 && frames > 0;
+            char *method_str = mg_json_get_str(hm->body, "$.method");
+            if (method_str) {
+                if (strcmp(method_str, "mvdr") == 0) {
+                    settings.method = SuperResMethod::MVDR;
+                } else if (strcmp(method_str, "music") == 0) {
+                    settings.method = SuperResMethod::MUSIC;
+                } else {
+                    valid = false;
+                }
+                free(method_str);
+            }
+
+            if (!valid) {
+                mg_http_reply(c, 400, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Invalid settings (bins, sources, frames or method 'mvdr'/'music')\"}");
+            } else {
+                settings.start_bin = static_cast<uint32_t>(start_bin);
+                settings.end_bin = static_cast<uint32_t>(end_bin);
+                settings.sources = static_cast<uint32_t>(sources);
+                settings.integration_frames = static_cast<uint32_t>(frames);
+                set_superres_settings(settings);
+                mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                             "{\"status\":\"ok\",\"enabled\":%s,\"method\":\"%s\"}",
+                             settings.enabled ? "true" : "false",
+                             settings.method == SuperResMethod::MUSIC ? "music" : "mvdr");
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // Bearing-only emitter fixes with error ellipses
+        else if (mg_strcmp(hm->uri, mg_str("/geolocation")) == 0) {
+            defer_http_reply(c, json_job(get_geolocation_json));
+        }
+        // Configure the platform heading source (omitted fields keep their value), reset fixes
+        else if (mg_strcmp(hm->uri, mg_str("/geoloc_config")) == 0) {
+            GeolocSettings settings = get_geolocation_settings();
+            mg_json_get_bool(hm->body, "$.course", &settings.use_gps_course);
+            double offset = settings.mount_offset_deg;
+            double heading = settings.fixed_heading_deg;
+            mg_json_get_num(hm->body, "$.offset", &offset);
+            mg_json_get_num(hm->body, "$.heading", &heading);
+            settings.mount_offset_deg = static_cast<float>(offset);
+            settings.fixed_heading_deg = static_cast<float>(heading);
+            bool reset = false;
+            mg_json_get_bool(hm->body, "$.reset", &reset);
+
+            if (!set_geolocation_settings(settings)) {
+                mg_http_reply(c, 400, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Invalid offset or heading\"}");
+            } else {
+                if (reset) reset_geolocation();
+                mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                             "{\"status\":\"ok\",\"course\":%s}",
+                             settings.use_gps_course ? "true" : "false");
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
+        // GCC-PHAT inter-channel delay, bearing and skew history
+        else if (mg_strcmp(hm->uri, mg_str("/gcc_phat")) == 0) {
+            defer_http_reply(c, json_job(get_gcc_phat_json));
+        }
+        // Beamformer settings and beam noise floors
+        else if (mg_strcmp(hm->uri, mg_str("/beamformer")) == 0) {
+            defer_http_reply(c, json_job(get_beamformer_json));
+        }
+        // Configure the beamformer (omitted fields keep their value)
+        else if (mg_strcmp(hm->uri, mg_str("/beamformer_config")) == 0) {
+            BeamformerSettings settings = get_beamformer_settings();
+            mg_json_get_bool(hm->body, "$.enabled", &settings.enabled);
+            mg_json_get_bool(hm->body, "$.cfar", &settings.cfar_input);
+            mg_json_get_bool(hm->body, "$.display", &settings.display_input);
+            double azimuth = settings.steer_azimuth_deg;
+            mg_json_get_num(hm->body, "$.azimuth", &azimuth);
+            settings.steer_azimuth_deg = static_cast<float>(azimuth);
+
+            if (!set_beamformer_settings(settings)) {
+                mg_http_reply(c, 400, "Content-Type: application/json\r\n",
+                             "{\"error\":\"Steering azimuth must be within +/-%.0f degrees\"}",
+                             BeamformerConfig::MAX_STEER_AZIMUTH_DEG);
+            } else {
+                mg_http_reply(c, 200, "Content-Type: application/json\r\n",
+                             "{\"status\":\"ok\",\"enabled\":%s,\"azimuth\":%.1f}",
+                             settings.enabled ? "true" : "false", settings.steer_azimuth_deg);
+            }
+            g_telemetry.http_requests.fetch_add(1);
+        }
         // Serve link quality metrics as JSON
         else if (mg_strcmp(hm->uri, mg_str("/link_quality")) == 0) {
             std::lock_guard<std::mutex> lock(g_link_quality.mutex);
@@ -1110,155 +1791,8 @@ void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
                              "{\"status\":\"ok\",\"sent\":%d}", (int)sent);
             }
         }
-        // Serve JavaScript modules from web_assets/js/
-        else if (mg_strcmp(hm->uri, mg_str("/js/rf_measurements.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/rf_measurements.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/marker_system.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/marker_system.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/vsa_analysis.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/vsa_analysis.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/statistics.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/statistics.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/utils.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/utils.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/settings.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/settings.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/signal_filters.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/signal_filters.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/marker_system.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/marker_system.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/rf_measurements.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/rf_measurements.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/vsa_analysis.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/vsa_analysis.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/signal_classifier.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/signal_classifier.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        // Display modules
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/waterfall.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/waterfall.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/spectrum.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/spectrum.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/iq_constellation_enhanced.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/iq_constellation_enhanced.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/cross_correlation_enhanced.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/cross_correlation_enhanced.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/eye_diagram.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/eye_diagram.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        else if (mg_strcmp(hm->uri, mg_str("/js/displays/waveform_display.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/displays/waveform_display.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        // Utility modules
-        else if (mg_strcmp(hm->uri, mg_str("/js/utils/colormap.js")) == 0) {
-            std::string js_content = read_js_file("server/web_assets/js/utils/colormap.js");
-            mg_http_reply(c, 200,
-                "Content-Type: text/javascript; charset=utf-8\r\n"
-                "Cache-Control: no-cache\r\n",
-                "%s", js_content.c_str());
-        }
-        // Generic static file serving for all other requests
         else {
-            // Extract URI path (remove leading slash)
-            std::string uri_path(hm->uri.buf, hm->uri.len);
-            if (uri_path[0] == '/') {
-                uri_path = uri_path.substr(1);
-            }
-
-            // Try to serve the file
-            std::string file_content = read_static_file(uri_path.c_str());
-            if (!file_content.empty()) {
-                const char* mime_type = get_mime_type(uri_path.c_str());
-                char content_type_header[256];
-                snprintf(content_type_header, sizeof(content_type_header),
-                        "Content-Type: %s\r\n"
-                        "Cache-Control: no-cache\r\n", mime_type);
-                mg_http_reply(c, 200, content_type_header, "%s", file_content.c_str());
-            } else {
-                mg_http_reply(c, 404, "Content-Type: text/plain\r\n", "404 Not Found");
-            }
+            mg_http_reply(c, 404, "Content-Type: text/plain\r\n", "404 Not Found");
         }
     }
 #else
@@ -1270,6 +1804,9 @@ void web_server_handler(struct mg_connection *c, int ev, void *ev_data) {
 
 void start_web_server() {
 #ifdef USE_MONGOOSE
+    // Web assets are served from memory; read and compress them once, before any request
+    load_static_assets();
+
     g_web_running = true;
 
     // Start web server thread
@@ -1279,21 +1816,49 @@ void start_web_server() {
 
         mg_mgr_init(&g_mgr);
 
+        // Lets the processing thread interrupt mg_mgr_poll when a waterfall row is ready, the
+        // HTTP workers when a deferred reply is, and the MJPEG encoder when frames are
+        if (!mg_wakeup_init(&g_mgr)) {
+            std::cerr << "Web server: mg_wakeup unavailable, WebSocket rows and deferred replies wait for the poll tick" << std::endl;
+        }
+        start_http_workers(http_job_ready);
+        start_mjpeg_encoder(mjpeg_frame_ready);
+
         char url[64];
         snprintf(url, sizeof(url), "http://0.0.0.0:%d", WEB_SERVER_PORT);
 
-        if (mg_http_listen(&g_mgr, url, web_server_handler, nullptr) == nullptr) {
+        struct mg_connection *listener = mg_http_listen(&g_mgr, url, web_server_handler, nullptr);
+        if (listener == nullptr) {
             std::cerr << "Web server failed to start on port " << WEB_SERVER_PORT << std::endl;
+            stop_mjpeg_encoder();
+            stop_http_workers();
             g_web_running = false;
             return;
         }
+        g_wakeup_conn_id = listener->id;
 
         std::cout << "Web server ready: http://localhost:" << WEB_SERVER_PORT << std::endl;
 
         while (g_web_running) {
-            mg_mgr_poll(&g_mgr, 100);  // Poll every 100ms
+            // Waterfall rows wake the loop through mg_wakeup; the tick covers everything else
+            mg_mgr_poll(&g_mgr, 100);
+            if (g_ws_wakeup_pending && g_ws_clients > 0) {
+                push_waterfall_rows(&g_mgr);  // Fallback when the wakeup could not be queued
+            }
+            if (g_mjpeg_clients > 0) {
+                push_mjpeg_frames(&g_mgr);    // Frames whose wakeup was lost (cached parts only)
+            }
+            if (ready_http_results() > 0) {
+                for (struct mg_connection *c = g_mgr.conns; c != nullptr; c = c->next) {
+                    send_http_result(c);  // Replies whose wakeup was lost
+                }
+            }
         }
 
+        stop_mjpeg_encoder();
+        stop_http_workers();
+
+        g_wakeup_conn_id = 0;
         mg_mgr_free(&g_mgr);
     });
 #else